@@ -0,0 +1,241 @@
+#include "AffineTransform.hpp"
+
+namespace Xna {
+
+	AffineTransform::AffineTransform() {}
+
+	AffineTransform::AffineTransform(Matrix const& m) :
+		M11(m.M11), M12(m.M12), M13(m.M13),
+		M21(m.M21), M22(m.M22), M23(m.M23),
+		M31(m.M31), M32(m.M32), M33(m.M33),
+		M41(m.M41), M42(m.M42), M43(m.M43) {}
+
+	AffineTransform operator* (AffineTransform const& t1, AffineTransform const& t2) {
+		return AffineTransform::Multiply(t1, t2);
+	}
+
+	bool operator== (AffineTransform const& t1, AffineTransform const& t2) {
+		return t1.M11 == t2.M11 && t1.M12 == t2.M12 && t1.M13 == t2.M13
+			&& t1.M21 == t2.M21 && t1.M22 == t2.M22 && t1.M23 == t2.M23
+			&& t1.M31 == t2.M31 && t1.M32 == t2.M32 && t1.M33 == t2.M33
+			&& t1.M41 == t2.M41 && t1.M42 == t2.M42 && t1.M43 == t2.M43;
+	}
+
+	bool operator!= (AffineTransform const& t1, AffineTransform const& t2) {
+		return !(t1 == t2);
+	}
+
+	AffineTransform AffineTransform::CreateTranslation(Vector3 const& position) {
+		AffineTransform result;
+		result.M41 = position.X;
+		result.M42 = position.Y;
+		result.M43 = position.Z;
+
+		return result;
+	}
+
+	AffineTransform AffineTransform::CreateScale(Vector3 const& scale) {
+		AffineTransform result;
+		result.M11 = scale.X;
+		result.M22 = scale.Y;
+		result.M33 = scale.Z;
+
+		return result;
+	}
+
+	AffineTransform AffineTransform::CreateScale(double scale) {
+		return CreateScale(Vector3(scale, scale, scale));
+	}
+
+	AffineTransform AffineTransform::CreateFromQuaternion(Quaternion const& rotation) {
+		return CreateRigid(rotation, Vector3(0, 0, 0));
+	}
+
+	AffineTransform AffineTransform::CreateRigid(Quaternion const& rotation, Vector3 const& translation) {
+		double xx = rotation.X * rotation.X;
+		double yy = rotation.Y * rotation.Y;
+		double zz = rotation.Z * rotation.Z;
+		double xy = rotation.X * rotation.Y;
+		double zw = rotation.Z * rotation.W;
+		double zx = rotation.Z * rotation.X;
+		double yw = rotation.Y * rotation.W;
+		double yz = rotation.Y * rotation.Z;
+		double xw = rotation.X * rotation.W;
+
+		AffineTransform result;
+		result.M11 = 1.0 - 2.0 * (yy + zz);
+		result.M12 = 2.0 * (xy + zw);
+		result.M13 = 2.0 * (zx - yw);
+		result.M21 = 2.0 * (xy - zw);
+		result.M22 = 1.0 - 2.0 * (zz + xx);
+		result.M23 = 2.0 * (yz + xw);
+		result.M31 = 2.0 * (zx + yw);
+		result.M32 = 2.0 * (yz - xw);
+		result.M33 = 1.0 - 2.0 * (yy + xx);
+		result.M41 = translation.X;
+		result.M42 = translation.Y;
+		result.M43 = translation.Z;
+
+		return result;
+	}
+
+	AffineTransform AffineTransform::Multiply(AffineTransform const& t1, AffineTransform const& t2) {
+		AffineTransform result;
+		result.M11 = t1.M11 * t2.M11 + t1.M12 * t2.M21 + t1.M13 * t2.M31;
+		result.M12 = t1.M11 * t2.M12 + t1.M12 * t2.M22 + t1.M13 * t2.M32;
+		result.M13 = t1.M11 * t2.M13 + t1.M12 * t2.M23 + t1.M13 * t2.M33;
+		result.M21 = t1.M21 * t2.M11 + t1.M22 * t2.M21 + t1.M23 * t2.M31;
+		result.M22 = t1.M21 * t2.M12 + t1.M22 * t2.M22 + t1.M23 * t2.M32;
+		result.M23 = t1.M21 * t2.M13 + t1.M22 * t2.M23 + t1.M23 * t2.M33;
+		result.M31 = t1.M31 * t2.M11 + t1.M32 * t2.M21 + t1.M33 * t2.M31;
+		result.M32 = t1.M31 * t2.M12 + t1.M32 * t2.M22 + t1.M33 * t2.M32;
+		result.M33 = t1.M31 * t2.M13 + t1.M32 * t2.M23 + t1.M33 * t2.M33;
+		result.M41 = t1.M41 * t2.M11 + t1.M42 * t2.M21 + t1.M43 * t2.M31 + t2.M41;
+		result.M42 = t1.M41 * t2.M12 + t1.M42 * t2.M22 + t1.M43 * t2.M32 + t2.M42;
+		result.M43 = t1.M41 * t2.M13 + t1.M42 * t2.M23 + t1.M43 * t2.M33 + t2.M43;
+
+		return result;
+	}
+
+	bool AffineTransform::Invert(AffineTransform const& t, AffineTransform& result) {
+		//Cofactors of the first column, reused by the determinant.
+		double c11 = t.M22 * t.M33 - t.M23 * t.M32;
+		double c21 = t.M23 * t.M31 - t.M21 * t.M33;
+		double c31 = t.M21 * t.M32 - t.M22 * t.M31;
+		double det = t.M11 * c11 + t.M12 * c21 + t.M13 * c31;
+
+		if (det == 0) {
+			return false;
+		}
+
+		double inverse = 1.0 / det;
+		AffineTransform r;
+		r.M11 = c11 * inverse;
+		r.M12 = (t.M13 * t.M32 - t.M12 * t.M33) * inverse;
+		r.M13 = (t.M12 * t.M23 - t.M13 * t.M22) * inverse;
+		r.M21 = c21 * inverse;
+		r.M22 = (t.M11 * t.M33 - t.M13 * t.M31) * inverse;
+		r.M23 = (t.M13 * t.M21 - t.M11 * t.M23) * inverse;
+		r.M31 = c31 * inverse;
+		r.M32 = (t.M12 * t.M31 - t.M11 * t.M32) * inverse;
+		r.M33 = (t.M11 * t.M22 - t.M12 * t.M21) * inverse;
+		r.M41 = -(t.M41 * r.M11 + t.M42 * r.M21 + t.M43 * r.M31);
+		r.M42 = -(t.M41 * r.M12 + t.M42 * r.M22 + t.M43 * r.M32);
+		r.M43 = -(t.M41 * r.M13 + t.M42 * r.M23 + t.M43 * r.M33);
+
+		result = r;
+		return true;
+	}
+
+	AffineTransform AffineTransform::InvertRigid(AffineTransform const& t) {
+		AffineTransform result;
+		result.M11 = t.M11;
+		result.M12 = t.M21;
+		result.M13 = t.M31;
+		result.M21 = t.M12;
+		result.M22 = t.M22;
+		result.M23 = t.M32;
+		result.M31 = t.M13;
+		result.M32 = t.M23;
+		result.M33 = t.M33;
+		result.M41 = -(t.M41 * t.M11 + t.M42 * t.M12 + t.M43 * t.M13);
+		result.M42 = -(t.M41 * t.M21 + t.M42 * t.M22 + t.M43 * t.M23);
+		result.M43 = -(t.M41 * t.M31 + t.M42 * t.M32 + t.M43 * t.M33);
+
+		return result;
+	}
+
+	//The batch versions set the members, the Vector3 constructors not being inlined across files.
+	bool AffineTransform::Transform(std::vector<Vector3> const& source, size_t sourceIndex,
+		AffineTransform const& transform, std::vector<Vector3>& destination, size_t destIndex, size_t length) {
+
+		if (source.size() < sourceIndex + length
+			|| destination.size() < destIndex + length) {
+			return false;
+		}
+
+		//A local copy, which the stores cannot alias, stays in registers.
+		AffineTransform const t = transform;
+
+		for (size_t i = 0; i < length; i++) {
+			Vector3 position = source[sourceIndex + i];
+			double x = position.X * t.M11 + position.Y * t.M21 + position.Z * t.M31 + t.M41;
+			double y = position.X * t.M12 + position.Y * t.M22 + position.Z * t.M32 + t.M42;
+			double z = position.X * t.M13 + position.Y * t.M23 + position.Z * t.M33 + t.M43;
+
+			destination[destIndex + i].X = x;
+			destination[destIndex + i].Y = y;
+			destination[destIndex + i].Z = z;
+		}
+
+		return true;
+	}
+
+	bool AffineTransform::Transform(std::vector<Vector3> const& source, AffineTransform const& t, std::vector<Vector3>& destination) {
+		return Transform(source, 0, t, destination, 0, source.size());
+	}
+
+	bool AffineTransform::TransformNormal(std::vector<Vector3> const& source, size_t sourceIndex,
+		AffineTransform const& transform, std::vector<Vector3>& destination, size_t destIndex, size_t length) {
+
+		if (source.size() < sourceIndex + length
+			|| destination.size() < destIndex + length) {
+			return false;
+		}
+
+		//A local copy, which the stores cannot alias, stays in registers.
+		AffineTransform const t = transform;
+
+		for (size_t i = 0; i < length; i++) {
+			Vector3 normal = source[sourceIndex + i];
+			double x = normal.X * t.M11 + normal.Y * t.M21 + normal.Z * t.M31;
+			double y = normal.X * t.M12 + normal.Y * t.M22 + normal.Z * t.M32;
+			double z = normal.X * t.M13 + normal.Y * t.M23 + normal.Z * t.M33;
+
+			destination[destIndex + i].X = x;
+			destination[destIndex + i].Y = y;
+			destination[destIndex + i].Z = z;
+		}
+
+		return true;
+	}
+
+	bool AffineTransform::TransformNormal(std::vector<Vector3> const& source, AffineTransform const& t, std::vector<Vector3>& destination) {
+		return TransformNormal(source, 0, t, destination, 0, source.size());
+	}
+
+	Vector3 AffineTransform::Transform(Vector3 const& position) const {
+		return Vector3(
+			position.X * M11 + position.Y * M21 + position.Z * M31 + M41,
+			position.X * M12 + position.Y * M22 + position.Z * M32 + M42,
+			position.X * M13 + position.Y * M23 + position.Z * M33 + M43);
+	}
+
+	Vector3 AffineTransform::TransformNormal(Vector3 const& normal) const {
+		return Vector3(
+			normal.X * M11 + normal.Y * M21 + normal.Z * M31,
+			normal.X * M12 + normal.Y * M22 + normal.Z * M32,
+			normal.X * M13 + normal.Y * M23 + normal.Z * M33);
+	}
+
+	Vector3 AffineTransform::Translation() const {
+		return Vector3(M41, M42, M43);
+	}
+
+	double AffineTransform::Determinant() const {
+		return M11 * (M22 * M33 - M23 * M32)
+			+ M12 * (M23 * M31 - M21 * M33)
+			+ M13 * (M21 * M32 - M22 * M31);
+	}
+
+	Matrix AffineTransform::ToMatrix() const {
+		Matrix result = {
+			M11, M12, M13, 0,
+			M21, M22, M23, 0,
+			M31, M32, M33, 0,
+			M41, M42, M43, 1
+		};
+
+		return result;
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef _AFFINETRANSFORM_H_
+#define _AFFINETRANSFORM_H_
+
+#include <cstddef>
+#include <vector>
+#include "Matrix.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	/*
+	 Affine transform stored as the first three columns of a Matrix: the linear part in M11 to M33 and the
+	 translation in M41 to M43, for row vectors as in Matrix (position * transform). The fourth column of an
+	 affine Matrix is always (0, 0, 0, 1), so this takes 12 doubles instead of 16 and composing two of them
+	 costs 27 multiplications instead of 64.
+	*/
+	class AffineTransform {
+	public:
+		double M11{ 1 };
+		double M12{ 0 };
+		double M13{ 0 };
+
+		double M21{ 0 };
+		double M22{ 1 };
+		double M23{ 0 };
+
+		double M31{ 0 };
+		double M32{ 0 };
+		double M33{ 1 };
+
+		double M41{ 0 };
+		double M42{ 0 };
+		double M43{ 0 };
+
+		//Identity.
+		AffineTransform();
+		//Drops the fourth column of m, which must be affine.
+		explicit AffineTransform(Matrix const& m);
+
+		friend AffineTransform operator* (AffineTransform const&, AffineTransform const&);
+		friend bool operator== (AffineTransform const&, AffineTransform const&);
+		friend bool operator!= (AffineTransform const&, AffineTransform const&);
+
+		static AffineTransform CreateTranslation(Vector3 const& position);
+		static AffineTransform CreateScale(Vector3 const& scale);
+		static AffineTransform CreateScale(double scale);
+		static AffineTransform CreateFromQuaternion(Quaternion const& rotation);
+		//Rotation followed by translation.
+		static AffineTransform CreateRigid(Quaternion const& rotation, Vector3 const& translation);
+
+		//t1 followed by t2, as Matrix::Multiply.
+		static AffineTransform Multiply(AffineTransform const& t1, AffineTransform const& t2);
+		//Returns false, leaving result untouched, if the linear part is singular.
+		static bool Invert(AffineTransform const& t, AffineTransform& result);
+		//Inverse of a rotation followed by a translation, from the transpose of the rotation.
+		static AffineTransform InvertRigid(AffineTransform const& t);
+
+		/*
+		 Vector3::Transform and TransformNormal over source[sourceIndex] to source[sourceIndex + length - 1].
+		 Returns false if a range is out of bounds.
+		*/
+		static bool Transform(std::vector<Vector3> const& source, size_t sourceIndex,
+			AffineTransform const& t, std::vector<Vector3>& destination, size_t destIndex, size_t length);
+		static bool Transform(std::vector<Vector3> const& source, AffineTransform const& t, std::vector<Vector3>& destination);
+		static bool TransformNormal(std::vector<Vector3> const& source, size_t sourceIndex,
+			AffineTransform const& t, std::vector<Vector3>& destination, size_t destIndex, size_t length);
+		static bool TransformNormal(std::vector<Vector3> const& source, AffineTransform const& t, std::vector<Vector3>& destination);
+
+		Vector3 Transform(Vector3 const& position) const;
+		//Applies the linear part only. Normals of a non rigid transform need the inverse transpose instead.
+		Vector3 TransformNormal(Vector3 const& normal) const;
+
+		Vector3 Translation() const;
+		double Determinant() const;
+		Matrix ToMatrix() const;
+	};
+}
+
+#endif
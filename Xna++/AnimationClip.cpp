@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cmath>
+#include "AnimationClip.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+
+namespace Xna {
+
+	//Components and first pose column of each track.
+	static constexpr size_t TrackWidth[3] = { 3, 4, 3 };
+	static constexpr size_t TrackColumn[3] = { AnimationPose::TranslationColumn, AnimationPose::RotationColumn, AnimationPose::ScaleColumn };
+	static constexpr double TrackIdentity[3][4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 1 }, { 1, 1, 1, 0 } };
+
+	/*
+	 Keys after the cursor keys, per pose column, and the amounts toward them, per track, gathered for the
+	 interpolation pass. Shared by the samples of a thread, the batched Sample running on the persistent
+	 threads of Parallel::For, so that instances only keep their key indices.
+	*/
+	struct GatherScratch {
+		std::vector<double> Next[AnimationPose::ColumnCount];
+		std::vector<double> Amounts[3];
+	};
+
+	static thread_local GatherScratch scratch;
+
+	//Interpolates the lanes from i of the pose, holding the earlier keys, toward the later keys.
+	template <typename T>
+	static void InterpolateLanes(std::vector<double>* pose, std::vector<double> const* next, std::vector<double> const* amounts, size_t i) {
+		for (size_t track = 0; track < 3; track += 2) {
+			T amount = T::Load(amounts[track].data() + i);
+
+			for (size_t k = TrackColumn[track]; k < TrackColumn[track] + 3; k++) {
+				T a = T::Load(pose[k].data() + i);
+				T b = T::Load(next[k].data() + i);
+				(a + (b - a) * amount).Store(pose[k].data() + i);
+			}
+		}
+
+		T from[4];
+		T to[4];
+
+		for (size_t k = 0; k < 4; k++) {
+			from[k] = T::Load(pose[AnimationPose::RotationColumn + k].data() + i);
+			to[k] = T::Load(next[AnimationPose::RotationColumn + k].data() + i);
+		}
+
+		Simd::Slerp(from, to, T::Load(amounts[1].data() + i), from);
+
+		for (size_t k = 0; k < 4; k++) {
+			from[k].Store(pose[AnimationPose::RotationColumn + k].data() + i);
+		}
+	}
+
+	void AnimationCursor::Reset() {
+		clip = nullptr;
+	}
+
+	AnimationClip::AnimationClip(size_t boneCount, double duration) :
+		boneCount(boneCount), duration(duration > 0 ? duration : 0) {
+
+		for (size_t t = 0; t < 3; t++) {
+			tracks[t].First.resize(boneCount + 1);
+		}
+	}
+
+	size_t AnimationClip::BoneCount() const {
+		return boneCount;
+	}
+
+	double AnimationClip::Duration() const {
+		return duration;
+	}
+
+	size_t AnimationClip::KeyCount(AnimationTrack track, size_t bone) const {
+		Track const& keys = tracks[static_cast<size_t>(track)];
+		return bone < boneCount ? keys.First[bone + 1] - keys.First[bone] : 0;
+	}
+
+	bool AnimationClip::AddTranslation(size_t bone, double time, Vector3 const& translation) {
+		double values[3] = { translation.X, translation.Y, translation.Z };
+		return AddKey(0, bone, time, values);
+	}
+
+	bool AnimationClip::AddRotation(size_t bone, double time, Quaternion const& rotation) {
+		Quaternion unit = Quaternion::Normalize(rotation);
+		double values[4] = { unit.X, unit.Y, unit.Z, unit.W };
+		return AddKey(1, bone, time, values);
+	}
+
+	bool AnimationClip::AddScale(size_t bone, double time, Vector3 const& scale) {
+		double values[3] = { scale.X, scale.Y, scale.Z };
+		return AddKey(2, bone, time, values);
+	}
+
+	double AnimationClip::ClipTime(double time, bool loop) const {
+		if (duration <= 0) {
+			return 0;
+		}
+
+		if (loop) {
+			double wrapped = std::fmod(time, duration);
+			return wrapped < 0 ? wrapped + duration : wrapped;
+		}
+
+		return time < 0 ? 0 : (time > duration ? duration : time);
+	}
+
+	void AnimationClip::Sample(double time, AnimationCursor& cursor, AnimationPose& pose) const {
+		pose.Resize(boneCount);
+
+		if (cursor.clip != this) {
+			for (size_t t = 0; t < 3; t++) {
+				cursor.keys[t].assign(boneCount, 0);
+			}
+		}
+
+		if (scratch.Amounts[0].size() < boneCount) {
+			for (size_t t = 0; t < 3; t++) {
+				scratch.Amounts[t].resize(boneCount);
+			}
+
+			for (size_t k = 0; k < AnimationPose::ColumnCount; k++) {
+				scratch.Next[k].resize(boneCount);
+			}
+		}
+
+		bool forward = cursor.clip == this && time >= cursor.time;
+
+		for (size_t t = 0; t < 3; t++) {
+			Gather(t, time, forward, cursor, pose, scratch.Next, scratch.Amounts[t].data());
+		}
+
+		cursor.clip = this;
+		cursor.time = time;
+
+		size_t i = 0;
+
+#ifdef XNA_SIMD_SSE2
+		for (; i + 4 <= boneCount; i += 4) {
+			InterpolateLanes<Simd::Twice<Simd::Pair>>(pose.Columns, scratch.Next, scratch.Amounts, i);
+		}
+
+		for (; i + 2 <= boneCount; i += 2) {
+			InterpolateLanes<Simd::Pair>(pose.Columns, scratch.Next, scratch.Amounts, i);
+		}
+#endif
+		for (; i < boneCount; i++) {
+			InterpolateLanes<Simd::Scalar>(pose.Columns, scratch.Next, scratch.Amounts, i);
+		}
+	}
+
+	void AnimationClip::Sample(std::vector<AnimationInstance>& instances) {
+		Parallel::For(0, instances.size(), 1, [&instances](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) {
+				AnimationInstance& instance = instances[i];
+
+				if (instance.Clip != nullptr) {
+					instance.Clip->Sample(instance.Clip->ClipTime(instance.Time, instance.Loop), instance.Cursor, instance.Pose);
+				}
+			}
+		});
+	}
+
+	bool AnimationClip::AddKey(size_t track, size_t bone, double time, double const* values) {
+		if (bone >= boneCount) {
+			return false;
+		}
+
+		Track& keys = tracks[track];
+		auto begin = keys.Times.begin() + keys.First[bone];
+		auto end = keys.Times.begin() + keys.First[bone + 1];
+		auto position = std::lower_bound(begin, end, time);
+		size_t index = static_cast<size_t>(position - keys.Times.begin());
+
+		if (position != end && *position == time) {
+			for (size_t k = 0; k < TrackWidth[track]; k++) {
+				keys.Values[k][index] = values[k];
+			}
+
+			return true;
+		}
+
+		keys.Times.insert(position, time);
+
+		for (size_t k = 0; k < TrackWidth[track]; k++) {
+			keys.Values[k].insert(keys.Values[k].begin() + index, values[k]);
+		}
+
+		for (size_t b = bone + 1; b <= boneCount; b++) {
+			keys.First[b]++;
+		}
+
+		return true;
+	}
+
+	/*
+	 Writes, for every bone, the key at or before time into the pose, the key after it into next, and the
+	 amount between them. Playing forward, the cursor key only moves ahead.
+	*/
+	void AnimationClip::Gather(size_t track, double time, bool forward, AnimationCursor& cursor, AnimationPose& pose,
+		std::vector<double>* next, double* amounts) const {
+
+		Track const& keys = tracks[track];
+		size_t width = TrackWidth[track];
+		uint32_t const* firsts = keys.First.data();
+		double const* times = keys.Times.data();
+		uint32_t* current = cursor.keys[track].data();
+		//Raw columns, so that the stores do not reload them from the vectors.
+		double const* values[4];
+		double* fromColumns[4];
+		double* toColumns[4];
+
+		for (size_t k = 0; k < width; k++) {
+			values[k] = keys.Values[k].data();
+			fromColumns[k] = pose.Columns[TrackColumn[track] + k].data();
+			toColumns[k] = next[TrackColumn[track] + k].data();
+		}
+
+		for (size_t b = 0; b < boneCount; b++) {
+			size_t first = firsts[b];
+			size_t count = firsts[b + 1] - first;
+
+			if (count == 0) {
+				for (size_t k = 0; k < width; k++) {
+					fromColumns[k][b] = TrackIdentity[track][k];
+					toColumns[k][b] = TrackIdentity[track][k];
+				}
+
+				amounts[b] = 0;
+				continue;
+			}
+
+			size_t key = current[b];
+
+			if (!forward || key >= count) {
+				key = static_cast<size_t>(std::upper_bound(times + first, times + first + count, time) - (times + first));
+				key = key > 0 ? key - 1 : 0;
+			}
+
+			while (key + 1 < count && times[first + key + 1] <= time) {
+				key++;
+			}
+
+			current[b] = static_cast<uint32_t>(key);
+
+			size_t from = first + key;
+			size_t to = from;
+			amounts[b] = 0;
+
+			if (key + 1 < count && time > times[from]) {
+				to = from + 1;
+				amounts[b] = (time - times[from]) / (times[to] - times[from]);
+			}
+
+			for (size_t k = 0; k < width; k++) {
+				fromColumns[k][b] = values[k][from];
+				toColumns[k][b] = values[k][to];
+			}
+		}
+	}
+}
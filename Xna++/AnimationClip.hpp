@@ -0,0 +1,101 @@
+#ifndef _ANIMATIONCLIP_H_
+#define _ANIMATIONCLIP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AnimationPose.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	class AnimationClip;
+
+	enum class AnimationTrack {
+		Translation,
+		Rotation,
+		Scale
+	};
+
+	/*
+	 Playback position of one clip for one instance: the current key of every track of every bone, so that
+	 playing forward only steps over the keys passed since the last sample instead of searching them again.
+	*/
+	class AnimationCursor {
+	public:
+		//Makes the next sample search every key. Needed after adding keys to the clip.
+		void Reset();
+
+	private:
+		friend class AnimationClip;
+
+		AnimationClip const* clip{ nullptr };
+		double time{ 0 };
+		//Index, within its bone, of the last key at or before time, per track.
+		std::vector<uint32_t> keys[3];
+	};
+
+	//A clip playing on one skeleton, sampled by AnimationClip::Sample.
+	struct AnimationInstance {
+		AnimationClip const* Clip{ nullptr };
+		double Time{ 0 };
+		bool Loop{ true };
+		AnimationCursor Cursor;
+		AnimationPose Pose;
+	};
+
+	/*
+	 Keyframed translation, rotation and scale tracks of every bone of a skeleton. Each track stores the
+	 keys of all bones one after the other, bone by bone and sorted by time, with times and each component
+	 in their own arrays. Sample finds the two keys around the time for every bone, gathers them into
+	 columns, and then lerps translations and scales and slerps rotations of all bones in one pass, two
+	 bones per SSE2 instruction.
+
+	 A bone holds its first key before it and its last key after it; a track without keys gives the
+	 identity (no translation, no rotation, unit scale).
+	*/
+	class AnimationClip {
+	public:
+		AnimationClip(size_t boneCount, double duration);
+
+		size_t BoneCount() const;
+		double Duration() const;
+		size_t KeyCount(AnimationTrack track, size_t bone) const;
+
+		/*
+		 Adds a key, replacing one at the same time. Keys added in time order, bone after bone, are appended;
+		 others are inserted in place. Returns false if the bone is out of range.
+		*/
+		bool AddTranslation(size_t bone, double time, Vector3 const& translation);
+		//rotation is normalized.
+		bool AddRotation(size_t bone, double time, Quaternion const& rotation);
+		bool AddScale(size_t bone, double time, Vector3 const& scale);
+
+		//time wrapped into [0, Duration) if loop, otherwise clamped to [0, Duration].
+		double ClipTime(double time, bool loop) const;
+
+		//Pose of every bone at 'time', resizing pose to BoneCount().
+		void Sample(double time, AnimationCursor& cursor, AnimationPose& pose) const;
+		//Samples the pose of every instance with a clip at its ClipTime, the instances split over Parallel::For.
+		static void Sample(std::vector<AnimationInstance>& instances);
+
+	private:
+		struct Track {
+			//Keys of bone b are at First[b] to First[b + 1] - 1.
+			std::vector<uint32_t> First;
+			std::vector<double> Times;
+			std::vector<double> Values[4];
+		};
+
+		size_t boneCount;
+		double duration;
+		Track tracks[3];
+
+		bool AddKey(size_t track, size_t bone, double time, double const* values);
+		void Gather(size_t track, double time, bool forward, AnimationCursor& cursor, AnimationPose& pose,
+			std::vector<double>* next, double* amounts) const;
+	};
+}
+
+#endif
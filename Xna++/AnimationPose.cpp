@@ -0,0 +1,223 @@
+#include "AnimationPose.hpp"
+#include "Simd.hpp"
+
+namespace Xna {
+
+	static constexpr double IdentityColumns[AnimationPose::ColumnCount] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1 };
+
+	//Blends the lanes from i of the layer into result, by weight (already clamped to [0, 1]).
+	template <typename T>
+	static void BlendLanes(std::vector<double>* result, std::vector<double> const* layer, T weight, bool additive, size_t i) {
+		T one = T::Set(1.0);
+		T current[AnimationPose::ColumnCount];
+		T target[AnimationPose::ColumnCount];
+
+		for (size_t k = 0; k < AnimationPose::ColumnCount; k++) {
+			current[k] = T::Load(result[k].data() + i);
+			target[k] = T::Load(layer[k].data() + i);
+		}
+
+		T* rotation = current + AnimationPose::RotationColumn;
+		T* targetRotation = target + AnimationPose::RotationColumn;
+
+		if (!additive) {
+			for (size_t k = 0; k < 3; k++) {
+				size_t t = AnimationPose::TranslationColumn + k;
+				size_t s = AnimationPose::ScaleColumn + k;
+				current[t] = current[t] + (target[t] - current[t]) * weight;
+				current[s] = current[s] + (target[s] - current[s]) * weight;
+			}
+
+			Simd::Slerp(rotation, targetRotation, weight, rotation);
+		}
+		else {
+			for (size_t k = 0; k < 3; k++) {
+				size_t t = AnimationPose::TranslationColumn + k;
+				size_t s = AnimationPose::ScaleColumn + k;
+				current[t] = current[t] + target[t] * weight;
+				current[s] = current[s] * (one + (target[s] - one) * weight);
+			}
+
+			//rotation * Slerp(Identity, difference, weight).
+			T identity[4] = { T::Set(0.0), T::Set(0.0), T::Set(0.0), one };
+			T d[4];
+			Simd::Slerp(identity, targetRotation, weight, d);
+
+			T x = rotation[3] * d[0] + rotation[0] * d[3] + rotation[1] * d[2] - rotation[2] * d[1];
+			T y = rotation[3] * d[1] - rotation[0] * d[2] + rotation[1] * d[3] + rotation[2] * d[0];
+			T z = rotation[3] * d[2] + rotation[0] * d[1] - rotation[1] * d[0] + rotation[2] * d[3];
+			T w = rotation[3] * d[3] - rotation[0] * d[0] - rotation[1] * d[1] - rotation[2] * d[2];
+			rotation[0] = x;
+			rotation[1] = y;
+			rotation[2] = z;
+			rotation[3] = w;
+		}
+
+		for (size_t k = 0; k < AnimationPose::ColumnCount; k++) {
+			current[k].Store(result[k].data() + i);
+		}
+	}
+
+	template <typename T>
+	static T LaneWeight(AnimationLayer const& layer, size_t i) {
+		T weight = T::Set(layer.Weight);
+
+		if (layer.BoneWeights != nullptr) {
+			weight = weight * T::Load(layer.BoneWeights->data() + i);
+		}
+
+		return T::Max(T::Min(weight, T::Set(1.0)), T::Set(0.0));
+	}
+
+	AnimationPose::AnimationPose() {}
+
+	AnimationPose::AnimationPose(size_t boneCount) {
+		Resize(boneCount);
+	}
+
+	size_t AnimationPose::Count() const {
+		return Columns[0].size();
+	}
+
+	void AnimationPose::Resize(size_t boneCount) {
+		for (size_t k = 0; k < ColumnCount; k++) {
+			Columns[k].resize(boneCount, IdentityColumns[k]);
+		}
+	}
+
+	void AnimationPose::SetIdentity() {
+		for (size_t k = 0; k < ColumnCount; k++) {
+			Columns[k].assign(Columns[k].size(), IdentityColumns[k]);
+		}
+	}
+
+	Vector3 AnimationPose::Translation(size_t bone) const {
+		return Vector3(Columns[TranslationColumn][bone], Columns[TranslationColumn + 1][bone], Columns[TranslationColumn + 2][bone]);
+	}
+
+	Quaternion AnimationPose::Rotation(size_t bone) const {
+		return Quaternion(Columns[RotationColumn][bone], Columns[RotationColumn + 1][bone],
+			Columns[RotationColumn + 2][bone], Columns[RotationColumn + 3][bone]);
+	}
+
+	Vector3 AnimationPose::Scale(size_t bone) const {
+		return Vector3(Columns[ScaleColumn][bone], Columns[ScaleColumn + 1][bone], Columns[ScaleColumn + 2][bone]);
+	}
+
+	void AnimationPose::Set(size_t bone, Vector3 const& translation, Quaternion const& rotation, Vector3 const& scale) {
+		double values[ColumnCount] = {
+			translation.X, translation.Y, translation.Z,
+			rotation.X, rotation.Y, rotation.Z, rotation.W,
+			scale.X, scale.Y, scale.Z
+		};
+
+		for (size_t k = 0; k < ColumnCount; k++) {
+			Columns[k][bone] = values[k];
+		}
+	}
+
+	void AnimationPose::ToTransforms(std::vector<AffineTransform>& transforms) const {
+		size_t count = Count();
+		transforms.resize(count);
+
+		for (size_t b = 0; b < count; b++) {
+			AffineTransform transform = AffineTransform::CreateRigid(Rotation(b), Translation(b));
+			double scale[3] = { Columns[ScaleColumn][b], Columns[ScaleColumn + 1][b], Columns[ScaleColumn + 2][b] };
+
+			//Scaling first scales the rows of the rotation.
+			transform.M11 *= scale[0];
+			transform.M12 *= scale[0];
+			transform.M13 *= scale[0];
+			transform.M21 *= scale[1];
+			transform.M22 *= scale[1];
+			transform.M23 *= scale[1];
+			transform.M31 *= scale[2];
+			transform.M32 *= scale[2];
+			transform.M33 *= scale[2];
+			transforms[b] = transform;
+		}
+	}
+
+	bool AnimationPose::Blend(std::vector<AnimationLayer> const& layers, AnimationPose& result) {
+		if (layers.empty() || layers[0].Pose == nullptr) {
+			return false;
+		}
+
+		size_t count = layers[0].Pose->Count();
+
+		for (size_t l = 1; l < layers.size(); l++) {
+			if (layers[l].Pose == nullptr || layers[l].Pose->Count() != count
+				|| (layers[l].BoneWeights != nullptr && layers[l].BoneWeights->size() != count)) {
+				return false;
+			}
+		}
+
+		//A later layer that is result would be overwritten before it is read, so blend into a copy then.
+		AnimationPose scratch;
+		AnimationPose* target = &result;
+
+		for (size_t l = 1; l < layers.size(); l++) {
+			if (layers[l].Pose == &result) {
+				target = &scratch;
+			}
+		}
+
+		if (target != layers[0].Pose) {
+			for (size_t k = 0; k < ColumnCount; k++) {
+				target->Columns[k] = layers[0].Pose->Columns[k];
+			}
+		}
+
+		for (size_t l = 1; l < layers.size(); l++) {
+			AnimationLayer const& layer = layers[l];
+			size_t i = 0;
+
+#ifdef XNA_SIMD_SSE2
+			for (; i + 4 <= count; i += 4) {
+				using Quad = Simd::Twice<Simd::Pair>;
+				BlendLanes<Quad>(target->Columns, layer.Pose->Columns, LaneWeight<Quad>(layer, i), layer.Additive, i);
+			}
+
+			for (; i + 2 <= count; i += 2) {
+				BlendLanes<Simd::Pair>(target->Columns, layer.Pose->Columns, LaneWeight<Simd::Pair>(layer, i), layer.Additive, i);
+			}
+#endif
+			for (; i < count; i++) {
+				BlendLanes<Simd::Scalar>(target->Columns, layer.Pose->Columns, LaneWeight<Simd::Scalar>(layer, i), layer.Additive, i);
+			}
+		}
+
+		if (target == &scratch) {
+			for (size_t k = 0; k < ColumnCount; k++) {
+				result.Columns[k].swap(scratch.Columns[k]);
+			}
+		}
+
+		return true;
+	}
+
+	bool AnimationPose::Difference(AnimationPose const& pose, AnimationPose const& reference, AnimationPose& result) {
+		size_t count = pose.Count();
+
+		if (reference.Count() != count) {
+			return false;
+		}
+
+		result.Resize(count);
+
+		for (size_t b = 0; b < count; b++) {
+			Vector3 scale = pose.Scale(b);
+			Vector3 referenceScale = reference.Scale(b);
+
+			result.Set(b,
+				pose.Translation(b) - reference.Translation(b),
+				Quaternion::Multiply(Quaternion::Conjugate(reference.Rotation(b)), pose.Rotation(b)),
+				Vector3(
+					referenceScale.X != 0 ? scale.X / referenceScale.X : 1,
+					referenceScale.Y != 0 ? scale.Y / referenceScale.Y : 1,
+					referenceScale.Z != 0 ? scale.Z / referenceScale.Z : 1));
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,70 @@
+#ifndef _ANIMATIONPOSE_H_
+#define _ANIMATIONPOSE_H_
+
+#include <cstddef>
+#include <vector>
+#include "AffineTransform.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	class AnimationPose;
+
+	//A pose blended by AnimationPose::Blend.
+	struct AnimationLayer {
+		AnimationPose const* Pose{ nullptr };
+		double Weight{ 1 };
+		//Weight of each bone, multiplied by Weight; null for every bone at Weight.
+		std::vector<double> const* BoneWeights{ nullptr };
+		//Adds the pose, a difference from AnimationPose::Difference, instead of blending toward it.
+		bool Additive{ false };
+	};
+
+	/*
+	 Local transforms of the bones of a skeleton, as structure of arrays: translation X, Y, Z, rotation
+	 X, Y, Z, W and scale X, Y, Z, one column each, so that sampling and blending run over all bones two at
+	 a time.
+	*/
+	class AnimationPose {
+	public:
+		static constexpr size_t ColumnCount = 10;
+		static constexpr size_t TranslationColumn = 0;
+		static constexpr size_t RotationColumn = 3;
+		static constexpr size_t ScaleColumn = 7;
+
+		std::vector<double> Columns[ColumnCount];
+
+		AnimationPose();
+		explicit AnimationPose(size_t boneCount);
+
+		size_t Count() const;
+		//Added bones get the identity transform.
+		void Resize(size_t boneCount);
+		void SetIdentity();
+
+		Vector3 Translation(size_t bone) const;
+		Quaternion Rotation(size_t bone) const;
+		Vector3 Scale(size_t bone) const;
+		void Set(size_t bone, Vector3 const& translation, Quaternion const& rotation, Vector3 const& scale);
+
+		//Scale, then rotation, then translation of every bone, resizing transforms to Count().
+		void ToTransforms(std::vector<AffineTransform>& transforms) const;
+
+		/*
+		 Layered blend. result starts as the pose of the first layer (whose weight is ignored); every next
+		 layer then moves each bone toward its own pose by its weight (lerp for translation and scale, slerp
+		 for rotation), or, if Additive, applies its difference scaled by its weight. Weights are clamped to
+		 [0, 1]. result may be one of the poses.
+		 Returns false if there is no layer, a pose is null or of another size, or BoneWeights has another size.
+		*/
+		static bool Blend(std::vector<AnimationLayer> const& layers, AnimationPose& result);
+		/*
+		 Difference of pose from reference, for an additive layer: translation pose - reference, rotation
+		 Conjugate(reference) * pose and scale pose / reference. Returns false if the sizes differ.
+		*/
+		static bool Difference(AnimationPose const& pose, AnimationPose const& reference, AnimationPose& result);
+	};
+}
+
+#endif
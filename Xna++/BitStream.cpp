@@ -0,0 +1,96 @@
+#include "BitStream.hpp"
+
+namespace Xna {
+
+	void BitWriter::Write(uint32_t value, int32_t bits) {
+		if (bits <= 0) {
+			return;
+		}
+
+		uint64_t mask = (uint64_t(1) << bits) - 1;
+		scratch |= (value & mask) << scratchBits;
+		scratchBits += bits;
+		bitCount += static_cast<size_t>(bits);
+
+		if (scratchBits >= 32) {
+			uint32_t word = static_cast<uint32_t>(scratch);
+			bytes.push_back(static_cast<uint8_t>(word));
+			bytes.push_back(static_cast<uint8_t>(word >> 8));
+			bytes.push_back(static_cast<uint8_t>(word >> 16));
+			bytes.push_back(static_cast<uint8_t>(word >> 24));
+
+			scratch >>= 32;
+			scratchBits -= 32;
+		}
+	}
+
+	void BitWriter::WriteBool(bool value) {
+		Write(value ? 1 : 0, 1);
+	}
+
+	size_t BitWriter::BitCount() const {
+		return bitCount;
+	}
+
+	std::vector<uint8_t> const& BitWriter::Finish() {
+		while (scratchBits > 0) {
+			bytes.push_back(static_cast<uint8_t>(scratch));
+			scratch >>= 8;
+			scratchBits -= 8;
+		}
+
+		scratch = 0;
+		scratchBits = 0;
+		return bytes;
+	}
+
+	void BitWriter::Clear() {
+		scratch = 0;
+		scratchBits = 0;
+		bitCount = 0;
+		bytes.clear();
+	}
+
+	BitReader::BitReader(uint8_t const* data, size_t size) :
+		data(data), size(size) {}
+	BitReader::BitReader(std::vector<uint8_t> const& data) :
+		data(data.data()), size(data.size()) {}
+
+	bool BitReader::Read(int32_t bits, uint32_t& value) {
+		if (bits <= 0) {
+			value = 0;
+			return true;
+		}
+
+		while (scratchBits < bits && position < size) {
+			scratch |= static_cast<uint64_t>(data[position++]) << scratchBits;
+			scratchBits += 8;
+		}
+
+		if (scratchBits < bits) {
+			scratch = 0;
+			scratchBits = 0;
+			return false;
+		}
+
+		value = static_cast<uint32_t>(scratch & ((uint64_t(1) << bits) - 1));
+		scratch >>= bits;
+		scratchBits -= bits;
+		return true;
+	}
+
+	bool BitReader::ReadBool(bool& value) {
+		uint32_t bit;
+
+		if (!Read(1, bit)) {
+			return false;
+		}
+
+		value = bit != 0;
+		return true;
+	}
+
+	size_t BitReader::BitsLeft() const {
+		return (size - position) * 8 + static_cast<size_t>(scratchBits);
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef _BITSTREAM_H_
+#define _BITSTREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Xna {
+
+	/*
+	 Packs values of 0 to 32 bits, least significant bit first, through a 64 bit accumulator that is
+	 spilled 32 bits at a time, little endian. Finish pads the last byte with zeros.
+	*/
+	class BitWriter {
+	public:
+		//Writes the low 'bits' bits of value.
+		void Write(uint32_t value, int32_t bits);
+		void WriteBool(bool value);
+
+		//Bits written so far.
+		size_t BitCount() const;
+		//Flushes the accumulator and returns the bytes. Nothing may be written after it until Clear.
+		std::vector<uint8_t> const& Finish();
+		void Clear();
+
+	private:
+		uint64_t scratch{ 0 };
+		int32_t scratchBits{ 0 };
+		size_t bitCount{ 0 };
+		std::vector<uint8_t> bytes;
+	};
+
+	//Reads what a BitWriter wrote. Reads past the end fail and leave the reader at the end.
+	class BitReader {
+	public:
+		BitReader(uint8_t const* data, size_t size);
+		BitReader(std::vector<uint8_t> const& data);
+
+		bool Read(int32_t bits, uint32_t& value);
+		bool ReadBool(bool& value);
+
+		size_t BitsLeft() const;
+
+	private:
+		uint8_t const* data;
+		size_t size;
+		size_t position{ 0 };
+		uint64_t scratch{ 0 };
+		int32_t scratchBits{ 0 };
+	};
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include "Color.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+#include "MathHelper.hpp"
+
+namespace Xna {
+	static uint8_t ClampByte(int32_t v) {
+		return static_cast<uint8_t>(MathHelper::Clamp(v, 0, 255));
+	}
+
+	Color::Color() {}
+	Color::Color(uint32_t packedValue) :
+		R(static_cast<uint8_t>(packedValue)),
+		G(static_cast<uint8_t>(packedValue >> 8)),
+		B(static_cast<uint8_t>(packedValue >> 16)),
+		A(static_cast<uint8_t>(packedValue >> 24)) {}
+	Color::Color(Vector4 color) :
+		Color(color.X, color.Y, color.Z, color.W) {}
+	Color::Color(Vector3 color) :
+		Color(color.X, color.Y, color.Z) {}
+	Color::Color(Color color, int32_t alpha) :
+		R(color.R), G(color.G), B(color.B), A(ClampByte(alpha)) {}
+	Color::Color(Color color, double alpha) :
+		Color(color, static_cast<int32_t>(alpha * 255)) {}
+	Color::Color(double r, double g, double b) :
+		Color(static_cast<int32_t>(r * 255), static_cast<int32_t>(g * 255), static_cast<int32_t>(b * 255)) {}
+	Color::Color(double r, double g, double b, double alpha) :
+		Color(static_cast<int32_t>(r * 255), static_cast<int32_t>(g * 255),
+			static_cast<int32_t>(b * 255), static_cast<int32_t>(alpha * 255)) {}
+	Color::Color(int32_t r, int32_t g, int32_t b) :
+		R(ClampByte(r)), G(ClampByte(g)), B(ClampByte(b)), A(255) {}
+	Color::Color(int32_t r, int32_t g, int32_t b, int32_t alpha) :
+		R(ClampByte(r)), G(ClampByte(g)), B(ClampByte(b)), A(ClampByte(alpha)) {}
+	Color::Color(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha) :
+		R(r), G(g), B(b), A(alpha) {}
+
+	const Color Color::Transparent = Color(0u);
+	const Color Color::Black = Color(0xFF000000u);
+	const Color Color::White = Color(0xFFFFFFFFu);
+
+	Color Color::Lerp(Color const& c1, Color const& c2, double amount) {
+		amount = MathHelper::Clamp(amount, 0.0, 1.0);
+
+		return Color(
+			static_cast<int32_t>(MathHelper::Lerp(c1.R, c2.R, amount)),
+			static_cast<int32_t>(MathHelper::Lerp(c1.G, c2.G, amount)),
+			static_cast<int32_t>(MathHelper::Lerp(c1.B, c2.B, amount)),
+			static_cast<int32_t>(MathHelper::Lerp(c1.A, c2.A, amount))
+		);
+	}
+
+	Color Color::LerpPrecise(Color const& c1, Color const& c2, double amount) {
+		amount = MathHelper::Clamp(amount, 0.0, 1.0);
+
+		return Color(
+			static_cast<int32_t>(MathHelper::LerpPrecise(c1.R, c2.R, amount)),
+			static_cast<int32_t>(MathHelper::LerpPrecise(c1.G, c2.G, amount)),
+			static_cast<int32_t>(MathHelper::LerpPrecise(c1.B, c2.B, amount)),
+			static_cast<int32_t>(MathHelper::LerpPrecise(c1.A, c2.A, amount))
+		);
+	}
+
+	Color Color::Multiply(Color const& c, double scale) {
+		return Color(
+			static_cast<int32_t>(c.R * scale),
+			static_cast<int32_t>(c.G * scale),
+			static_cast<int32_t>(c.B * scale),
+			static_cast<int32_t>(c.A * scale)
+		);
+	}
+
+	Color Color::FromNonPremultiplied(Vector4 const& v) {
+		return Color(v.X * v.W, v.Y * v.W, v.Z * v.W, v.W);
+	}
+
+	Color Color::FromNonPremultiplied(int32_t r, int32_t g, int32_t b, int32_t a) {
+		return Color(r * a / 255, g * a / 255, b * a / 255, a);
+	}
+
+	uint32_t Color::PackedValue() const {
+		return static_cast<uint32_t>(R)
+			| (static_cast<uint32_t>(G) << 8)
+			| (static_cast<uint32_t>(B) << 16)
+			| (static_cast<uint32_t>(A) << 24);
+	}
+
+	Vector3 Color::ToVector3() const {
+		return Vector3(R / 255.0, G / 255.0, B / 255.0);
+	}
+
+	Vector4 Color::ToVector4() const {
+		return Vector4(R / 255.0, G / 255.0, B / 255.0, A / 255.0);
+	}
+
+	bool Color::Equals(Color other) const {
+		return R == other.R
+			&& G == other.G
+			&& B == other.B
+			&& A == other.A;
+	}
+
+	void Color::Deconstruct(uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& a) const {
+		r = R;
+		g = G;
+		b = B;
+		a = A;
+	}
+
+	Color operator* (Color c, double scale) {
+		return Color::Multiply(c, scale);
+	}
+
+	Color operator* (double scale, Color c) {
+		return Color::Multiply(c, scale);
+	}
+
+	bool operator== (Color c1, Color c2) {
+		return c1.Equals(c2);
+	}
+
+	bool operator!= (Color c1, Color c2) {
+		return !c1.Equals(c2);
+	}
+}
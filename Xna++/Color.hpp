@@ -0,0 +1,55 @@
+#ifndef _COLOR_H_
+#define _COLOR_H_
+
+#include <cstdint>
+
+namespace Xna {
+
+	class Vector3;
+	class Vector4;
+
+	//32-bit RGBA color, stored in memory as R, G, B, A (R in the least significant octet of PackedValue).
+	class Color {
+	public:
+		uint8_t R{ 0 };
+		uint8_t G{ 0 };
+		uint8_t B{ 0 };
+		uint8_t A{ 0 };
+
+		Color();
+		Color(uint32_t packedValue);
+		Color(Vector4 color);
+		Color(Vector3 color);
+		Color(Color color, int32_t alpha);
+		Color(Color color, double alpha);
+		Color(double r, double g, double b);
+		Color(double r, double g, double b, double alpha);
+		//The integer overloads clamp each component to [0, 255].
+		Color(int32_t r, int32_t g, int32_t b);
+		Color(int32_t r, int32_t g, int32_t b, int32_t alpha);
+		Color(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha);
+
+		static const Color Transparent;
+		static const Color Black;
+		static const Color White;
+
+		friend Color operator* (Color, double);
+		friend Color operator* (double, Color);
+		friend bool operator== (Color, Color);
+		friend bool operator!= (Color, Color);
+
+		static Color Lerp(Color const& c1, Color const& c2, double amount);
+		static Color LerpPrecise(Color const& c1, Color const& c2, double amount);
+		static Color Multiply(Color const& c, double scale);
+		static Color FromNonPremultiplied(Vector4 const& v);
+		static Color FromNonPremultiplied(int32_t r, int32_t g, int32_t b, int32_t a);
+
+		uint32_t PackedValue() const;
+		Vector3 ToVector3() const;
+		Vector4 ToVector4() const;
+		bool Equals(Color other) const;
+		void Deconstruct(uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& a) const;
+	};
+}
+
+#endif
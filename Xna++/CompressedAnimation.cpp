@@ -0,0 +1,551 @@
+#include <algorithm>
+#include <cmath>
+#include "CompressedAnimation.hpp"
+#include "MathHelper.hpp"
+
+namespace Xna {
+
+	//Components and first pose column of each track: translation, rotation, scale.
+	static constexpr size_t TrackWidth[3] = { 3, 4, 3 };
+	static constexpr size_t TrackColumn[3] = { AnimationPose::TranslationColumn, AnimationPose::RotationColumn, AnimationPose::ScaleColumn };
+	static constexpr double TrackIdentity[3][4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 1 }, { 1, 1, 1, 0 } };
+	//Largest code of a component stored in one or two 16 bit words.
+	static constexpr double MaxCodes[3] = { 0, 65535.0, 4294967295.0 };
+
+	//One track of one bone being fitted. Arrays hold Width components per frame.
+	struct TrackFit {
+		size_t Track;
+		size_t Width;
+		size_t Frames;
+		bool Tangents;
+		double Tolerance;
+		//16 bit words per code, 2 when 16 bits are too coarse for the tolerance.
+		size_t Words;
+		//Source samples, and the quantized values and tangents (per frame) as decompressed.
+		std::vector<double> Source;
+		std::vector<double> Values;
+		std::vector<double> Slopes;
+		std::vector<uint32_t> ValueCodes;
+		std::vector<uint32_t> SlopeCodes;
+		//Minimum and step of the values, then of the tangents, per component.
+		double Ranges[4][4];
+	};
+
+	static void Quantize(std::vector<double> const& source, size_t width, size_t words, std::vector<uint32_t>& codes,
+		std::vector<double>& values, double (*ranges)[4], size_t first) {
+
+		double maxCode = MaxCodes[words];
+		size_t count = source.size() / width;
+		codes.resize(source.size());
+		values.resize(source.size());
+
+		for (size_t k = 0; k < width; k++) {
+			double min = source[k];
+			double max = source[k];
+
+			for (size_t f = 1; f < count; f++) {
+				min = std::min(min, source[f * width + k]);
+				max = std::max(max, source[f * width + k]);
+			}
+
+			double step = (max - min) / maxCode;
+			ranges[k][first] = min;
+			ranges[k][first + 1] = step;
+
+			for (size_t f = 0; f < count; f++) {
+				double scaled = step > 0 ? std::floor((source[f * width + k] - min) / step + 0.5) : 0;
+				uint32_t code = static_cast<uint32_t>(MathHelper::Clamp(scaled, 0.0, maxCode));
+				codes[f * width + k] = code;
+				values[f * width + k] = min + code * step;
+			}
+		}
+	}
+
+	/*
+	 Weights of MathHelper::Hermite at 'amount' for the two values, then for the two tangents scaled to the
+	 span of the segment; MathHelper::CatmullRom is the same curve with the tangents of the neighbouring
+	 keys. The basis is expanded once per segment and shared by every component of the track, instead of
+	 calling Hermite per component, which repeats the powers and its tests for the ends of the segment.
+	*/
+	static void HermiteWeights(double amount, double span, double* weights) {
+		double squared = amount * amount;
+		double cubed = squared * amount;
+
+		weights[0] = 2 * cubed - 3 * squared + 1;
+		weights[1] = 3 * squared - 2 * cubed;
+		weights[2] = (cubed - 2 * squared + amount) * span;
+		weights[3] = (cubed - squared) * span;
+	}
+
+	/*
+	 Curve of the segment from keys[segment] at 'frame', with the decompressed values of the fit. Written
+	 the same way as CompressedAnimation::SampleTrack so that the fit checks what will be sampled.
+	*/
+	static void Evaluate(TrackFit const& fit, std::vector<size_t> const& keys, size_t segment, double frame, double* result) {
+		size_t a = keys[segment];
+		size_t b = keys[segment + 1];
+		double span = static_cast<double>(b - a);
+		double weights[4];
+		size_t w = fit.Width;
+
+		HermiteWeights((frame - a) / span, span, weights);
+
+		if (fit.Tangents) {
+			for (size_t k = 0; k < w; k++) {
+				result[k] = weights[0] * fit.Values[a * w + k] + weights[1] * fit.Values[b * w + k]
+					+ weights[2] * fit.Slopes[a * w + k] + weights[3] * fit.Slopes[b * w + k];
+			}
+
+			return;
+		}
+
+		size_t before = segment > 0 ? keys[segment - 1] : a;
+		size_t after = segment + 2 < keys.size() ? keys[segment + 2] : b;
+
+		for (size_t k = 0; k < w; k++) {
+			double tangentFrom = (fit.Values[b * w + k] - fit.Values[before * w + k]) / static_cast<double>(b - before);
+			double tangentTo = (fit.Values[after * w + k] - fit.Values[a * w + k]) / static_cast<double>(after - a);
+			result[k] = weights[0] * fit.Values[a * w + k] + weights[1] * fit.Values[b * w + k]
+				+ weights[2] * tangentFrom + weights[3] * tangentTo;
+		}
+	}
+
+	//Distance, or angle for rotations, between the source frame and a curve value.
+	static double Error(TrackFit const& fit, size_t frame, double const* value) {
+		double const* source = fit.Source.data() + frame * fit.Width;
+
+		if (fit.Track != 1) {
+			return Vector3::Distance(Vector3(source[0], source[1], source[2]), Vector3(value[0], value[1], value[2]));
+		}
+
+		Quaternion rotation = Quaternion::Normalize(Quaternion(value[0], value[1], value[2], value[3]));
+		double dot = std::fabs(source[0] * rotation.X + source[1] * rotation.Y + source[2] * rotation.Z + source[3] * rotation.W);
+		return 2.0 * std::acos(dot < 1.0 ? dot : 1.0);
+	}
+
+	/*
+	 Whether every quantized frame is within the tolerance. Curves pass through their keys, so this bounds
+	 the error at the keys, and the key reduction only has to check the frames between them.
+	*/
+	static bool QuantizedFits(TrackFit const& fit) {
+		for (size_t f = 0; f < fit.Frames; f++) {
+			if (Error(fit, f, fit.Values.data() + f * fit.Width) > fit.Tolerance) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//Appends the codes of a key, high word first when they take two.
+	static void AppendCodes(std::vector<uint16_t>& values, uint32_t const* codes, size_t count, size_t words) {
+		for (size_t k = 0; k < count; k++) {
+			if (words == 2) {
+				values.push_back(static_cast<uint16_t>(codes[k] >> 16));
+			}
+
+			values.push_back(static_cast<uint16_t>(codes[k]));
+		}
+	}
+
+	//Component k of a key's codes stored in one or two words.
+	static inline double Code(uint16_t const* codes, size_t k, size_t words) {
+		return words == 1 ? codes[k] : static_cast<double>((static_cast<uint32_t>(codes[2 * k]) << 16) | codes[2 * k + 1]);
+	}
+
+	//Frame of the segment with the largest error over the tolerance, or 0 if none is.
+	static size_t WorstFrame(TrackFit const& fit, std::vector<size_t> const& keys, size_t segment) {
+		double value[4];
+		double worst = fit.Tolerance;
+		size_t frame = 0;
+
+		for (size_t f = keys[segment] + 1; f < keys[segment + 1]; f++) {
+			Evaluate(fit, keys, segment, static_cast<double>(f), value);
+			double error = Error(fit, f, value);
+
+			if (error > worst) {
+				worst = error;
+				frame = f;
+			}
+		}
+
+		return frame;
+	}
+
+	static bool Constant(TrackFit const& fit) {
+		for (size_t f = 1; f < fit.Frames; f++) {
+			if (Error(fit, f, fit.Values.data()) > fit.Tolerance) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//Whether the segment from key 'from' to frame 'to' fits, the keys before being kept.
+	static bool Fits(TrackFit const& fit, std::vector<size_t>& keys, size_t to) {
+		keys.push_back(to);
+		bool fits = WorstFrame(fit, keys, keys.size() - 2) == 0;
+		keys.pop_back();
+		return fits;
+	}
+
+	/*
+	 Greedy pass: from each key, the longest segment found by doubling then bisecting its length. Errors
+	 are not monotonic in the length, and a Catmull-Rom segment depends on the key after it, so a second
+	 pass then splits every segment at its worst frame until all of them fit.
+	*/
+	static std::vector<size_t> ReduceKeys(TrackFit const& fit) {
+		std::vector<size_t> keys(1, 0);
+
+		if (fit.Frames == 1 || Constant(fit)) {
+			return keys;
+		}
+
+		size_t last = fit.Frames - 1;
+
+		while (keys.back() < last) {
+			size_t from = keys.back();
+			size_t good = from + 1;
+			size_t length = 2;
+
+			while (from + length <= last && Fits(fit, keys, from + length)) {
+				good = from + length;
+				length *= 2;
+			}
+
+			size_t bad = std::min(from + length, last + 1);
+
+			while (bad - good > 1) {
+				size_t middle = good + (bad - good) / 2;
+
+				if (Fits(fit, keys, middle)) {
+					good = middle;
+				}
+				else {
+					bad = middle;
+				}
+			}
+
+			keys.push_back(good);
+		}
+
+		for (;;) {
+			std::vector<size_t> added;
+
+			for (size_t s = 0; s + 1 < keys.size(); s++) {
+				size_t frame = WorstFrame(fit, keys, s);
+
+				if (frame != 0) {
+					added.push_back(frame);
+				}
+			}
+
+			if (added.empty()) {
+				return keys;
+			}
+
+			keys.insert(keys.end(), added.begin(), added.end());
+			std::sort(keys.begin(), keys.end());
+		}
+	}
+
+	bool CompressedAnimation::Compress(std::vector<AnimationBoneSamples> const& bones, double frameRate,
+		AnimationCompressionSettings const& settings, CompressedAnimation& result) {
+
+		size_t frames = 0;
+
+		for (size_t b = 0; b < bones.size(); b++) {
+			frames = std::max(frames, std::max(bones[b].Translations.size(), std::max(bones[b].Rotations.size(), bones[b].Scales.size())));
+		}
+
+		if (!(frameRate > 0) || frames > MaxFrameCount) {
+			return false;
+		}
+
+		for (size_t b = 0; b < bones.size(); b++) {
+			size_t sizes[3] = { bones[b].Translations.size(), bones[b].Rotations.size(), bones[b].Scales.size() };
+
+			for (size_t t = 0; t < 3; t++) {
+				if (sizes[t] != 0 && sizes[t] != frames) {
+					return false;
+				}
+			}
+		}
+
+		CompressedAnimation compressed;
+		compressed.fit = settings.Fit;
+		compressed.boneCount = bones.size();
+		compressed.frameCount = frames;
+		compressed.frameRate = frameRate;
+
+		double tolerances[3] = { settings.TranslationTolerance, settings.RotationTolerance, settings.ScaleTolerance };
+
+		for (size_t t = 0; t < 3; t++) {
+			Track& track = compressed.tracks[t];
+			size_t width = TrackWidth[t];
+			track.First.resize(bones.size() + 1);
+			track.Offsets.resize(bones.size());
+			track.Words.resize(bones.size(), 1);
+			track.Ranges.resize(bones.size() * width * 4);
+
+			for (size_t b = 0; b < bones.size(); b++) {
+				TrackFit fit;
+				fit.Track = t;
+				fit.Width = width;
+				fit.Frames = t == 0 ? bones[b].Translations.size() : (t == 1 ? bones[b].Rotations.size() : bones[b].Scales.size());
+				fit.Tangents = settings.Fit == AnimationCurveFit::Hermite;
+				fit.Tolerance = tolerances[t];
+				fit.Words = 1;
+				fit.Source.resize(fit.Frames * width);
+
+				for (size_t f = 0; f < fit.Frames; f++) {
+					double* source = fit.Source.data() + f * width;
+
+					if (t == 1) {
+						Quaternion rotation = Quaternion::Normalize(bones[b].Rotations[f]);
+						double sign = 1;
+
+						//On the hemisphere of the previous sample, so that components vary smoothly.
+						if (f > 0 && source[-4] * rotation.X + source[-3] * rotation.Y + source[-2] * rotation.Z + source[-1] * rotation.W < 0) {
+							sign = -1;
+						}
+
+						source[0] = rotation.X * sign;
+						source[1] = rotation.Y * sign;
+						source[2] = rotation.Z * sign;
+						source[3] = rotation.W * sign;
+					}
+					else {
+						Vector3 const& value = t == 0 ? bones[b].Translations[f] : bones[b].Scales[f];
+						source[0] = value.X;
+						source[1] = value.Y;
+						source[2] = value.Z;
+					}
+				}
+
+				track.First[b + 1] = track.First[b];
+				track.Offsets[b] = static_cast<uint32_t>(track.Values.size());
+
+				if (fit.Frames == 0) {
+					continue;
+				}
+
+				std::vector<double> slopes(fit.Source.size());
+
+				for (size_t f = 0; f < fit.Frames; f++) {
+					size_t before = f > 0 ? f - 1 : f;
+					size_t after = f + 1 < fit.Frames ? f + 1 : f;
+					double span = after > before ? static_cast<double>(after - before) : 1.0;
+
+					for (size_t k = 0; k < width; k++) {
+						slopes[f * width + k] = (fit.Source[after * width + k] - fit.Source[before * width + k]) / span;
+					}
+				}
+
+				Quantize(fit.Source, width, fit.Words, fit.ValueCodes, fit.Values, fit.Ranges, 0);
+
+				if (!QuantizedFits(fit)) {
+					fit.Words = 2;
+					Quantize(fit.Source, width, fit.Words, fit.ValueCodes, fit.Values, fit.Ranges, 0);
+
+					if (!QuantizedFits(fit)) {
+						return false;
+					}
+				}
+
+				Quantize(slopes, width, fit.Words, fit.SlopeCodes, fit.Slopes, fit.Ranges, 2);
+				track.Words[b] = static_cast<uint8_t>(fit.Words);
+
+				std::vector<size_t> keys = ReduceKeys(fit);
+				track.First[b + 1] = track.First[b] + static_cast<uint32_t>(keys.size());
+
+				for (size_t i = 0; i < keys.size(); i++) {
+					track.Frames.push_back(static_cast<uint16_t>(keys[i]));
+					AppendCodes(track.Values, fit.ValueCodes.data() + keys[i] * width, width, fit.Words);
+
+					if (fit.Tangents) {
+						AppendCodes(track.Values, fit.SlopeCodes.data() + keys[i] * width, width, fit.Words);
+					}
+				}
+
+				for (size_t k = 0; k < width; k++) {
+					for (size_t r = 0; r < 4; r++) {
+						track.Ranges[(b * width + k) * 4 + r] = fit.Ranges[k][r];
+					}
+				}
+			}
+		}
+
+		result = compressed;
+		return true;
+	}
+
+	size_t CompressedAnimation::BoneCount() const {
+		return boneCount;
+	}
+
+	size_t CompressedAnimation::FrameCount() const {
+		return frameCount;
+	}
+
+	double CompressedAnimation::FrameRate() const {
+		return frameRate;
+	}
+
+	double CompressedAnimation::Duration() const {
+		return frameCount > 1 ? (frameCount - 1) / frameRate : 0;
+	}
+
+	size_t CompressedAnimation::KeyCount() const {
+		return tracks[0].Frames.size() + tracks[1].Frames.size() + tracks[2].Frames.size();
+	}
+
+	size_t CompressedAnimation::ByteSize() const {
+		size_t size = 0;
+
+		for (size_t t = 0; t < 3; t++) {
+			size += (tracks[t].First.size() + tracks[t].Offsets.size()) * sizeof(uint32_t) + tracks[t].Words.size()
+				+ tracks[t].Frames.size() * sizeof(uint16_t)
+				+ tracks[t].Values.size() * sizeof(uint16_t) + tracks[t].Ranges.size() * sizeof(double);
+		}
+
+		return size;
+	}
+
+	void CompressedAnimation::Sample(double time, AnimationPose& pose) const {
+		CompressedAnimationCursor cursor;
+		Sample(time, cursor, pose);
+	}
+
+	void CompressedAnimation::Sample(double time, CompressedAnimationCursor& cursor, AnimationPose& pose) const {
+		pose.Resize(boneCount);
+
+		double last = frameCount > 0 ? static_cast<double>(frameCount - 1) : 0.0;
+		double frame = MathHelper::Clamp(time * frameRate, 0.0, last);
+		bool forward = cursor.animation == this && frame >= cursor.frame;
+
+		for (size_t t = 0; t < 3; t++) {
+			if (cursor.animation != this) {
+				cursor.keys[t].assign(boneCount, 0);
+			}
+
+			SampleTrack(t, frame, forward, cursor.keys[t].data(), pose);
+		}
+
+		cursor.animation = this;
+		cursor.frame = frame;
+	}
+
+	void CompressedAnimation::SampleTrack(size_t track, double frame, bool forward, uint32_t* cursor, AnimationPose& pose) const {
+		Track const& keys = tracks[track];
+		size_t width = TrackWidth[track];
+		bool tangents = fit == AnimationCurveFit::Hermite;
+		size_t stride = tangents ? 2 * width : width;
+		uint16_t const* frames = keys.Frames.data();
+		double* columns[4];
+
+		for (size_t k = 0; k < width; k++) {
+			columns[k] = pose.Columns[TrackColumn[track] + k].data();
+		}
+
+		for (size_t b = 0; b < boneCount; b++) {
+			size_t first = keys.First[b];
+			size_t count = keys.First[b + 1] - first;
+			double const* ranges = keys.Ranges.data() + b * width * 4;
+			size_t words = keys.Words[b];
+			size_t keyStride = stride * words;
+			uint16_t const* codes = keys.Values.data() + keys.Offsets[b];
+			double value[4];
+
+			if (count == 0) {
+				for (size_t k = 0; k < width; k++) {
+					columns[k][b] = TrackIdentity[track][k];
+				}
+
+				continue;
+			}
+
+			//Last key at or before the frame (or the first key), as an index within the bone.
+			size_t key = cursor[b];
+
+			if (!forward || key >= count) {
+				key = static_cast<size_t>(std::upper_bound(frames + first, frames + first + count, frame) - (frames + first));
+				key = key > 0 ? key - 1 : 0;
+			}
+
+			while (key + 1 < count && frames[first + key + 1] <= frame) {
+				key++;
+			}
+
+			cursor[b] = static_cast<uint32_t>(key);
+
+			size_t a = first + key;
+			uint16_t const* from = codes + key * keyStride;
+
+			if (key + 1 == count || frame <= frames[a]) {
+				for (size_t k = 0; k < width; k++) {
+					value[k] = ranges[k * 4] + Code(from, k, words) * ranges[k * 4 + 1];
+				}
+			}
+			else {
+				size_t next = a + 1;
+				double span = static_cast<double>(frames[next] - frames[a]);
+				double weights[4];
+				uint16_t const* to = from + keyStride;
+
+				HermiteWeights((frame - frames[a]) / span, span, weights);
+
+				if (tangents) {
+					//The value weights sum to 1, so the minimums add up to a single one.
+					double slopeWeight = weights[2] + weights[3];
+					uint16_t const* fromSlopes = from + width * words;
+					uint16_t const* toSlopes = to + width * words;
+
+					for (size_t k = 0; k < width; k++) {
+						double const* range = ranges + k * 4;
+
+						value[k] = range[0] + range[1] * (weights[0] * Code(from, k, words) + weights[1] * Code(to, k, words))
+							+ range[2] * slopeWeight + range[3] * (weights[2] * Code(fromSlopes, k, words) + weights[3] * Code(toSlopes, k, words));
+					}
+				}
+				else {
+					size_t before = a > first ? a - 1 : a;
+					size_t after = next + 1 < first + count ? next + 1 : next;
+					double spanFrom = static_cast<double>(frames[next] - frames[before]);
+					double spanTo = static_cast<double>(frames[after] - frames[a]);
+					uint16_t const* beforeCodes = codes + (before - first) * keyStride;
+					uint16_t const* afterCodes = codes + (after - first) * keyStride;
+
+					for (size_t k = 0; k < width; k++) {
+						double min = ranges[k * 4];
+						double step = ranges[k * 4 + 1];
+						double v0 = min + Code(beforeCodes, k, words) * step;
+						double v1 = min + Code(from, k, words) * step;
+						double v2 = min + Code(to, k, words) * step;
+						double v3 = min + Code(afterCodes, k, words) * step;
+
+						value[k] = weights[0] * v1 + weights[1] * v2 + weights[2] * ((v2 - v0) / spanFrom) + weights[3] * ((v3 - v1) / spanTo);
+					}
+				}
+			}
+
+			if (track == 1) {
+				double length = std::sqrt(value[0] * value[0] + value[1] * value[1] + value[2] * value[2] + value[3] * value[3]);
+				double inverse = length > 0 ? 1.0 / length : 0.0;
+
+				for (size_t k = 0; k < 4; k++) {
+					value[k] *= inverse;
+				}
+			}
+
+			for (size_t k = 0; k < width; k++) {
+				columns[k][b] = value[k];
+			}
+		}
+	}
+
+	void CompressedAnimationCursor::Reset() {
+		animation = nullptr;
+	}
+}
@@ -0,0 +1,115 @@
+#ifndef _COMPRESSEDANIMATION_H_
+#define _COMPRESSEDANIMATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AnimationPose.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	//Dense samples of one bone, one per frame. Each array is either empty (the identity) or FrameCount long.
+	struct AnimationBoneSamples {
+		std::vector<Vector3> Translations;
+		std::vector<Quaternion> Rotations;
+		std::vector<Vector3> Scales;
+	};
+
+	enum class AnimationCurveFit {
+		//Keys store values and tangents, interpolated as cubic Hermite segments.
+		Hermite,
+		/*
+		 Keys store values only. Tangents are those of a Catmull-Rom spline through the neighbouring keys,
+		 scaled to the spacing of the keys (with evenly spaced keys, the curve is MathHelper::CatmullRom).
+		*/
+		CatmullRom
+	};
+
+	struct AnimationCompressionSettings {
+		AnimationCurveFit Fit{ AnimationCurveFit::Hermite };
+		//Largest Vector3::Distance from the source samples.
+		double TranslationTolerance{ 0.001 };
+		double ScaleTolerance{ 0.001 };
+		//Largest angle, in radians, between the source and the decompressed rotations.
+		double RotationTolerance{ 0.001 };
+	};
+
+	class CompressedAnimation;
+
+	//Current key of every track of every bone, so that playing forward skips the search for it.
+	class CompressedAnimationCursor {
+	public:
+		//Makes the next sample search every key.
+		void Reset();
+
+	private:
+		friend class CompressedAnimation;
+
+		CompressedAnimation const* animation{ nullptr };
+		double frame{ 0 };
+		std::vector<uint32_t> keys[3];
+	};
+
+	/*
+	 Keyframe reduced and quantized animation. Compress keeps, per track, only the frames needed for the
+	 curve through them to stay within the tolerances of every source frame, and stores each key as its
+	 frame and 16 bit components (and tangents with Hermite fitting) over the range of its track, or 32
+	 bit ones for a track whose range is too wide for its tolerance at 16 bits. Rotations are interpolated
+	 component wise and normalized, the samples being first moved onto the hemisphere of their predecessor.
+
+	 Sample decompresses the frame at a time for every bone: the segment of each track (stepped to from the
+	 cursor key when playing forward, otherwise found by a binary search over the 16 bit frames), then one
+	 curve evaluation.
+	*/
+	class CompressedAnimation {
+	public:
+		static constexpr size_t MaxFrameCount = 65536;
+
+		/*
+		 Returns false if frameRate is not positive, there are more than MaxFrameCount frames, an array of
+		 samples is neither empty nor as long as the longest one, or a track cannot be quantized within its
+		 tolerance even with 32 bit components.
+		*/
+		static bool Compress(std::vector<AnimationBoneSamples> const& bones, double frameRate,
+			AnimationCompressionSettings const& settings, CompressedAnimation& result);
+
+		size_t BoneCount() const;
+		size_t FrameCount() const;
+		double FrameRate() const;
+		double Duration() const;
+		//Keys kept over all bones and tracks.
+		size_t KeyCount() const;
+		//Bytes of key data, ranges and offsets.
+		size_t ByteSize() const;
+
+		//Pose at 'time' in seconds, clamped to the frames, resizing pose to BoneCount().
+		void Sample(double time, AnimationPose& pose) const;
+		void Sample(double time, CompressedAnimationCursor& cursor, AnimationPose& pose) const;
+
+	private:
+		struct Track {
+			//Keys of bone b are First[b] to First[b + 1] - 1.
+			std::vector<uint32_t> First;
+			std::vector<uint16_t> Frames;
+			//Width components per key, then, with Hermite fitting, Width tangents per key.
+			std::vector<uint16_t> Values;
+			//Index in Values of the first key of each bone, and the words per component of its keys (1 or 2).
+			std::vector<uint32_t> Offsets;
+			std::vector<uint8_t> Words;
+			//Per bone and component: value minimum and step, tangent minimum and step.
+			std::vector<double> Ranges;
+		};
+
+		AnimationCurveFit fit{ AnimationCurveFit::Hermite };
+		size_t boneCount{ 0 };
+		size_t frameCount{ 0 };
+		double frameRate{ 30 };
+		Track tracks[3];
+
+		void SampleTrack(size_t track, double frame, bool forward, uint32_t* cursor, AnimationPose& pose) const;
+	};
+}
+
+#endif
@@ -0,0 +1,431 @@
+#include <atomic>
+#include "ContentReader.hpp"
+#include "Lz4DecoderStream.hpp"
+#include "LzxDecoder.hpp"
+#include "Parallel.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XNA_CONTENT_SSE2
+#endif
+
+namespace Xna {
+
+	void ConvertSingles(uint8_t const* source, double* destination, size_t count) {
+		size_t i = 0;
+
+#ifdef XNA_CONTENT_SSE2
+		for (; i + 4 <= count; i += 4) {
+			__m128 singles = _mm_loadu_ps(reinterpret_cast<float const*>(source + i * 4));
+			_mm_storeu_pd(destination + i, _mm_cvtps_pd(singles));
+			_mm_storeu_pd(destination + i + 2, _mm_cvtps_pd(_mm_movehl_ps(singles, singles)));
+		}
+#endif
+
+		for (; i < count; i++) {
+			float value;
+			std::memcpy(&value, source + i * 4, 4);
+			destination[i] = value;
+		}
+	}
+
+	ContentReader::ContentReader() {}
+
+	bool ContentReader::Open(std::string const& path) {
+		Close();
+
+		if (!file.Open(path)) {
+			return false;
+		}
+
+		if (!ReadHeader(file.Data(), file.Size())) {
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ContentReader::Open(uint8_t const* buffer, size_t size) {
+		Close();
+
+		if (buffer == nullptr || !ReadHeader(buffer, size)) {
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	size_t ContentReader::OpenFiles(std::vector<std::string> const& paths, std::vector<ContentReader>& readers) {
+		std::atomic<size_t> opened{ 0 };
+
+		readers.clear();
+		readers.resize(paths.size());
+
+		Parallel::For(0, paths.size(), 1, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) {
+				if (readers[i].Open(paths[i])) {
+					opened++;
+				}
+			}
+		});
+
+		return opened.load();
+	}
+
+	void ContentReader::Close() {
+		file.Close();
+		content.clear();
+		content.shrink_to_fit();
+		data = nullptr;
+		length = 0;
+		position = 0;
+		platform = 0;
+		version = 0;
+		flags = 0;
+		typeReaders.clear();
+		sharedResourceCount = 0;
+	}
+
+	bool ContentReader::ReadHeader(uint8_t const* buffer, size_t size) {
+		if (size < HeaderSize
+			|| buffer[0] != 'X' || buffer[1] != 'N' || buffer[2] != 'B') {
+			return false;
+		}
+
+		platform = static_cast<char>(buffer[3]);
+		version = buffer[4];
+		flags = buffer[5];
+
+		if (version != 5 && version != 4) {
+			return false;
+		}
+
+		uint32_t xnbLength;
+		std::memcpy(&xnbLength, buffer + 6, 4);
+
+		if (xnbLength < HeaderSize || xnbLength > size) {
+			return false;
+		}
+
+		if (!IsCompressed()) {
+			data = buffer + HeaderSize;
+			length = xnbLength - HeaderSize;
+			position = 0;
+
+			return true;
+		}
+
+		//Compressed content is followed by its decompressed size.
+		if (xnbLength < HeaderSize + 4) {
+			return false;
+		}
+
+		uint32_t decompressedSize;
+		std::memcpy(&decompressedSize, buffer + HeaderSize, 4);
+
+		uint8_t const* compressed = buffer + HeaderSize + 4;
+		size_t compressedSize = xnbLength - HeaderSize - 4;
+
+		/*
+		 Rejects sizes the compressed data cannot expand to before allocating them. An LZ4 byte
+		 produces at most 255 bytes, and an LZX frame of at most 32KB (64KB for the 0xFF frames,
+		 with twice the header) needs at least a 2 byte header and a 1 byte block.
+		*/
+		uint64_t maxSize = (flags & ContentCompressedLzx) != 0
+			? static_cast<uint64_t>(compressedSize / 3) * 0x8000
+			: static_cast<uint64_t>(compressedSize) * 255;
+
+		if (decompressedSize > maxSize) {
+			return false;
+		}
+
+		content.resize(decompressedSize);
+
+		if ((flags & ContentCompressedLzx) != 0) {
+			LzxDecoderStream stream(compressed, compressedSize);
+
+			if (stream.Read(content.data(), content.size()) != content.size()) {
+				return false;
+			}
+		}
+		else if (!Lz4DecoderStream::Decode(compressed, compressedSize, content.data(), content.size())) {
+			return false;
+		}
+
+		data = content.data();
+		length = content.size();
+		position = 0;
+
+		return true;
+	}
+
+	char ContentReader::TargetPlatform() const {
+		return platform;
+	}
+
+	uint8_t ContentReader::Version() const {
+		return version;
+	}
+
+	uint8_t ContentReader::Flags() const {
+		return flags;
+	}
+
+	bool ContentReader::IsCompressed() const {
+		return (flags & (ContentCompressedLzx | ContentCompressedLz4)) != 0;
+	}
+
+	bool ContentReader::ReadManifest() {
+		int32_t count;
+		if (!Read7BitEncodedInt(count) || count < 0) {
+			return false;
+		}
+
+		//Every entry takes at least the length of its name and its version.
+		if (static_cast<size_t>(count) > (length - position) / 5) {
+			return false;
+		}
+
+		typeReaders.clear();
+		typeReaders.reserve(static_cast<size_t>(count));
+
+		for (int32_t i = 0; i < count; i++) {
+			ContentTypeReaderInfo info;
+			if (!ReadString(info.Name) || !ReadInt32(info.Version)) {
+				return false;
+			}
+
+			typeReaders.push_back(info);
+		}
+
+		return Read7BitEncodedInt(sharedResourceCount) && sharedResourceCount >= 0;
+	}
+
+	std::vector<ContentTypeReaderInfo> const& ContentReader::TypeReaders() const {
+		return typeReaders;
+	}
+
+	int32_t ContentReader::SharedResourceCount() const {
+		return sharedResourceCount;
+	}
+
+	size_t ContentReader::Position() const {
+		return position;
+	}
+
+	size_t ContentReader::Length() const {
+		return length;
+	}
+
+	bool ContentReader::Seek(size_t pos) {
+		if (pos > length) {
+			return false;
+		}
+
+		position = pos;
+		return true;
+	}
+
+	bool ContentReader::Skip(size_t count) {
+		if (count > length - position) {
+			return false;
+		}
+
+		position += count;
+		return true;
+	}
+
+	bool ContentReader::ReadBytes(size_t count, uint8_t const*& bytes) {
+		if (count > length - position) {
+			return false;
+		}
+
+		bytes = data + position;
+		position += count;
+		return true;
+	}
+
+	bool ContentReader::ReadByte(uint8_t& value) {
+		if (position >= length) {
+			return false;
+		}
+
+		value = data[position++];
+		return true;
+	}
+
+	bool ContentReader::ReadBoolean(bool& value) {
+		uint8_t byte;
+		if (!ReadByte(byte)) {
+			return false;
+		}
+
+		value = byte != 0;
+		return true;
+	}
+
+	bool ContentReader::ReadInt32(int32_t& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(4, bytes)) {
+			return false;
+		}
+
+		std::memcpy(&value, bytes, 4);
+		return true;
+	}
+
+	bool ContentReader::ReadUInt32(uint32_t& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(4, bytes)) {
+			return false;
+		}
+
+		std::memcpy(&value, bytes, 4);
+		return true;
+	}
+
+	bool ContentReader::ReadSingle(float& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(4, bytes)) {
+			return false;
+		}
+
+		std::memcpy(&value, bytes, 4);
+		return true;
+	}
+
+	bool ContentReader::ReadDouble(double& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(8, bytes)) {
+			return false;
+		}
+
+		std::memcpy(&value, bytes, 8);
+		return true;
+	}
+
+	bool ContentReader::Read7BitEncodedInt(int32_t& value) {
+		uint32_t result = 0;
+
+		for (int shift = 0; shift < 35; shift += 7) {
+			uint8_t byte;
+			if (!ReadByte(byte)) {
+				return false;
+			}
+
+			result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+
+			if ((byte & 0x80) == 0) {
+				value = static_cast<int32_t>(result);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool ContentReader::ReadString(std::string& value) {
+		int32_t count;
+		uint8_t const* bytes;
+
+		if (!Read7BitEncodedInt(count) || count < 0
+			|| !ReadBytes(static_cast<size_t>(count), bytes)) {
+			return false;
+		}
+
+		value.assign(reinterpret_cast<char const*>(bytes), static_cast<size_t>(count));
+		return true;
+	}
+
+	bool ContentReader::ReadVector2(Vector2& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(ContentElement<Vector2>::Size, bytes)) {
+			return false;
+		}
+
+		value = ContentArray<Vector2>(bytes, 1)[0];
+		return true;
+	}
+
+	bool ContentReader::ReadVector3(Vector3& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(ContentElement<Vector3>::Size, bytes)) {
+			return false;
+		}
+
+		value = ContentArray<Vector3>(bytes, 1)[0];
+		return true;
+	}
+
+	bool ContentReader::ReadVector4(Vector4& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(ContentElement<Vector4>::Size, bytes)) {
+			return false;
+		}
+
+		value = ContentArray<Vector4>(bytes, 1)[0];
+		return true;
+	}
+
+	bool ContentReader::ReadQuaternion(Quaternion& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(ContentElement<Quaternion>::Size, bytes)) {
+			return false;
+		}
+
+		value = ContentArray<Quaternion>(bytes, 1)[0];
+		return true;
+	}
+
+	bool ContentReader::ReadMatrix(Matrix& value) {
+		uint8_t const* bytes;
+		if (!ReadBytes(ContentElement<Matrix>::Size, bytes)) {
+			return false;
+		}
+
+		value = ContentArray<Matrix>(bytes, 1)[0];
+		return true;
+	}
+
+	bool ContentReader::ReadPoint(Point& value) {
+		return ReadInt32(value.X)
+			&& ReadInt32(value.Y);
+	}
+
+	bool ContentReader::ReadRectangle(Rectangle& value) {
+		return ReadInt32(value.X)
+			&& ReadInt32(value.Y)
+			&& ReadInt32(value.Width)
+			&& ReadInt32(value.Height);
+	}
+
+	bool ContentReader::ReadVertexBuffer(VertexBufferContent& buffer) {
+		int32_t elementCount;
+
+		if (!ReadInt32(buffer.VertexStride) || buffer.VertexStride <= 0
+			|| !ReadInt32(elementCount) || elementCount < 0
+			|| static_cast<size_t>(elementCount) > (length - position) / 16) {
+			return false;
+		}
+
+		buffer.Elements.resize(static_cast<size_t>(elementCount));
+
+		for (VertexElementContent& element : buffer.Elements) {
+			if (!ReadInt32(element.Offset)
+				|| !ReadInt32(element.Format)
+				|| !ReadInt32(element.Usage)
+				|| !ReadInt32(element.UsageIndex)) {
+				return false;
+			}
+
+			if (element.Offset < 0 || element.Offset >= buffer.VertexStride) {
+				return false;
+			}
+		}
+
+		return ReadUInt32(buffer.VertexCount)
+			&& ReadBytes(static_cast<size_t>(buffer.VertexCount) * static_cast<size_t>(buffer.VertexStride), buffer.Data);
+	}
+}
@@ -0,0 +1,277 @@
+#ifndef _CONTENTREADER_H_
+#define _CONTENTREADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "MappedFile.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+#include "Quaternion.hpp"
+#include "Matrix.hpp"
+#include "Point.hpp"
+#include "Rectangle.hpp"
+
+namespace Xna {
+
+	/*
+	 On-disk layout of the math types inside an .xnb file.
+	 Vectors, quaternions and matrices are stored as 32-bit floats and are widened to double when read.
+	 Point and Rectangle are stored as int32, the same layout Xna++ uses, so they can be read in place.
+	*/
+	template <typename T> struct ContentElement;
+
+	template <> struct ContentElement<Vector2> {
+		static constexpr size_t Singles = 2;
+		static constexpr size_t Size = Singles * 4;
+		static constexpr bool Native = false;
+	};
+
+	template <> struct ContentElement<Vector3> {
+		static constexpr size_t Singles = 3;
+		static constexpr size_t Size = Singles * 4;
+		static constexpr bool Native = false;
+	};
+
+	template <> struct ContentElement<Vector4> {
+		static constexpr size_t Singles = 4;
+		static constexpr size_t Size = Singles * 4;
+		static constexpr bool Native = false;
+	};
+
+	template <> struct ContentElement<Quaternion> {
+		static constexpr size_t Singles = 4;
+		static constexpr size_t Size = Singles * 4;
+		static constexpr bool Native = false;
+	};
+
+	template <> struct ContentElement<Matrix> {
+		static constexpr size_t Singles = 16;
+		static constexpr size_t Size = Singles * 4;
+		static constexpr bool Native = false;
+	};
+
+	template <> struct ContentElement<Point> {
+		static constexpr size_t Singles = 0;
+		static constexpr size_t Size = 8;
+		static constexpr bool Native = true;
+	};
+
+	template <> struct ContentElement<Rectangle> {
+		static constexpr size_t Singles = 0;
+		static constexpr size_t Size = 16;
+		static constexpr bool Native = true;
+	};
+
+	//Widens 'count' packed floats (no alignment required) into doubles.
+	void ConvertSingles(uint8_t const* source, double* destination, size_t count);
+
+	//Zero-copy view over an array of elements stored in the content buffer.
+	template <typename T>
+	class ContentArray {
+	public:
+		ContentArray() {}
+		ContentArray(uint8_t const* data, size_t count, size_t stride = ContentElement<T>::Size) :
+			data(data), count(count), stride(stride) {}
+
+		size_t Count() const { return count; }
+		size_t Stride() const { return stride; }
+		uint8_t const* Data() const { return data; }
+
+		//True when the elements can be used directly through Elements().
+		bool IsZeroCopy() const {
+			return ContentElement<T>::Native
+				&& stride == sizeof(T)
+				&& reinterpret_cast<uintptr_t>(data) % alignof(T) == 0;
+		}
+
+		//Returns nullptr if the on-disk layout differs from T; use operator[] or CopyTo in that case.
+		T const* Elements() const {
+			return IsZeroCopy() ? reinterpret_cast<T const*>(data) : nullptr;
+		}
+
+		T operator[](size_t index) const {
+			T value;
+			Decode(data + index * stride, value);
+			return value;
+		}
+
+		bool CopyTo(std::vector<T>& destination, size_t destIndex = 0) const {
+			if (destination.size() < destIndex + count) {
+				return false;
+			}
+
+			CopyTo(destination.data() + destIndex);
+			return true;
+		}
+
+		void CopyTo(T* destination) const {
+			if (ContentElement<T>::Native) {
+				if (stride == sizeof(T)) {
+					std::memcpy(destination, data, count * sizeof(T));
+					return;
+				}
+			}
+			else if (stride == ContentElement<T>::Size) {
+				static_assert(ContentElement<T>::Native || sizeof(T) == ContentElement<T>::Singles * sizeof(double),
+					"Float content types must be made only of doubles.");
+				ConvertSingles(data, reinterpret_cast<double*>(destination), count * ContentElement<T>::Singles);
+				return;
+			}
+
+			for (size_t i = 0; i < count; i++) {
+				Decode(data + i * stride, destination[i]);
+			}
+		}
+
+	private:
+		uint8_t const* data{ nullptr };
+		size_t count{ 0 };
+		size_t stride{ ContentElement<T>::Size };
+
+		static void Decode(uint8_t const* bytes, T& value) {
+			if (ContentElement<T>::Native) {
+				std::memcpy(&value, bytes, sizeof(T));
+			}
+			else {
+				ConvertSingles(bytes, reinterpret_cast<double*>(&value), ContentElement<T>::Singles);
+			}
+		}
+	};
+
+	struct ContentTypeReaderInfo {
+		std::string Name;
+		int32_t Version{ 0 };
+	};
+
+	struct VertexElementContent {
+		int32_t Offset{ 0 };
+		int32_t Format{ 0 };
+		int32_t Usage{ 0 };
+		int32_t UsageIndex{ 0 };
+	};
+
+	//VertexElementFormat values used by the MonoGame content pipeline.
+	enum class VertexElementFormatContent : int32_t {
+		Single = 0,
+		Vector2 = 1,
+		Vector3 = 2,
+		Vector4 = 3,
+		Color = 4,
+	};
+
+	struct VertexBufferContent {
+		int32_t VertexStride{ 0 };
+		std::vector<VertexElementContent> Elements;
+		uint32_t VertexCount{ 0 };
+		//Points into the content buffer, VertexCount * VertexStride bytes.
+		uint8_t const* Data{ nullptr };
+
+		//Strided view over one element of every vertex, e.g. Channel<Vector3>(positionOffset).
+		//Empty if the element does not fit in the vertex at 'offset'.
+		template <typename T>
+		ContentArray<T> Channel(int32_t offset) const {
+			if (offset < 0 || VertexStride < 0
+				|| static_cast<size_t>(offset) + ContentElement<T>::Size > static_cast<size_t>(VertexStride)) {
+				return ContentArray<T>();
+			}
+
+			return ContentArray<T>(Data + offset, VertexCount, static_cast<size_t>(VertexStride));
+		}
+	};
+
+	/*
+	 Reads .xnb content directly from a memory-mapped file.
+	 Compressed (LZX or LZ4) content is decompressed once into a buffer owned by the reader.
+	 As with the other batch methods in this library, the read methods return false instead of
+	 throwing when the data is invalid or the end of the buffer is reached.
+	*/
+	class ContentReader {
+	public:
+		static constexpr uint8_t ContentCompressedLzx = 0x80;
+		static constexpr uint8_t ContentCompressedLz4 = 0x40;
+		static constexpr size_t HeaderSize = 10;
+
+		ContentReader();
+
+		//Maps the file, validates the XNB header and decompresses the content if needed.
+		bool Open(std::string const& path);
+		//Reads from a caller-owned buffer that must outlive the reader.
+		bool Open(uint8_t const* data, size_t size);
+		void Close();
+
+		//Opens every file on its own thread, since compressed content can only be decoded serially.
+		//Returns the number of files opened; failed readers are left closed.
+		static size_t OpenFiles(std::vector<std::string> const& paths, std::vector<ContentReader>& readers);
+
+		char TargetPlatform() const;
+		uint8_t Version() const;
+		uint8_t Flags() const;
+		bool IsCompressed() const;
+
+		//Reads the type reader list and the shared resource count that precede the primary object.
+		bool ReadManifest();
+		std::vector<ContentTypeReaderInfo> const& TypeReaders() const;
+		int32_t SharedResourceCount() const;
+
+		//Position and length are relative to the start of the (decompressed) content, after the header.
+		size_t Position() const;
+		size_t Length() const;
+		bool Seek(size_t position);
+		bool Skip(size_t count);
+
+		bool ReadBytes(size_t count, uint8_t const*& bytes);
+		bool ReadByte(uint8_t& value);
+		bool ReadBoolean(bool& value);
+		bool ReadInt32(int32_t& value);
+		bool ReadUInt32(uint32_t& value);
+		bool ReadSingle(float& value);
+		bool ReadDouble(double& value);
+		bool Read7BitEncodedInt(int32_t& value);
+		bool ReadString(std::string& value);
+
+		bool ReadVector2(Vector2& value);
+		bool ReadVector3(Vector3& value);
+		bool ReadVector4(Vector4& value);
+		bool ReadQuaternion(Quaternion& value);
+		bool ReadMatrix(Matrix& value);
+		bool ReadPoint(Point& value);
+		bool ReadRectangle(Rectangle& value);
+
+		//Reads an array written by ArrayWriter<T> (uint32 count followed by the elements) without copying.
+		template <typename T>
+		bool ReadArray(ContentArray<T>& array) {
+			uint32_t count;
+			uint8_t const* bytes;
+
+			if (!ReadUInt32(count)
+				|| !ReadBytes(static_cast<size_t>(count) * ContentElement<T>::Size, bytes)) {
+				return false;
+			}
+
+			array = ContentArray<T>(bytes, count);
+			return true;
+		}
+
+		bool ReadVertexBuffer(VertexBufferContent& buffer);
+
+	private:
+		MappedFile file;
+		std::vector<uint8_t> content;
+		uint8_t const* data{ nullptr };
+		size_t length{ 0 };
+		size_t position{ 0 };
+		char platform{ 0 };
+		uint8_t version{ 0 };
+		uint8_t flags{ 0 };
+		std::vector<ContentTypeReaderInfo> typeReaders;
+		int32_t sharedResourceCount{ 0 };
+
+		bool ReadHeader(uint8_t const* buffer, size_t size);
+	};
+}
+
+#endif
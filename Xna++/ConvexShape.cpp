@@ -0,0 +1,174 @@
+#include <cmath>
+#include <limits>
+#include "ConvexShape.hpp"
+#include "Simd.hpp"
+
+namespace Xna {
+
+	//Largest x * dx + y * dy + z * dz per lane from i to last, and its first index; i is left after the last full group of T::Width points.
+	template <typename T>
+	static void ScanPoints(double const* x, double const* y, double const* z, size_t& i, size_t last,
+		Vector3 const& direction, double* bestValue, double* bestIndex) {
+
+		T dx = T::Set(direction.X);
+		T dy = T::Set(direction.Y);
+		T dz = T::Set(direction.Z);
+		T value = T::Load(bestValue);
+		T index = T::Load(bestIndex);
+		T step = T::Set(static_cast<double>(T::Width));
+
+		double lanes[T::Width];
+		for (size_t l = 0; l < T::Width; l++) {
+			lanes[l] = static_cast<double>(i + l);
+		}
+
+		T current = T::Load(lanes);
+
+		for (; i + T::Width <= last; i += T::Width) {
+			T dot = T::Load(x + i) * dx + T::Load(y + i) * dy + T::Load(z + i) * dz;
+			typename T::Mask better = dot > value;
+			value = T::Select(better, dot, value);
+			index = T::Select(better, current, index);
+			current = current + step;
+		}
+
+		value.Store(bestValue);
+		index.Store(bestIndex);
+	}
+
+	ConvexShape::ConvexShape() :
+		pointX(1), pointY(1), pointZ(1) {}
+
+	ConvexShape ConvexShape::CreateHull(std::vector<Vector3> const& points) {
+		ConvexShape shape;
+
+		if (points.empty()) {
+			return shape;
+		}
+
+		shape.pointX.resize(points.size());
+		shape.pointY.resize(points.size());
+		shape.pointZ.resize(points.size());
+
+		for (size_t i = 0; i < points.size(); i++) {
+			shape.pointX[i] = points[i].X;
+			shape.pointY[i] = points[i].Y;
+			shape.pointZ[i] = points[i].Z;
+		}
+
+		return shape;
+	}
+
+	ConvexShape ConvexShape::CreateBox(Vector3 const& halfExtent) {
+		std::vector<Vector3> corners;
+
+		for (int32_t i = 0; i < 8; i++) {
+			corners.push_back(Vector3(
+				(i & 1) ? halfExtent.X : -halfExtent.X,
+				(i & 2) ? halfExtent.Y : -halfExtent.Y,
+				(i & 4) ? halfExtent.Z : -halfExtent.Z));
+		}
+
+		return CreateHull(corners);
+	}
+
+	ConvexShape ConvexShape::CreateCapsule(double halfHeight, double radius) {
+		ConvexShape shape;
+		shape.type = ConvexShapeType::Capsule;
+		shape.pointX.clear();
+		shape.pointY.clear();
+		shape.pointZ.clear();
+		shape.halfHeight = halfHeight < 0 ? 0 : halfHeight;
+		shape.radius = radius < 0 ? 0 : radius;
+
+		return shape;
+	}
+
+	ConvexShape ConvexShape::CreateSphere(double radius) {
+		return CreateCapsule(0, radius);
+	}
+
+	ConvexShapeType ConvexShape::Type() const {
+		return type;
+	}
+
+	size_t ConvexShape::PointCount() const {
+		return pointX.size();
+	}
+
+	double ConvexShape::HalfHeight() const {
+		return halfHeight;
+	}
+
+	double ConvexShape::Radius() const {
+		return radius;
+	}
+
+	Vector3 ConvexShape::Support(Vector3 const& direction) const {
+		Quaternion inverse(-Orientation.X, -Orientation.Y, -Orientation.Z, Orientation.W);
+		Vector3 local = LocalSupport(Vector3::Transform(direction, inverse));
+
+		return Vector3::Transform(local, Orientation) + Position;
+	}
+
+	Vector3 ConvexShape::CoreSupport(Vector3 const& direction) const {
+		if (type != ConvexShapeType::Capsule) {
+			return Support(direction);
+		}
+
+		Vector3 axis = Vector3::Transform(Vector3(0, halfHeight, 0), Orientation);
+		return Vector3::Dot(direction, axis) < 0 ? Position - axis : Position + axis;
+	}
+
+	Vector3 ConvexShape::LocalSupport(Vector3 const& direction) const {
+		if (type == ConvexShapeType::Capsule) {
+			Vector3 point(0, direction.Y < 0 ? -halfHeight : halfHeight, 0);
+			double length = std::sqrt(direction.X * direction.X + direction.Y * direction.Y + direction.Z * direction.Z);
+
+			if (length > 0) {
+				point += direction * (radius / length);
+			}
+
+			return point;
+		}
+
+		for (size_t i = 0; i < cacheCount; i++) {
+			Vector3 const& cached = cache[i].Direction;
+
+			if (cached.X == direction.X && cached.Y == direction.Y && cached.Z == direction.Z) {
+				return cache[i].Point;
+			}
+		}
+
+		size_t index = FarthestPoint(direction);
+		Vector3 point(pointX[index], pointY[index], pointZ[index]);
+
+		cache[cacheNext] = CacheEntry{ direction, point };
+		cacheNext = (cacheNext + 1) % CacheSize;
+
+		if (cacheCount < CacheSize) {
+			cacheCount++;
+		}
+
+		return point;
+	}
+
+	size_t ConvexShape::FarthestPoint(Vector3 const& direction) const {
+		size_t count = pointX.size();
+		size_t i = 0;
+		double lowest = -std::numeric_limits<double>::infinity();
+		double bestValue[2] = { lowest, lowest };
+		double bestIndex[2] = { 0, 0 };
+
+#ifdef XNA_SIMD_SSE2
+		ScanPoints<Simd::Pair>(pointX.data(), pointY.data(), pointZ.data(), i, count, direction, bestValue, bestIndex);
+#endif
+		ScanPoints<Simd::Scalar>(pointX.data(), pointY.data(), pointZ.data(), i, count, direction, bestValue, bestIndex);
+
+		if (bestValue[1] > bestValue[0] || (bestValue[1] == bestValue[0] && bestIndex[1] < bestIndex[0])) {
+			return static_cast<size_t>(bestIndex[1]);
+		}
+
+		return static_cast<size_t>(bestIndex[0]);
+	}
+}
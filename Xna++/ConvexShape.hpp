@@ -0,0 +1,74 @@
+#ifndef _CONVEXSHAPE_H_
+#define _CONVEXSHAPE_H_
+
+#include <cstddef>
+#include <vector>
+#include "Vector3.hpp"
+#include "Quaternion.hpp"
+
+namespace Xna {
+
+	enum class ConvexShapeType {
+		Hull,
+		Capsule
+	};
+
+	/*
+	 Convex shape given by its support function, for Gjk. A hull is the convex hull of its points
+	 (which need not all be on the hull); a capsule is a segment along the local Y axis, from -HalfHeight
+	 to HalfHeight, inflated by Radius. Position and Orientation place the shape in the world.
+
+	 Hull supports go through a small cache of the last local directions, so a query repeated along the
+	 same directions (e.g. a warm started Gjk query while the shape only translates) does not scan the
+	 points again. The cache makes Support non thread safe on a given shape.
+	*/
+	class ConvexShape {
+	public:
+		Vector3 Position;
+		Quaternion Orientation{ 0, 0, 0, 1 };
+
+		//A single point at the origin.
+		ConvexShape();
+
+		static ConvexShape CreateHull(std::vector<Vector3> const& points);
+		static ConvexShape CreateBox(Vector3 const& halfExtent);
+		static ConvexShape CreateCapsule(double halfHeight, double radius);
+		//A capsule of height 0.
+		static ConvexShape CreateSphere(double radius);
+
+		ConvexShapeType Type() const;
+		size_t PointCount() const;
+		double HalfHeight() const;
+		double Radius() const;
+
+		//Farthest point of the shape along direction, in world space. direction need not be normalized.
+		Vector3 Support(Vector3 const& direction) const;
+		//Same in the frame of the shape.
+		Vector3 LocalSupport(Vector3 const& direction) const;
+		//Support without Radius: of the segment of a capsule, the center of a sphere. The same as Support for hulls.
+		Vector3 CoreSupport(Vector3 const& direction) const;
+
+	private:
+		static constexpr size_t CacheSize = 4;
+
+		struct CacheEntry {
+			Vector3 Direction;
+			Vector3 Point;
+		};
+
+		ConvexShapeType type{ ConvexShapeType::Hull };
+		std::vector<double> pointX;
+		std::vector<double> pointY;
+		std::vector<double> pointZ;
+		double halfHeight{ 0 };
+		double radius{ 0 };
+
+		mutable CacheEntry cache[CacheSize];
+		mutable size_t cacheCount{ 0 };
+		mutable size_t cacheNext{ 0 };
+
+		size_t FarthestPoint(Vector3 const& direction) const;
+	};
+}
+
+#endif
@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Curve.hpp"
+
+namespace Xna {
+
+	//Hermite segment between two keys, for prev.Position <= position <= next.Position.
+	static double Segment(CurveKey const& prev, CurveKey const& next, double position) {
+		if (prev.Continuity == CurveContinuity::Step) {
+			if (position >= 1.0) {
+				return next.Value;
+			}
+
+			return prev.Value;
+		}
+
+		double t = (position - prev.Position) / (next.Position - prev.Position);
+		double ts = t * t;
+		double tss = ts * t;
+
+		return (2 * tss - 3 * ts + 1.0) * prev.Value + (tss - 2 * ts + t) * prev.TangentOut
+			+ (3 * ts - 2 * tss) * next.Value + (tss - ts) * next.TangentIn;
+	}
+
+	CurveKey::CurveKey() {}
+	CurveKey::CurveKey(double position, double value) :
+		Position(position), Value(value) {}
+	CurveKey::CurveKey(double position, double value, double tangentIn, double tangentOut) :
+		Position(position), Value(value), TangentIn(tangentIn), TangentOut(tangentOut) {}
+	CurveKey::CurveKey(double position, double value, double tangentIn, double tangentOut, CurveContinuity continuity) :
+		Position(position), Value(value), TangentIn(tangentIn), TangentOut(tangentOut), Continuity(continuity) {}
+
+	bool operator== (CurveKey const& k1, CurveKey const& k2) {
+		return k1.Position == k2.Position
+			&& k1.Value == k2.Value
+			&& k1.TangentIn == k2.TangentIn
+			&& k1.TangentOut == k2.TangentOut
+			&& k1.Continuity == k2.Continuity;
+	}
+
+	bool operator!= (CurveKey const& k1, CurveKey const& k2) {
+		return !(k1 == k2);
+	}
+
+	bool CurveKey::Equals(CurveKey const& other) const {
+		return *this == other;
+	}
+
+	CurveKey const& CurveKeyCollection::operator[] (size_t index) const {
+		return keys[index];
+	}
+
+	size_t CurveKeyCollection::Count() const {
+		return keys.size();
+	}
+
+	void CurveKeyCollection::Add(CurveKey const& item) {
+		auto position = std::upper_bound(keys.begin(), keys.end(), item,
+			[](CurveKey const& k1, CurveKey const& k2) { return k1.Position < k2.Position; });
+
+		keys.insert(position, item);
+	}
+
+	void CurveKeyCollection::Set(size_t index, CurveKey const& item) {
+		if (index >= keys.size()) {
+			return;
+		}
+
+		if (keys[index].Position == item.Position) {
+			keys[index] = item;
+		}
+		else {
+			keys.erase(keys.begin() + index);
+			Add(item);
+		}
+	}
+
+	void CurveKeyCollection::Clear() {
+		keys.clear();
+	}
+
+	bool CurveKeyCollection::Contains(CurveKey const& item) const {
+		return IndexOf(item) >= 0;
+	}
+
+	int32_t CurveKeyCollection::IndexOf(CurveKey const& item) const {
+		for (size_t i = 0; i < keys.size(); i++) {
+			if (keys[i] == item) {
+				return static_cast<int32_t>(i);
+			}
+		}
+
+		return -1;
+	}
+
+	void CurveKeyCollection::RemoveAt(size_t index) {
+		if (index < keys.size()) {
+			keys.erase(keys.begin() + index);
+		}
+	}
+
+	bool CurveKeyCollection::Remove(CurveKey const& item) {
+		int32_t index = IndexOf(item);
+
+		if (index < 0) {
+			return false;
+		}
+
+		keys.erase(keys.begin() + index);
+		return true;
+	}
+
+	std::vector<CurveKey>::const_iterator CurveKeyCollection::begin() const {
+		return keys.begin();
+	}
+
+	std::vector<CurveKey>::const_iterator CurveKeyCollection::end() const {
+		return keys.end();
+	}
+
+	Curve::Curve() {}
+
+	bool Curve::IsConstant() const {
+		return Keys.Count() <= 1;
+	}
+
+	double Curve::Evaluate(double position) const {
+		if (Keys.Count() == 0) {
+			return 0.0;
+		}
+
+		if (Keys.Count() == 1) {
+			return Keys[0].Value;
+		}
+
+		CurveKey const& first = Keys[0];
+		CurveKey const& last = Keys[Keys.Count() - 1];
+
+		CurveLoopType loop;
+
+		if (position < first.Position) {
+			loop = PreLoop;
+
+			if (loop == CurveLoopType::Constant) {
+				return first.Value;
+			}
+
+			if (loop == CurveLoopType::Linear) {
+				return first.Value - first.TangentIn * (first.Position - position);
+			}
+		}
+		else if (position > last.Position) {
+			loop = PostLoop;
+
+			if (loop == CurveLoopType::Constant) {
+				return last.Value;
+			}
+
+			if (loop == CurveLoopType::Linear) {
+				return last.Value + first.TangentOut * (position - last.Position);
+			}
+		}
+		else {
+			return GetCurvePosition(position);
+		}
+
+		int32_t cycle = GetNumberOfCycle(position);
+		double length = last.Position - first.Position;
+		double virtualPos = position - (cycle * length);
+
+		switch (loop) {
+		case CurveLoopType::Cycle:
+			return GetCurvePosition(virtualPos);
+		case CurveLoopType::CycleOffset:
+			return GetCurvePosition(virtualPos) + cycle * (last.Value - first.Value);
+		default:
+			if (cycle % 2 != 0) {
+				virtualPos = last.Position - position + first.Position + (cycle * length);
+			}
+
+			return GetCurvePosition(virtualPos);
+		}
+	}
+
+	void Curve::Evaluate(double const* positions, double* destination, size_t count) const {
+		for (size_t i = 0; i < count; i++) {
+			destination[i] = Evaluate(positions[i]);
+		}
+	}
+
+	bool Curve::Sample(double start, double end, size_t count, std::vector<double>& destination) const {
+		if (count == 0) {
+			return false;
+		}
+
+		destination.resize(count);
+
+		double step = count > 1 ? (end - start) / static_cast<double>(count - 1) : 0.0;
+
+		if (Keys.Count() < 2 || step < 0) {
+			for (size_t i = 0; i < count; i++) {
+				destination[i] = Evaluate(start + step * static_cast<double>(i));
+			}
+
+			return true;
+		}
+
+		double first = Keys[0].Position;
+		double last = Keys[Keys.Count() - 1].Position;
+		size_t next = 1;
+
+		for (size_t i = 0; i < count; i++) {
+			double position = start + step * static_cast<double>(i);
+
+			if (position < first || position > last) {
+				destination[i] = Evaluate(position);
+				continue;
+			}
+
+			//Positions only grow, so the segment search resumes where the previous sample stopped.
+			while (Keys[next].Position < position) {
+				next++;
+			}
+
+			destination[i] = Segment(Keys[next - 1], Keys[next], position);
+		}
+
+		return true;
+	}
+
+	void Curve::ComputeTangents(CurveTangent tangentType) {
+		ComputeTangents(tangentType, tangentType);
+	}
+
+	void Curve::ComputeTangents(CurveTangent tangentInType, CurveTangent tangentOutType) {
+		for (size_t i = 0; i < Keys.Count(); i++) {
+			ComputeTangent(i, tangentInType, tangentOutType);
+		}
+	}
+
+	void Curve::ComputeTangent(size_t keyIndex, CurveTangent tangentType) {
+		ComputeTangent(keyIndex, tangentType, tangentType);
+	}
+
+	void Curve::ComputeTangent(size_t keyIndex, CurveTangent tangentInType, CurveTangent tangentOutType) {
+		if (keyIndex >= Keys.Count()) {
+			return;
+		}
+
+		CurveKey& key = Keys.keys[keyIndex];
+
+		double p0 = key.Position;
+		double p = key.Position;
+		double p1 = key.Position;
+		double v0 = key.Value;
+		double v = key.Value;
+		double v1 = key.Value;
+
+		if (keyIndex > 0) {
+			p0 = Keys[keyIndex - 1].Position;
+			v0 = Keys[keyIndex - 1].Value;
+		}
+
+		if (keyIndex < Keys.Count() - 1) {
+			p1 = Keys[keyIndex + 1].Position;
+			v1 = Keys[keyIndex + 1].Value;
+		}
+
+		double pn = p1 - p0;
+		bool degenerate = std::abs(pn) < std::numeric_limits<double>::denorm_min();
+
+		switch (tangentInType) {
+		case CurveTangent::Flat:
+			key.TangentIn = 0;
+			break;
+		case CurveTangent::Linear:
+			key.TangentIn = v - v0;
+			break;
+		case CurveTangent::Smooth:
+			key.TangentIn = degenerate ? 0 : (v1 - v0) * ((p - p0) / pn);
+			break;
+		}
+
+		switch (tangentOutType) {
+		case CurveTangent::Flat:
+			key.TangentOut = 0;
+			break;
+		case CurveTangent::Linear:
+			key.TangentOut = v1 - v;
+			break;
+		case CurveTangent::Smooth:
+			key.TangentOut = degenerate ? 0 : (v1 - v0) * ((p1 - p) / pn);
+			break;
+		}
+	}
+
+	int32_t Curve::GetNumberOfCycle(double position) const {
+		double cycle = (position - Keys[0].Position) / (Keys[Keys.Count() - 1].Position - Keys[0].Position);
+
+		if (cycle < 0.0) {
+			cycle--;
+		}
+
+		return static_cast<int32_t>(cycle);
+	}
+
+	double Curve::GetCurvePosition(double position) const {
+		for (size_t i = 1; i < Keys.Count(); i++) {
+			if (Keys[i].Position >= position) {
+				return Segment(Keys[i - 1], Keys[i], position);
+			}
+		}
+
+		return 0.0;
+	}
+}
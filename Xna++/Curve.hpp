@@ -0,0 +1,103 @@
+#ifndef _CURVE_H_
+#define _CURVE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Xna {
+
+	enum class CurveLoopType {
+		Constant,
+		Cycle,
+		CycleOffset,
+		Oscillate,
+		Linear
+	};
+
+	enum class CurveContinuity {
+		Smooth,
+		Step
+	};
+
+	enum class CurveTangent {
+		Flat,
+		Linear,
+		Smooth
+	};
+
+	class CurveKey {
+	public:
+		double Position{ 0 };
+		double Value{ 0 };
+		double TangentIn{ 0 };
+		double TangentOut{ 0 };
+		CurveContinuity Continuity{ CurveContinuity::Smooth };
+
+		CurveKey();
+		CurveKey(double position, double value);
+		CurveKey(double position, double value, double tangentIn, double tangentOut);
+		CurveKey(double position, double value, double tangentIn, double tangentOut, CurveContinuity continuity);
+
+		friend bool operator== (CurveKey const&, CurveKey const&);
+		friend bool operator!= (CurveKey const&, CurveKey const&);
+
+		bool Equals(CurveKey const& other) const;
+	};
+
+	//Keys sorted by position; a key added at an existing position goes after the ones already there.
+	class CurveKeyCollection {
+	public:
+		CurveKey const& operator[] (size_t index) const;
+
+		size_t Count() const;
+		void Add(CurveKey const& item);
+		//Replaces the key at index, moving it if its position changed.
+		void Set(size_t index, CurveKey const& item);
+		void Clear();
+		bool Contains(CurveKey const& item) const;
+		//-1 if not found.
+		int32_t IndexOf(CurveKey const& item) const;
+		void RemoveAt(size_t index);
+		bool Remove(CurveKey const& item);
+
+		std::vector<CurveKey>::const_iterator begin() const;
+		std::vector<CurveKey>::const_iterator end() const;
+
+	private:
+		friend class Curve;
+
+		std::vector<CurveKey> keys;
+	};
+
+	class Curve {
+	public:
+		CurveLoopType PreLoop{ CurveLoopType::Constant };
+		CurveLoopType PostLoop{ CurveLoopType::Constant };
+		CurveKeyCollection Keys;
+
+		Curve();
+
+		bool IsConstant() const;
+		double Evaluate(double position) const;
+		//destination[i] = Evaluate(positions[i]).
+		void Evaluate(double const* positions, double* destination, size_t count) const;
+		/*
+		 Samples the curve at 'count' evenly spaced positions from 'start' to 'end' inclusive,
+		 walking the keys once instead of searching them for every sample.
+		 Returns false if count is 0.
+		*/
+		bool Sample(double start, double end, size_t count, std::vector<double>& destination) const;
+
+		void ComputeTangents(CurveTangent tangentType);
+		void ComputeTangents(CurveTangent tangentInType, CurveTangent tangentOutType);
+		void ComputeTangent(size_t keyIndex, CurveTangent tangentType);
+		void ComputeTangent(size_t keyIndex, CurveTangent tangentInType, CurveTangent tangentOutType);
+
+	private:
+		int32_t GetNumberOfCycle(double position) const;
+		double GetCurvePosition(double position) const;
+	};
+}
+
+#endif
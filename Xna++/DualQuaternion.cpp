@@ -0,0 +1,212 @@
+#include <cmath>
+#include "DualQuaternion.hpp"
+
+namespace Xna {
+
+	//Below this sine of the half angle a screw is taken as a pure translation.
+	static constexpr double ScrewEpsilon = 1e-9;
+
+	DualQuaternion::DualQuaternion() {}
+
+	DualQuaternion::DualQuaternion(Quaternion const& real, Quaternion const& dual) :
+		Real(real), Dual(dual) {}
+
+	DualQuaternion::DualQuaternion(Quaternion const& rotation, Vector3 const& translation) :
+		Real(Quaternion::Normalize(rotation)) {
+		Dual = Quaternion::Multiply(Quaternion(translation.X, translation.Y, translation.Z, 0), Real) * 0.5;
+	}
+
+	DualQuaternion DualQuaternion::operator- () const {
+		return DualQuaternion(-Real, -Dual);
+	}
+
+	DualQuaternion operator+ (DualQuaternion const& d1, DualQuaternion const& d2) {
+		return DualQuaternion(d1.Real + d2.Real, d1.Dual + d2.Dual);
+	}
+
+	DualQuaternion operator- (DualQuaternion const& d1, DualQuaternion const& d2) {
+		return DualQuaternion(d1.Real - d2.Real, d1.Dual - d2.Dual);
+	}
+
+	DualQuaternion operator* (DualQuaternion const& d1, DualQuaternion const& d2) {
+		return DualQuaternion::Multiply(d1, d2);
+	}
+
+	DualQuaternion operator* (DualQuaternion const& d, double scale) {
+		return DualQuaternion(d.Real * scale, d.Dual * scale);
+	}
+
+	DualQuaternion operator* (double scale, DualQuaternion const& d) {
+		return d * scale;
+	}
+
+	bool operator== (DualQuaternion const& d1, DualQuaternion const& d2) {
+		return d1.Real == d2.Real && d1.Dual == d2.Dual;
+	}
+
+	bool operator!= (DualQuaternion const& d1, DualQuaternion const& d2) {
+		return !(d1 == d2);
+	}
+
+	DualQuaternion DualQuaternion::CreateTranslation(Vector3 const& translation) {
+		return DualQuaternion(Quaternion(0, 0, 0, 1), Quaternion(translation.X * 0.5, translation.Y * 0.5, translation.Z * 0.5, 0));
+	}
+
+	DualQuaternion DualQuaternion::CreateFromMatrix(Matrix const& m) {
+		return DualQuaternion(Quaternion::CreateFromRotationMatrix(m), Vector3(m.M41, m.M42, m.M43));
+	}
+
+	DualQuaternion DualQuaternion::Multiply(DualQuaternion const& d1, DualQuaternion const& d2) {
+		return DualQuaternion(
+			Quaternion::Multiply(d1.Real, d2.Real),
+			Quaternion::Multiply(d1.Real, d2.Dual) + Quaternion::Multiply(d1.Dual, d2.Real));
+	}
+
+	DualQuaternion DualQuaternion::Concatenate(DualQuaternion const& d1, DualQuaternion const& d2) {
+		return Multiply(d2, d1);
+	}
+
+	DualQuaternion DualQuaternion::Conjugate(DualQuaternion const& d) {
+		return DualQuaternion(Quaternion::Conjugate(d.Real), Quaternion::Conjugate(d.Dual));
+	}
+
+	double DualQuaternion::Dot(DualQuaternion const& d1, DualQuaternion const& d2) {
+		return Quaternion::Dot(d1.Real, d2.Real);
+	}
+
+	DualQuaternion DualQuaternion::Normalize(DualQuaternion const& d) {
+		double lengthSquared = Quaternion::Dot(d.Real, d.Real);
+
+		if (lengthSquared == 0) {
+			return DualQuaternion();
+		}
+
+		double inverse = 1.0 / std::sqrt(lengthSquared);
+		Quaternion real = d.Real * inverse;
+		Quaternion dual = d.Dual * inverse;
+
+		return DualQuaternion(real, dual - real * Quaternion::Dot(real, dual));
+	}
+
+	DualQuaternion DualQuaternion::ScLerp(DualQuaternion const& d1, DualQuaternion const& d2, double amount) {
+		DualQuaternion to = Dot(d1, d2) < 0 ? -d2 : d2;
+		//Screw from d1 to d2, raised to the power amount.
+		DualQuaternion difference = Multiply(Conjugate(d1), to);
+		Quaternion const& real = difference.Real;
+		Quaternion const& dual = difference.Dual;
+		double sine = std::sqrt(real.X * real.X + real.Y * real.Y + real.Z * real.Z);
+
+		if (sine < ScrewEpsilon) {
+			//Pure translation, which scales linearly.
+			return Multiply(d1, Normalize(DualQuaternion(Quaternion(0, 0, 0, 1), Quaternion(dual.X * amount, dual.Y * amount, dual.Z * amount, 0))));
+		}
+
+		//Half angle, axis direction, half pitch (translation along the axis) and moment of the screw.
+		double halfAngle = std::atan2(sine, real.W);
+		double inverseSine = 1.0 / sine;
+		Vector3 direction(real.X * inverseSine, real.Y * inverseSine, real.Z * inverseSine);
+		double halfPitch = -dual.W * inverseSine;
+		Vector3 moment(
+			(dual.X - direction.X * halfPitch * real.W) * inverseSine,
+			(dual.Y - direction.Y * halfPitch * real.W) * inverseSine,
+			(dual.Z - direction.Z * halfPitch * real.W) * inverseSine);
+
+		halfAngle *= amount;
+		halfPitch *= amount;
+		double s = std::sin(halfAngle);
+		double c = std::cos(halfAngle);
+
+		DualQuaternion power(
+			Quaternion(direction.X * s, direction.Y * s, direction.Z * s, c),
+			Quaternion(
+				direction.X * halfPitch * c + moment.X * s,
+				direction.Y * halfPitch * c + moment.Y * s,
+				direction.Z * halfPitch * c + moment.Z * s,
+				-halfPitch * s));
+
+		return Multiply(d1, power);
+	}
+
+	DualQuaternion DualQuaternion::Lerp(DualQuaternion const& d1, DualQuaternion const& d2, double amount) {
+		double weight = Dot(d1, d2) < 0 ? -amount : amount;
+		return Normalize(d1 * (1.0 - amount) + d2 * weight);
+	}
+
+	bool DualQuaternion::Blend(std::vector<DualQuaternion> const& transforms, std::vector<size_t> const& indices,
+		std::vector<double> const& weights, DualQuaternion& result) {
+
+		if (indices.size() != weights.size() || indices.empty()) {
+			return false;
+		}
+
+		DualQuaternion sum(Quaternion(0, 0, 0, 0), Quaternion(0, 0, 0, 0));
+		DualQuaternion const* first = nullptr;
+
+		for (size_t i = 0; i < indices.size(); i++) {
+			if (indices[i] >= transforms.size()) {
+				return false;
+			}
+
+			DualQuaternion const& transform = transforms[indices[i]];
+
+			if (first == nullptr) {
+				first = &transform;
+			}
+
+			double weight = Dot(*first, transform) < 0 ? -weights[i] : weights[i];
+			sum.Real = sum.Real + transform.Real * weight;
+			sum.Dual = sum.Dual + transform.Dual * weight;
+		}
+
+		if (Quaternion::Dot(sum.Real, sum.Real) == 0) {
+			return false;
+		}
+
+		result = Normalize(sum);
+		return true;
+	}
+
+	void DualQuaternion::CreateFromMatrices(std::vector<Matrix> const& source, std::vector<DualQuaternion>& destination) {
+		destination.resize(source.size());
+
+		for (size_t i = 0; i < source.size(); i++) {
+			destination[i] = CreateFromMatrix(source[i]);
+		}
+	}
+
+	void DualQuaternion::ToMatrices(std::vector<DualQuaternion> const& source, std::vector<Matrix>& destination) {
+		destination.resize(source.size());
+
+		for (size_t i = 0; i < source.size(); i++) {
+			destination[i] = source[i].ToMatrix();
+		}
+	}
+
+	Vector3 DualQuaternion::Transform(Vector3 const& position) const {
+		return Vector3::Transform(position, Real) + Translation();
+	}
+
+	Vector3 DualQuaternion::TransformNormal(Vector3 const& normal) const {
+		return Vector3::Transform(normal, Real);
+	}
+
+	Quaternion DualQuaternion::Rotation() const {
+		return Real;
+	}
+
+	Vector3 DualQuaternion::Translation() const {
+		//2 Dual Conjugate(Real), whose W is 0 for a unit dual quaternion.
+		return Vector3(
+			2.0 * (Dual.X * Real.W - Dual.W * Real.X + Dual.Z * Real.Y - Dual.Y * Real.Z),
+			2.0 * (Dual.Y * Real.W - Dual.W * Real.Y + Dual.X * Real.Z - Dual.Z * Real.X),
+			2.0 * (Dual.Z * Real.W - Dual.W * Real.Z + Dual.Y * Real.X - Dual.X * Real.Y));
+	}
+
+	AffineTransform DualQuaternion::ToAffineTransform() const {
+		return AffineTransform::CreateRigid(Real, Translation());
+	}
+
+	Matrix DualQuaternion::ToMatrix() const {
+		return ToAffineTransform().ToMatrix();
+	}
+}
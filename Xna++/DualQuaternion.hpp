@@ -0,0 +1,85 @@
+#ifndef _DUALQUATERNION_H_
+#define _DUALQUATERNION_H_
+
+#include <cstddef>
+#include <vector>
+#include "AffineTransform.hpp"
+#include "Matrix.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	/*
+	 Rigid transform as a unit dual quaternion Real + e Dual, where Real is the rotation and
+	 Dual = (translation, 0) * Real / 2. A rotation followed by a translation takes 8 doubles, and blending
+	 several of them (Lerp, Blend) stays a rigid transform once normalized, where blended matrices shrink
+	 and shear.
+
+	 Multiply is the dual quaternion product, d1 * d2 applying d2 first; Concatenate(d1, d2) applies d1
+	 first, as Quaternion::Concatenate and Matrix products do.
+	*/
+	class DualQuaternion {
+	public:
+		Quaternion Real{ 0, 0, 0, 1 };
+		Quaternion Dual;
+
+		//Identity.
+		DualQuaternion();
+		DualQuaternion(Quaternion const& real, Quaternion const& dual);
+		//rotation (normalized) followed by translation.
+		DualQuaternion(Quaternion const& rotation, Vector3 const& translation);
+
+		DualQuaternion operator- () const;
+		friend DualQuaternion operator+ (DualQuaternion const&, DualQuaternion const&);
+		friend DualQuaternion operator- (DualQuaternion const&, DualQuaternion const&);
+		friend DualQuaternion operator* (DualQuaternion const&, DualQuaternion const&);
+		friend DualQuaternion operator* (DualQuaternion const&, double);
+		friend DualQuaternion operator* (double, DualQuaternion const&);
+		friend bool operator== (DualQuaternion const&, DualQuaternion const&);
+		friend bool operator!= (DualQuaternion const&, DualQuaternion const&);
+
+		static DualQuaternion CreateTranslation(Vector3 const& translation);
+		//Rigid part of m: its upper 3x3 must be a rotation.
+		static DualQuaternion CreateFromMatrix(Matrix const& m);
+
+		static DualQuaternion Multiply(DualQuaternion const& d1, DualQuaternion const& d2);
+		static DualQuaternion Concatenate(DualQuaternion const& d1, DualQuaternion const& d2);
+		//Conjugates both parts, which inverts a unit dual quaternion.
+		static DualQuaternion Conjugate(DualQuaternion const& d);
+		//Dot product of the real parts.
+		static double Dot(DualQuaternion const& d1, DualQuaternion const& d2);
+		//Unit length real part and dual part orthogonal to it. The identity if Real is zero.
+		static DualQuaternion Normalize(DualQuaternion const& d);
+
+		/*
+		 Screw linear interpolation of unit dual quaternions: constant speed rotation about and translation
+		 along the screw axis taking d1 to d2, by the shortest arc.
+		*/
+		static DualQuaternion ScLerp(DualQuaternion const& d1, DualQuaternion const& d2, double amount);
+		//Dual quaternion linear blending of two unit dual quaternions, by the shortest arc, normalized.
+		static DualQuaternion Lerp(DualQuaternion const& d1, DualQuaternion const& d2, double amount);
+		/*
+		 Dual quaternion linear blending of transforms[indices[i]] with weights[i], each flipped onto the
+		 hemisphere of the first, normalized. Returns false if the arrays have different sizes, an index is
+		 out of bounds, or the weights cancel out.
+		*/
+		static bool Blend(std::vector<DualQuaternion> const& transforms, std::vector<size_t> const& indices,
+			std::vector<double> const& weights, DualQuaternion& result);
+
+		//Converts every matrix (rigid) or dual quaternion, resizing the destination.
+		static void CreateFromMatrices(std::vector<Matrix> const& source, std::vector<DualQuaternion>& destination);
+		static void ToMatrices(std::vector<DualQuaternion> const& source, std::vector<Matrix>& destination);
+
+		//Transforms of a unit dual quaternion.
+		Vector3 Transform(Vector3 const& position) const;
+		Vector3 TransformNormal(Vector3 const& normal) const;
+
+		Quaternion Rotation() const;
+		Vector3 Translation() const;
+		AffineTransform ToAffineTransform() const;
+		Matrix ToMatrix() const;
+	};
+}
+
+#endif
@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "DxtUtil.hpp"
+#include "Parallel.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XNA_DXT_SSE2
+#endif
+
+namespace Xna {
+
+	static_assert(sizeof(Color) == 4, "Color must be tightly packed to be written as 32-bit values.");
+
+	enum class DxtFormat {
+		Dxt1,
+		Dxt3,
+		Dxt5
+	};
+
+	static size_t BlockSize(DxtFormat format) {
+		return format == DxtFormat::Dxt1 ? DxtUtil::Dxt1BlockSize : DxtUtil::Dxt5BlockSize;
+	}
+
+	//Block rows handed to each thread, so that a range is at least about 1024 blocks.
+	static size_t RowGrain(size_t blocksWide) {
+		return blocksWide == 0 ? 1 : std::max<size_t>(1, 1024 / blocksWide);
+	}
+
+	static uint32_t Pack(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+		return r | (g << 8) | (b << 16) | (a << 24);
+	}
+
+	static uint16_t Read16(uint8_t const* bytes) {
+		return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+	}
+
+	//Same rounding as DxtUtil.cs.
+	static void Unpack565(uint16_t color, uint32_t& r, uint32_t& g, uint32_t& b) {
+		uint32_t temp = (color >> 11) * 255 + 16;
+		r = (temp / 32 + temp) / 32;
+		temp = ((color & 0x07E0u) >> 5) * 255 + 32;
+		g = (temp / 64 + temp) / 64;
+		temp = (color & 0x001Fu) * 255 + 16;
+		b = (temp / 32 + temp) / 32;
+	}
+
+	static uint16_t Pack565(uint32_t r, uint32_t g, uint32_t b) {
+		return static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+	}
+
+	//The four colors of a color block. DXT3 and DXT5 always use the four color mode.
+	static void ColorPalette(uint8_t const* block, bool dxt1, uint32_t palette[4]) {
+		uint16_t c0 = Read16(block);
+		uint16_t c1 = Read16(block + 2);
+		uint32_t r0, g0, b0, r1, g1, b1;
+
+		Unpack565(c0, r0, g0, b0);
+		Unpack565(c1, r1, g1, b1);
+
+		palette[0] = Pack(r0, g0, b0, 255);
+		palette[1] = Pack(r1, g1, b1, 255);
+
+		if (!dxt1 || c0 > c1) {
+			palette[2] = Pack((2 * r0 + r1) / 3, (2 * g0 + g1) / 3, (2 * b0 + b1) / 3, 255);
+			palette[3] = Pack((r0 + 2 * r1) / 3, (g0 + 2 * g1) / 3, (b0 + 2 * b1) / 3, 255);
+		}
+		else {
+			palette[2] = Pack((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 255);
+			palette[3] = 0;
+		}
+	}
+
+	static void AlphaPalette(uint32_t a0, uint32_t a1, uint8_t palette[8]) {
+		palette[0] = static_cast<uint8_t>(a0);
+		palette[1] = static_cast<uint8_t>(a1);
+
+		if (a0 > a1) {
+			for (uint32_t i = 2; i < 8; i++) {
+				palette[i] = static_cast<uint8_t>(((8 - i) * a0 + (i - 1) * a1) / 7);
+			}
+		}
+		else {
+			for (uint32_t i = 2; i < 6; i++) {
+				palette[i] = static_cast<uint8_t>(((6 - i) * a0 + (i - 1) * a1) / 5);
+			}
+
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	static void DecodeDxt3Alpha(uint8_t const* block, uint8_t alpha[16]) {
+		for (size_t i = 0; i < 8; i++) {
+			alpha[i * 2] = static_cast<uint8_t>((block[i] & 0x0F) * 17);
+			alpha[i * 2 + 1] = static_cast<uint8_t>((block[i] >> 4) * 17);
+		}
+	}
+
+	static void DecodeDxt5Alpha(uint8_t const* block, uint8_t alpha[16]) {
+		uint8_t palette[8];
+		AlphaPalette(block[0], block[1], palette);
+
+		uint64_t bits = 0;
+		for (size_t i = 0; i < 6; i++) {
+			bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+		}
+
+		for (size_t i = 0; i < 16; i++) {
+			alpha[i] = palette[(bits >> (3 * i)) & 7];
+		}
+	}
+
+	/*
+	 Writes the visible 'columns' x 'rows' pixels of a block to 'destination', whose rows are 'width' pixels apart.
+	 When 'alpha' is not null it replaces the alpha of the palette colors.
+	*/
+	static void WriteBlock(uint8_t const* colorBlock, uint32_t const palette[4], uint8_t const* alpha,
+		Color* destination, size_t width, size_t columns, size_t rows) {
+#ifdef XNA_DXT_SSE2
+		__m128i colors = _mm_loadu_si128(reinterpret_cast<__m128i const*>(palette));
+		__m128i color0 = _mm_shuffle_epi32(colors, 0x00);
+		__m128i color1 = _mm_shuffle_epi32(colors, 0x55);
+		__m128i color2 = _mm_shuffle_epi32(colors, 0xAA);
+		__m128i color3 = _mm_shuffle_epi32(colors, 0xFF);
+		__m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+
+		for (size_t y = 0; y < rows; y++) {
+			uint32_t bits = colorBlock[4 + y];
+			__m128i indices = _mm_setr_epi32(bits & 3, (bits >> 2) & 3, (bits >> 4) & 3, bits >> 6);
+
+			__m128i row = _mm_and_si128(_mm_cmpeq_epi32(indices, _mm_setzero_si128()), color0);
+			row = _mm_or_si128(row, _mm_and_si128(_mm_cmpeq_epi32(indices, _mm_set1_epi32(1)), color1));
+			row = _mm_or_si128(row, _mm_and_si128(_mm_cmpeq_epi32(indices, _mm_set1_epi32(2)), color2));
+			row = _mm_or_si128(row, _mm_and_si128(_mm_cmpeq_epi32(indices, _mm_set1_epi32(3)), color3));
+
+			if (alpha != nullptr) {
+				uint8_t const* a = alpha + y * 4;
+				__m128i alphas = _mm_slli_epi32(_mm_setr_epi32(a[0], a[1], a[2], a[3]), 24);
+				row = _mm_or_si128(_mm_and_si128(row, rgbMask), alphas);
+			}
+
+			Color* target = destination + y * width;
+
+			if (columns == 4) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(target), row);
+			}
+			else {
+				uint32_t pixels[4];
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), row);
+				std::memcpy(target, pixels, columns * 4);
+			}
+		}
+#else
+		for (size_t y = 0; y < rows; y++) {
+			uint32_t bits = colorBlock[4 + y];
+			Color* target = destination + y * width;
+
+			for (size_t x = 0; x < columns; x++) {
+				uint32_t value = palette[(bits >> (2 * x)) & 3];
+
+				if (alpha != nullptr) {
+					value = (value & 0x00FFFFFFu) | (static_cast<uint32_t>(alpha[y * 4 + x]) << 24);
+				}
+
+				target[x] = Color(value);
+			}
+		}
+#endif
+	}
+
+	static bool Decompress(DxtFormat format, uint8_t const* source, size_t length, int32_t width, int32_t height, std::vector<Color>& destination) {
+		if (width < 0 || height < 0) {
+			return false;
+		}
+
+		size_t blockSize = BlockSize(format);
+
+		if ((source == nullptr && length != 0) || length < DxtUtil::CompressedSize(width, height, blockSize)) {
+			return false;
+		}
+
+		size_t w = static_cast<size_t>(width);
+		size_t h = static_cast<size_t>(height);
+		size_t blocksWide = (w + 3) / 4;
+		size_t blocksHigh = (h + 3) / 4;
+
+		destination.resize(w * h);
+		Color* pixels = destination.data();
+
+		Parallel::For(0, blocksHigh, RowGrain(blocksWide), [&](size_t first, size_t last) {
+			uint32_t palette[4];
+			uint8_t alpha[16];
+
+			for (size_t by = first; by < last; by++) {
+				size_t rows = std::min<size_t>(4, h - by * 4);
+
+				for (size_t bx = 0; bx < blocksWide; bx++) {
+					uint8_t const* block = source + (by * blocksWide + bx) * blockSize;
+					uint8_t const* blockAlpha = nullptr;
+
+					if (format == DxtFormat::Dxt3) {
+						DecodeDxt3Alpha(block, alpha);
+						blockAlpha = alpha;
+						block += 8;
+					}
+					else if (format == DxtFormat::Dxt5) {
+						DecodeDxt5Alpha(block, alpha);
+						blockAlpha = alpha;
+						block += 8;
+					}
+
+					ColorPalette(block, format == DxtFormat::Dxt1, palette);
+					WriteBlock(block, palette, blockAlpha, pixels + by * 4 * w + bx * 4, w, std::min<size_t>(4, w - bx * 4), rows);
+				}
+			}
+		});
+
+		return true;
+	}
+
+	//Gathers a block, repeating the last row and column of partial blocks.
+	static void ReadBlock(Color const* source, size_t width, size_t columns, size_t rows, Color block[16]) {
+		for (size_t y = 0; y < 4; y++) {
+			Color const* row = source + std::min(y, rows - 1) * width;
+
+			for (size_t x = 0; x < 4; x++) {
+				block[y * 4 + x] = row[std::min(x, columns - 1)];
+			}
+		}
+	}
+
+	static uint32_t ColorDistance(Color const& c, uint32_t packed) {
+		int32_t dr = static_cast<int32_t>(c.R) - static_cast<int32_t>(packed & 0xFF);
+		int32_t dg = static_cast<int32_t>(c.G) - static_cast<int32_t>((packed >> 8) & 0xFF);
+		int32_t db = static_cast<int32_t>(c.B) - static_cast<int32_t>((packed >> 16) & 0xFF);
+
+		return static_cast<uint32_t>(dr * dr + dg * dg + db * db);
+	}
+
+	/*
+	 Bounding box encoder: the endpoints are the corners of the RGB bounding box inset by 1/16 of its size,
+	 and each pixel takes the closest palette entry.
+	 With 'allowTransparent', pixels with an alpha below 128 switch the block to the three color mode.
+	*/
+	static void EncodeColorBlock(Color const block[16], bool allowTransparent, uint8_t* output) {
+		bool transparent[16];
+		bool anyTransparent = false;
+		bool anyOpaque = false;
+		uint32_t minR = 255, minG = 255, minB = 255;
+		uint32_t maxR = 0, maxG = 0, maxB = 0;
+
+		for (size_t i = 0; i < 16; i++) {
+			transparent[i] = allowTransparent && block[i].A < 128;
+
+			if (transparent[i]) {
+				anyTransparent = true;
+				continue;
+			}
+
+			anyOpaque = true;
+			minR = std::min<uint32_t>(minR, block[i].R);
+			minG = std::min<uint32_t>(minG, block[i].G);
+			minB = std::min<uint32_t>(minB, block[i].B);
+			maxR = std::max<uint32_t>(maxR, block[i].R);
+			maxG = std::max<uint32_t>(maxG, block[i].G);
+			maxB = std::max<uint32_t>(maxB, block[i].B);
+		}
+
+		if (!anyOpaque) {
+			std::memset(output, 0, 4);
+			std::memset(output + 4, 0xFF, 4);
+			return;
+		}
+
+		uint32_t insetR = (maxR - minR) >> 4;
+		uint32_t insetG = (maxG - minG) >> 4;
+		uint32_t insetB = (maxB - minB) >> 4;
+
+		uint16_t c0 = Pack565(maxR - insetR, maxG - insetG, maxB - insetB);
+		uint16_t c1 = Pack565(minR + insetR, minG + insetG, minB + insetB);
+
+		//c0 > c1 selects the four color mode, c0 <= c1 the three color mode with transparency.
+		if (anyTransparent ? c0 > c1 : c0 < c1) {
+			std::swap(c0, c1);
+		}
+
+		output[0] = static_cast<uint8_t>(c0);
+		output[1] = static_cast<uint8_t>(c0 >> 8);
+		output[2] = static_cast<uint8_t>(c1);
+		output[3] = static_cast<uint8_t>(c1 >> 8);
+
+		if (c0 == c1 && !anyTransparent) {
+			std::memset(output + 4, 0, 4);
+			return;
+		}
+
+		uint32_t palette[4];
+		ColorPalette(output, true, palette);
+		size_t entries = anyTransparent ? 3 : 4;
+
+		for (size_t y = 0; y < 4; y++) {
+			uint32_t bits = 0;
+
+			for (size_t x = 0; x < 4; x++) {
+				Color const& pixel = block[y * 4 + x];
+				uint32_t index = 3;
+
+				if (!transparent[y * 4 + x]) {
+					uint32_t best = ColorDistance(pixel, palette[0]);
+					index = 0;
+
+					for (uint32_t i = 1; i < entries; i++) {
+						uint32_t distance = ColorDistance(pixel, palette[i]);
+
+						if (distance < best) {
+							best = distance;
+							index = i;
+						}
+					}
+				}
+
+				bits |= index << (2 * x);
+			}
+
+			output[4 + y] = static_cast<uint8_t>(bits);
+		}
+	}
+
+	//Uses the eight alpha mode with the exact alpha range of the block as endpoints.
+	static void EncodeAlphaBlock(Color const block[16], uint8_t* output) {
+		uint32_t minA = 255;
+		uint32_t maxA = 0;
+
+		for (size_t i = 0; i < 16; i++) {
+			minA = std::min<uint32_t>(minA, block[i].A);
+			maxA = std::max<uint32_t>(maxA, block[i].A);
+		}
+
+		output[0] = static_cast<uint8_t>(maxA);
+		output[1] = static_cast<uint8_t>(minA);
+
+		if (maxA == minA) {
+			std::memset(output + 2, 0, 6);
+			return;
+		}
+
+		uint8_t palette[8];
+		AlphaPalette(maxA, minA, palette);
+
+		uint64_t bits = 0;
+
+		for (size_t i = 0; i < 16; i++) {
+			int32_t a = block[i].A;
+			int32_t best = 256;
+			uint64_t index = 0;
+
+			for (uint32_t j = 0; j < 8; j++) {
+				int32_t distance = std::abs(a - static_cast<int32_t>(palette[j]));
+
+				if (distance < best) {
+					best = distance;
+					index = j;
+				}
+			}
+
+			bits |= index << (3 * i);
+		}
+
+		for (size_t i = 0; i < 6; i++) {
+			output[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+		}
+	}
+
+	static bool Compress(DxtFormat format, std::vector<Color> const& source, int32_t width, int32_t height, std::vector<uint8_t>& destination) {
+		if (width < 0 || height < 0) {
+			return false;
+		}
+
+		size_t w = static_cast<size_t>(width);
+		size_t h = static_cast<size_t>(height);
+
+		if (source.size() < w * h) {
+			return false;
+		}
+
+		size_t blockSize = BlockSize(format);
+		size_t blocksWide = (w + 3) / 4;
+		size_t blocksHigh = (h + 3) / 4;
+
+		destination.resize(DxtUtil::CompressedSize(width, height, blockSize));
+		Color const* pixels = source.data();
+		uint8_t* blocks = destination.data();
+
+		Parallel::For(0, blocksHigh, RowGrain(blocksWide), [&](size_t first, size_t last) {
+			Color block[16];
+
+			for (size_t by = first; by < last; by++) {
+				size_t rows = std::min<size_t>(4, h - by * 4);
+
+				for (size_t bx = 0; bx < blocksWide; bx++) {
+					uint8_t* output = blocks + (by * blocksWide + bx) * blockSize;
+
+					ReadBlock(pixels + by * 4 * w + bx * 4, w, std::min<size_t>(4, w - bx * 4), rows, block);
+
+					if (format == DxtFormat::Dxt5) {
+						EncodeAlphaBlock(block, output);
+						EncodeColorBlock(block, false, output + 8);
+					}
+					else {
+						EncodeColorBlock(block, true, output);
+					}
+				}
+			}
+		});
+
+		return true;
+	}
+
+	size_t DxtUtil::CompressedSize(int32_t width, int32_t height, size_t blockSize) {
+		if (width <= 0 || height <= 0) {
+			return 0;
+		}
+
+		return ((static_cast<size_t>(width) + 3) / 4) * ((static_cast<size_t>(height) + 3) / 4) * blockSize;
+	}
+
+	bool DxtUtil::DecompressDxt1(uint8_t const* source, size_t length, int32_t width, int32_t height, std::vector<Color>& destination) {
+		return Decompress(DxtFormat::Dxt1, source, length, width, height, destination);
+	}
+
+	bool DxtUtil::DecompressDxt1(std::vector<uint8_t> const& source, int32_t width, int32_t height, std::vector<Color>& destination) {
+		return Decompress(DxtFormat::Dxt1, source.data(), source.size(), width, height, destination);
+	}
+
+	bool DxtUtil::DecompressDxt3(uint8_t const* source, size_t length, int32_t width, int32_t height, std::vector<Color>& destination) {
+		return Decompress(DxtFormat::Dxt3, source, length, width, height, destination);
+	}
+
+	bool DxtUtil::DecompressDxt3(std::vector<uint8_t> const& source, int32_t width, int32_t height, std::vector<Color>& destination) {
+		return Decompress(DxtFormat::Dxt3, source.data(), source.size(), width, height, destination);
+	}
+
+	bool DxtUtil::DecompressDxt5(uint8_t const* source, size_t length, int32_t width, int32_t height, std::vector<Color>& destination) {
+		return Decompress(DxtFormat::Dxt5, source, length, width, height, destination);
+	}
+
+	bool DxtUtil::DecompressDxt5(std::vector<uint8_t> const& source, int32_t width, int32_t height, std::vector<Color>& destination) {
+		return Decompress(DxtFormat::Dxt5, source.data(), source.size(), width, height, destination);
+	}
+
+	bool DxtUtil::CompressDxt1(std::vector<Color> const& source, int32_t width, int32_t height, std::vector<uint8_t>& destination) {
+		return Compress(DxtFormat::Dxt1, source, width, height, destination);
+	}
+
+	bool DxtUtil::CompressDxt5(std::vector<Color> const& source, int32_t width, int32_t height, std::vector<uint8_t>& destination) {
+		return Compress(DxtFormat::Dxt5, source, width, height, destination);
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef _DXTUTIL_H_
+#define _DXTUTIL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Color.hpp"
+
+namespace Xna {
+
+	/*
+	 Decodes DXT1, DXT3 and DXT5 (BC1 to BC3) textures into Color buffers, and encodes
+	 Color buffers as DXT1 or DXT5 with a fast bounding box encoder.
+	 Rows of blocks are processed in parallel. Sizes that are not a multiple of 4 are supported;
+	 the methods return false if a buffer is too small or the dimensions are negative.
+	*/
+	class DxtUtil {
+	public:
+		static constexpr size_t Dxt1BlockSize = 8;
+		static constexpr size_t Dxt3BlockSize = 16;
+		static constexpr size_t Dxt5BlockSize = 16;
+
+		//Number of bytes of a width x height texture made of blocks of 'blockSize' bytes.
+		static size_t CompressedSize(int32_t width, int32_t height, size_t blockSize);
+
+		static bool DecompressDxt1(uint8_t const* source, size_t length, int32_t width, int32_t height, std::vector<Color>& destination);
+		static bool DecompressDxt1(std::vector<uint8_t> const& source, int32_t width, int32_t height, std::vector<Color>& destination);
+		static bool DecompressDxt3(uint8_t const* source, size_t length, int32_t width, int32_t height, std::vector<Color>& destination);
+		static bool DecompressDxt3(std::vector<uint8_t> const& source, int32_t width, int32_t height, std::vector<Color>& destination);
+		static bool DecompressDxt5(uint8_t const* source, size_t length, int32_t width, int32_t height, std::vector<Color>& destination);
+		static bool DecompressDxt5(std::vector<uint8_t> const& source, int32_t width, int32_t height, std::vector<Color>& destination);
+
+		//Pixels with an alpha below 128 are encoded as transparent black.
+		static bool CompressDxt1(std::vector<Color> const& source, int32_t width, int32_t height, std::vector<uint8_t>& destination);
+		static bool CompressDxt5(std::vector<Color> const& source, int32_t width, int32_t height, std::vector<uint8_t>& destination);
+	};
+}
+
+#endif
@@ -0,0 +1,367 @@
+#include <cstring>
+#include <mutex>
+#include "EntityStore.hpp"
+
+namespace Xna {
+
+	static std::mutex registryMutex;
+	static size_t componentSizes[EntityStore::MaxComponentTypes];
+	static ComponentId componentCount = 0;
+
+	static size_t AlignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	ComponentId EntityStore::RegisterComponentType(size_t size) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+
+		if (componentCount == MaxComponentTypes) {
+			return InvalidComponent;
+		}
+
+		componentSizes[componentCount] = size;
+		return componentCount++;
+	}
+
+	size_t EntityStore::ComponentSize(ComponentId component) {
+		return componentSizes[component];
+	}
+
+	EntityStore::EntityStore() {
+		FindArchetype(0);
+	}
+
+	EntityStore::~EntityStore() {}
+
+	size_t EntityStore::Count() const {
+		return count;
+	}
+
+	size_t EntityStore::ArchetypeCount() const {
+		return archetypes.size();
+	}
+
+	Entity EntityStore::Create() {
+		return CreateWithMask(0);
+	}
+
+	Entity EntityStore::CreateWithMask(uint64_t mask) {
+		uint32_t index;
+
+		if (freeIndices.empty()) {
+			index = static_cast<uint32_t>(records.size());
+			records.push_back(Record());
+		}
+		else {
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+
+		Entity entity{ index, records[index].Generation };
+		uint32_t archetype = FindArchetype(mask);
+
+		records[index].Archetype = archetype;
+		records[index].Row = static_cast<uint32_t>(AllocateRow(*archetypes[archetype], entity));
+		count++;
+
+		return entity;
+	}
+
+	bool EntityStore::Destroy(Entity entity) {
+		if (!Alive(entity)) {
+			return false;
+		}
+
+		Record& record = records[entity.Index];
+		RemoveRow(*archetypes[record.Archetype], record.Row);
+
+		Release(entity.Index);
+		count--;
+
+		return true;
+	}
+
+	bool EntityStore::IsAlive(Entity entity) const {
+		return Alive(entity);
+	}
+
+	void EntityStore::Clear() {
+		for (size_t i = 0; i < archetypes.size(); i++) {
+			archetypes[i]->Chunks.clear();
+			archetypes[i]->Count = 0;
+		}
+
+		for (uint32_t i = 0; i < records.size(); i++) {
+			if (records[i].Archetype != None) {
+				Release(i);
+			}
+		}
+
+		count = 0;
+	}
+
+	uint64_t EntityStore::MaskOf(Entity entity) const {
+		return Alive(entity) ? archetypes[records[entity.Index].Archetype]->Mask : 0;
+	}
+
+	bool EntityStore::AddComponent(Entity entity, ComponentId component, void const* value) {
+		if (component >= MaxComponentTypes || !Alive(entity)) {
+			return false;
+		}
+
+		uint32_t from = records[entity.Index].Archetype;
+
+		if ((archetypes[from]->Mask & (uint64_t(1) << component)) == 0) {
+			Move(entity, Neighbour(from, component, true));
+		}
+
+		return SetComponent(entity, component, value);
+	}
+
+	bool EntityStore::RemoveComponent(Entity entity, ComponentId component) {
+		if (component >= MaxComponentTypes || !Alive(entity)) {
+			return false;
+		}
+
+		uint32_t from = records[entity.Index].Archetype;
+
+		if ((archetypes[from]->Mask & (uint64_t(1) << component)) == 0) {
+			return false;
+		}
+
+		Move(entity, Neighbour(from, component, false));
+		return true;
+	}
+
+	void* EntityStore::GetComponent(Entity entity, ComponentId component) const {
+		if (component >= MaxComponentTypes || !Alive(entity)) {
+			return nullptr;
+		}
+
+		Record const& record = records[entity.Index];
+		Archetype& archetype = *archetypes[record.Archetype];
+
+		if ((archetype.Mask & (uint64_t(1) << component)) == 0) {
+			return nullptr;
+		}
+
+		return Cell(archetype, record.Row, archetype.Offsets[component], ComponentSize(component));
+	}
+
+	bool EntityStore::SetComponent(Entity entity, ComponentId component, void const* value) {
+		void* destination = GetComponent(entity, component);
+
+		if (destination == nullptr) {
+			return false;
+		}
+
+		std::memcpy(destination, value, ComponentSize(component));
+		return true;
+	}
+
+	bool EntityStore::Alive(Entity entity) const {
+		return entity.Index < records.size() && entity.Generation != 0
+			&& records[entity.Index].Generation == entity.Generation && records[entity.Index].Archetype != None;
+	}
+
+	/*
+	 Lays out a new archetype: the entity column, then one column per component in id order, each padded to
+	 a cache line, with as many entities per chunk as fit in ChunkSize (at least one).
+	*/
+	uint32_t EntityStore::FindArchetype(uint64_t mask) {
+		uint32_t const* found = archetypeIndex.Find(mask);
+
+		if (found != nullptr) {
+			return *found;
+		}
+
+		std::unique_ptr<Archetype> archetype(new Archetype());
+		archetype->Mask = mask;
+
+		size_t entityBytes = sizeof(Entity);
+
+		for (ComponentId id = 0; id < MaxComponentTypes; id++) {
+			archetype->AddEdges[id] = None;
+			archetype->RemoveEdges[id] = None;
+			archetype->Offsets[id] = 0;
+
+			if (mask & (uint64_t(1) << id)) {
+				archetype->Components.push_back(id);
+				entityBytes += ComponentSize(id);
+			}
+		}
+
+		size_t capacity = ChunkSize / entityBytes;
+		size_t bytes = 0;
+
+		for (capacity = capacity < 1 ? 1 : capacity; ; capacity--) {
+			bytes = AlignUp(capacity * sizeof(Entity), CacheLine);
+
+			for (size_t i = 0; i < archetype->Components.size(); i++) {
+				ComponentId id = archetype->Components[i];
+				archetype->Offsets[id] = bytes;
+				bytes += AlignUp(capacity * ComponentSize(id), CacheLine);
+			}
+
+			if (bytes <= ChunkSize || capacity == 1) {
+				break;
+			}
+		}
+
+		archetype->Capacity = capacity;
+		archetype->ChunkBytes = bytes;
+
+		uint32_t index = static_cast<uint32_t>(archetypes.size());
+		archetypes.push_back(std::move(archetype));
+		archetypeIndex.Insert(mask, index);
+
+		return index;
+	}
+
+	uint32_t EntityStore::Neighbour(uint32_t from, ComponentId component, bool add) {
+		uint32_t* edges = add ? archetypes[from]->AddEdges : archetypes[from]->RemoveEdges;
+
+		if (edges[component] == None) {
+			uint64_t bit = uint64_t(1) << component;
+			edges[component] = FindArchetype(add ? archetypes[from]->Mask | bit : archetypes[from]->Mask & ~bit);
+		}
+
+		return edges[component];
+	}
+
+	//Invalidates the handles of the index and makes it reusable. Generation 0 is never alive, so a wrapped counter skips it.
+	void EntityStore::Release(uint32_t index) {
+		Record& record = records[index];
+		record.Generation = record.Generation == 0xFFFFFFFF ? 1 : record.Generation + 1;
+		record.Archetype = None;
+		freeIndices.push_back(index);
+	}
+
+	unsigned char* EntityStore::Cell(Archetype& archetype, size_t row, size_t offset, size_t size) const {
+		return archetype.Chunks[row / archetype.Capacity].Data + offset + (row % archetype.Capacity) * size;
+	}
+
+	size_t EntityStore::AllocateRow(Archetype& archetype, Entity entity) {
+		if (archetype.Count == archetype.Chunks.size() * archetype.Capacity) {
+			Chunk chunk;
+			chunk.Memory.reset(new unsigned char[archetype.ChunkBytes + CacheLine]);
+
+			uintptr_t address = reinterpret_cast<uintptr_t>(chunk.Memory.get());
+			chunk.Data = chunk.Memory.get() + (AlignUp(address, CacheLine) - address);
+			archetype.Chunks.push_back(std::move(chunk));
+		}
+
+		size_t row = archetype.Count++;
+		std::memcpy(Cell(archetype, row, 0, sizeof(Entity)), &entity, sizeof(Entity));
+
+		for (size_t i = 0; i < archetype.Components.size(); i++) {
+			ComponentId id = archetype.Components[i];
+			std::memset(Cell(archetype, row, archetype.Offsets[id], ComponentSize(id)), 0, ComponentSize(id));
+		}
+
+		return row;
+	}
+
+	//Moves the last entity of the archetype into row, and frees the chunks beyond one spare.
+	void EntityStore::RemoveRow(Archetype& archetype, size_t row) {
+		size_t last = archetype.Count - 1;
+
+		if (row != last) {
+			Entity moved;
+			std::memcpy(&moved, Cell(archetype, last, 0, sizeof(Entity)), sizeof(Entity));
+			std::memcpy(Cell(archetype, row, 0, sizeof(Entity)), &moved, sizeof(Entity));
+
+			for (size_t i = 0; i < archetype.Components.size(); i++) {
+				ComponentId id = archetype.Components[i];
+				size_t size = ComponentSize(id);
+				std::memcpy(Cell(archetype, row, archetype.Offsets[id], size), Cell(archetype, last, archetype.Offsets[id], size), size);
+			}
+
+			records[moved.Index].Row = static_cast<uint32_t>(row);
+		}
+
+		archetype.Count--;
+
+		if (archetype.Chunks.size() * archetype.Capacity >= archetype.Count + 2 * archetype.Capacity) {
+			archetype.Chunks.pop_back();
+		}
+	}
+
+	void EntityStore::Move(Entity entity, uint32_t to) {
+		Record& record = records[entity.Index];
+		Archetype& source = *archetypes[record.Archetype];
+		Archetype& destination = *archetypes[to];
+		size_t sourceRow = record.Row;
+		size_t row = AllocateRow(destination, entity);
+
+		for (size_t i = 0; i < destination.Components.size(); i++) {
+			ComponentId id = destination.Components[i];
+
+			if (source.Mask & (uint64_t(1) << id)) {
+				size_t size = ComponentSize(id);
+				std::memcpy(Cell(destination, row, destination.Offsets[id], size), Cell(source, sourceRow, source.Offsets[id], size), size);
+			}
+		}
+
+		RemoveRow(source, sourceRow);
+		record.Archetype = to;
+		record.Row = static_cast<uint32_t>(row);
+	}
+
+	bool EntityCommandBuffer::IsEmpty() const {
+		return data.empty();
+	}
+
+	void EntityCommandBuffer::Clear() {
+		data.clear();
+	}
+
+	void EntityCommandBuffer::Destroy(Entity entity) {
+		Write(Command::Destroy, 0, entity, 0, nullptr, 0);
+	}
+
+	void EntityCommandBuffer::Write(Command type, ComponentId component, Entity target, uint64_t mask, void const* value, size_t size) {
+		Header header{ type, component, target, mask, size };
+		size_t offset = data.size();
+
+		data.resize(offset + sizeof(Header) + size);
+		std::memcpy(data.data() + offset, &header, sizeof(Header));
+
+		if (size > 0) {
+			std::memcpy(data.data() + offset + sizeof(Header), value, size);
+		}
+	}
+
+	void EntityCommandBuffer::Playback(EntityStore& store) {
+		Entity created;
+		size_t offset = 0;
+
+		while (offset < data.size()) {
+			Header header;
+			std::memcpy(&header, data.data() + offset, sizeof(Header));
+			unsigned char const* value = data.data() + offset + sizeof(Header);
+
+			switch (header.Type) {
+			case Command::Create:
+				created = store.CreateWithMask(header.Mask);
+				break;
+			case Command::Set:
+				store.SetComponent(created, header.Component, value);
+				break;
+			case Command::Destroy:
+				store.Destroy(header.Target);
+				break;
+			case Command::Add:
+				store.AddComponent(header.Target, header.Component, value);
+				break;
+			case Command::Remove:
+				store.RemoveComponent(header.Target, header.Component);
+				break;
+			}
+
+			offset += sizeof(Header) + static_cast<size_t>(header.Size);
+		}
+
+		data.clear();
+	}
+}
@@ -0,0 +1,325 @@
+#ifndef _ENTITYSTORE_H_
+#define _ENTITYSTORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "FlatHashMap.hpp"
+#include "Parallel.hpp"
+
+namespace Xna {
+
+	//Handle of an entity. A default constructed handle (generation 0) never refers to a live entity.
+	struct Entity {
+		uint32_t Index{ 0 };
+		uint32_t Generation{ 0 };
+
+		friend bool operator== (Entity const& e1, Entity const& e2) {
+			return e1.Index == e2.Index && e1.Generation == e2.Generation;
+		}
+
+		friend bool operator!= (Entity const& e1, Entity const& e2) {
+			return !(e1 == e2);
+		}
+	};
+
+	using ComponentId = uint32_t;
+
+	/*
+	 Archetype based entity-component store. Entities with the same set of component types (an archetype)
+	 are packed in 16 KiB chunks holding one column per type, each starting on a cache line, so a system
+	 reading Vector3 positions and Quaternion rotations streams two dense arrays instead of chasing
+	 pointers. Components are any trivially copyable type (Vector3, Quaternion, Rectangle, Matrix...);
+	 component ids are assigned on first use and shared by all stores, up to MaxComponentTypes types.
+
+	 Adding or removing a component moves the entity to another archetype, and removing an entity fills its
+	 slot with the last one, so pointers from Get and the chunks seen by ForEachChunk are invalidated by
+	 any structural change. While iterating, record the changes in an EntityCommandBuffer instead.
+	*/
+	class EntityStore {
+	public:
+		static constexpr size_t MaxComponentTypes = 64;
+		static constexpr size_t ChunkSize = 16384;
+		static constexpr size_t CacheLine = 64;
+		//Returned for a type past MaxComponentTypes; operations on it fail.
+		static constexpr ComponentId InvalidComponent = static_cast<ComponentId>(MaxComponentTypes);
+
+		template <typename T>
+		static ComponentId ComponentTypeId() {
+			static_assert(std::is_trivially_copyable<T>::value, "Components are copied as bytes.");
+			static ComponentId const id = RegisterComponentType(sizeof(T));
+			return id;
+		}
+
+		EntityStore();
+		~EntityStore();
+
+		EntityStore(EntityStore const&) = delete;
+		EntityStore& operator= (EntityStore const&) = delete;
+
+		//Number of live entities.
+		size_t Count() const;
+		//Number of archetypes created so far, including empty ones.
+		size_t ArchetypeCount() const;
+
+		Entity Create();
+
+		template <typename... T>
+		Entity Create(T const&... components) {
+			Entity entity = CreateWithMask(MaskOf<T...>());
+			int unused[] = { 0, (SetComponent(entity, ComponentTypeId<T>(), &components), 0)... };
+			(void)unused;
+			return entity;
+		}
+
+		//Entity with zeroed components of the types in mask.
+		Entity CreateWithMask(uint64_t mask);
+		bool Destroy(Entity entity);
+		bool IsAlive(Entity entity) const;
+		void Clear();
+
+		//Adds the component, or sets it if the entity already has one.
+		template <typename T>
+		bool Add(Entity entity, T const& value) {
+			return AddComponent(entity, ComponentTypeId<T>(), &value);
+		}
+
+		template <typename T>
+		bool Remove(Entity entity) {
+			return RemoveComponent(entity, ComponentTypeId<T>());
+		}
+
+		template <typename T>
+		bool Has(Entity entity) const {
+			return GetComponent(entity, ComponentTypeId<T>()) != nullptr;
+		}
+
+		//null if the entity is not alive or lacks the component.
+		template <typename T>
+		T* Get(Entity entity) {
+			return static_cast<T*>(GetComponent(entity, ComponentTypeId<T>()));
+		}
+
+		template <typename T>
+		T const* Get(Entity entity) const {
+			return static_cast<T const*>(GetComponent(entity, ComponentTypeId<T>()));
+		}
+
+		//Mask of the component types, or 0 if the entity is not alive.
+		uint64_t MaskOf(Entity entity) const;
+
+		template <typename... T>
+		static uint64_t MaskOf() {
+			ComponentId ids[] = { 0, ComponentTypeId<T>()... };
+			uint64_t mask = 0;
+
+			for (size_t i = 1; i < sizeof(ids) / sizeof(ids[0]); i++) {
+				mask |= ids[i] < MaxComponentTypes ? uint64_t(1) << ids[i] : 0;
+			}
+
+			return mask;
+		}
+
+		/*
+		 Calls body(count, entities, columns...) for every non empty chunk whose entities have all the
+		 types T, with the columns of T in the order of T.
+		*/
+		template <typename... T, typename F>
+		void ForEachChunk(F const& body) {
+			uint64_t mask;
+			if (!RequiredMask<T...>(mask)) {
+				return;
+			}
+
+			for (size_t a = 0; a < archetypes.size(); a++) {
+				Archetype& archetype = *archetypes[a];
+
+				if ((archetype.Mask & mask) != mask) {
+					continue;
+				}
+
+				for (size_t c = 0; c * archetype.Capacity < archetype.Count; c++) {
+					CallChunk<T...>(archetype, c, body);
+				}
+			}
+		}
+
+		//Same, with the chunks split over Parallel::For. body must only touch its own chunk.
+		template <typename... T, typename F>
+		void ParallelForEachChunk(F const& body) {
+			uint64_t mask;
+			if (!RequiredMask<T...>(mask)) {
+				return;
+			}
+
+			std::vector<std::pair<Archetype*, size_t>> chunks;
+
+			for (size_t a = 0; a < archetypes.size(); a++) {
+				Archetype& archetype = *archetypes[a];
+
+				if ((archetype.Mask & mask) == mask) {
+					for (size_t c = 0; c * archetype.Capacity < archetype.Count; c++) {
+						chunks.emplace_back(&archetype, c);
+					}
+				}
+			}
+
+			Parallel::For(0, chunks.size(), 1, [this, &chunks, &body](size_t first, size_t last) {
+				for (size_t i = first; i < last; i++) {
+					CallChunk<T...>(*chunks[i].first, chunks[i].second, body);
+				}
+			});
+		}
+
+		//Calls body(entity, components...) for every entity that has all the types T.
+		template <typename... T, typename F>
+		void ForEach(F const& body) {
+			ForEachChunk<T...>([&body](size_t count, Entity const* entities, T*... columns) {
+				for (size_t i = 0; i < count; i++) {
+					body(entities[i], columns[i]...);
+				}
+			});
+		}
+
+		//Untyped access, with the ids of ComponentTypeId.
+		bool AddComponent(Entity entity, ComponentId component, void const* value);
+		bool RemoveComponent(Entity entity, ComponentId component);
+		void* GetComponent(Entity entity, ComponentId component) const;
+		//Copies size-of-component bytes from value; returns false if the entity lacks the component.
+		bool SetComponent(Entity entity, ComponentId component, void const* value);
+
+	private:
+		static constexpr uint32_t None = 0xFFFFFFFF;
+
+		struct Chunk {
+			std::unique_ptr<unsigned char[]> Memory;
+			//Memory aligned to CacheLine.
+			unsigned char* Data;
+		};
+
+		struct Archetype {
+			uint64_t Mask{ 0 };
+			std::vector<ComponentId> Components;
+			//Byte offset of the column of each component in a chunk; the entity column is at 0.
+			size_t Offsets[MaxComponentTypes];
+			//Entities per chunk, and bytes per chunk.
+			size_t Capacity{ 0 };
+			size_t ChunkBytes{ 0 };
+			size_t Count{ 0 };
+			std::vector<Chunk> Chunks;
+			//Archetype reached by adding or removing each component, once looked up.
+			uint32_t AddEdges[MaxComponentTypes];
+			uint32_t RemoveEdges[MaxComponentTypes];
+		};
+
+		struct Record {
+			//None while the index is free.
+			uint32_t Archetype{ None };
+			uint32_t Row{ 0 };
+			uint32_t Generation{ 1 };
+		};
+
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		FlatHashMap<uint64_t, uint32_t> archetypeIndex;
+		std::vector<Record> records;
+		std::vector<uint32_t> freeIndices;
+		size_t count{ 0 };
+
+		static ComponentId RegisterComponentType(size_t size);
+		static size_t ComponentSize(ComponentId component);
+
+		template <typename... T>
+		static bool RequiredMask(uint64_t& mask) {
+			ComponentId ids[] = { 0, ComponentTypeId<T>()... };
+			mask = 0;
+
+			for (size_t i = 1; i < sizeof(ids) / sizeof(ids[0]); i++) {
+				if (ids[i] >= MaxComponentTypes) {
+					return false;
+				}
+
+				mask |= uint64_t(1) << ids[i];
+			}
+
+			return true;
+		}
+
+		template <typename... T, typename F>
+		static void CallChunk(Archetype& archetype, size_t chunk, F const& body) {
+			unsigned char* data = archetype.Chunks[chunk].Data;
+			size_t first = chunk * archetype.Capacity;
+			size_t length = archetype.Count - first < archetype.Capacity ? archetype.Count - first : archetype.Capacity;
+
+			body(length, reinterpret_cast<Entity const*>(data),
+				reinterpret_cast<T*>(data + archetype.Offsets[ComponentTypeId<T>()])...);
+		}
+
+		bool Alive(Entity entity) const;
+		void Release(uint32_t index);
+		uint32_t FindArchetype(uint64_t mask);
+		uint32_t Neighbour(uint32_t from, ComponentId component, bool add);
+		unsigned char* Cell(Archetype& archetype, size_t row, size_t offset, size_t size) const;
+		size_t AllocateRow(Archetype& archetype, Entity entity);
+		void RemoveRow(Archetype& archetype, size_t row);
+		void Move(Entity entity, uint32_t to);
+	};
+
+	/*
+	 Structural changes recorded while iterating an EntityStore, applied in order by Playback.
+	 Not thread safe: give each thread of a ParallelForEachChunk its own buffer and play them back in turn.
+	*/
+	class EntityCommandBuffer {
+	public:
+		bool IsEmpty() const;
+		void Clear();
+
+		template <typename... T>
+		void Create(T const&... components) {
+			Write(Command::Create, 0, Entity(), EntityStore::MaskOf<T...>(), nullptr, 0);
+			int unused[] = { 0, (Write(Command::Set, EntityStore::ComponentTypeId<T>(), Entity(), 0, &components, sizeof(T)), 0)... };
+			(void)unused;
+		}
+
+		void Destroy(Entity entity);
+
+		template <typename T>
+		void Add(Entity entity, T const& value) {
+			Write(Command::Add, EntityStore::ComponentTypeId<T>(), entity, 0, &value, sizeof(T));
+		}
+
+		template <typename T>
+		void Remove(Entity entity) {
+			Write(Command::Remove, EntityStore::ComponentTypeId<T>(), entity, 0, nullptr, 0);
+		}
+
+		//Applies and clears the commands. Commands on entities that died in the meantime are skipped.
+		void Playback(EntityStore& store);
+
+	private:
+		enum class Command : uint32_t {
+			Create,
+			//Sets a component of the entity made by the last Create.
+			Set,
+			Destroy,
+			Add,
+			Remove
+		};
+
+		struct Header {
+			Command Type;
+			ComponentId Component;
+			Entity Target;
+			uint64_t Mask;
+			uint64_t Size;
+		};
+
+		std::vector<unsigned char> data;
+
+		void Write(Command type, ComponentId component, Entity target, uint64_t mask, void const* value, size_t size);
+	};
+}
+
+#endif
@@ -0,0 +1,8 @@
+#include "FastMath.hpp"
+
+namespace Xna {
+
+	//Out of class definitions, needed before C++17 since the tables are indexed at run time.
+	constexpr FastMathTables::Table FastMath::SinTable;
+	constexpr FastMathTables::Table FastMath::AtanTable;
+}
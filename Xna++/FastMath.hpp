@@ -0,0 +1,211 @@
+#ifndef _FASTMATH_H_
+#define _FASTMATH_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "MathHelper.hpp"
+
+namespace Xna {
+
+	namespace FastMathTables {
+
+		//Intervals per table: sin over [0, PI/2], atan over [0, 1].
+		static constexpr size_t Size = 256;
+
+		struct Table {
+			double Values[Size + 1];
+		};
+
+		//Taylor series, accurate to a few ulps on [0, PI/2].
+		constexpr double SeriesSin(double x) {
+			double term = x;
+			double sum = x;
+
+			for (int n = 1; n < 14; n++) {
+				term *= -x * x / ((2 * n) * (2 * n + 1));
+				sum += term;
+			}
+
+			return sum;
+		}
+
+		//Euler's series, which converges at least as fast as 2^-n on [0, 1].
+		constexpr double SeriesAtan(double x) {
+			double ratio = x * x / (1.0 + x * x);
+			double term = x / (1.0 + x * x);
+			double sum = term;
+
+			for (int n = 1; n < 64 && term > 1e-18; n++) {
+				term *= ratio * (2 * n) / (2 * n + 1);
+				sum += term;
+			}
+
+			return sum;
+		}
+
+		constexpr Table BuildSin() {
+			Table table{};
+
+			for (size_t i = 0; i <= Size; i++) {
+				table.Values[i] = SeriesSin(MathHelper::PI_OVER_2 * static_cast<double>(i) / Size);
+			}
+
+			return table;
+		}
+
+		constexpr Table BuildAtan() {
+			Table table{};
+
+			for (size_t i = 0; i <= Size; i++) {
+				table.Values[i] = SeriesAtan(static_cast<double>(i) / Size);
+			}
+
+			return table;
+		}
+
+		//Cubic Hermite interpolation between v0 and v1 with slopes d0 and d1, for u in [0, 1].
+		constexpr double Interpolate(double v0, double v1, double d0, double d1, double u) {
+			double u2 = u * u;
+			double u3 = u2 * u;
+
+			return (2 * u3 - 3 * u2 + 1) * v0
+				+ (u3 - 2 * u2 + u) * d0
+				+ (3 * u2 - 2 * u3) * v1
+				+ (u3 - u2) * d1;
+		}
+	}
+
+	/*
+	 Table based sin, cos and atan, built at compile time and interpolated with cubic Hermite splines
+	 (the tables hold the function and, through symmetry or a closed form, its derivative).
+	 Absolute error is below 1e-11, with no libm call for angles of a sane magnitude.
+	 Define XNA_FAST_TRIG to make Quaternion::CreateFromYawPitchRoll and CreateFromAxisAngle use them.
+	*/
+	class FastMath {
+	public:
+		static constexpr FastMathTables::Table SinTable = FastMathTables::BuildSin();
+		static constexpr FastMathTables::Table AtanTable = FastMathTables::BuildAtan();
+
+		static constexpr void SinCos(double angle, double& sin, double& cos) {
+			constexpr size_t n = FastMathTables::Size;
+			constexpr double step = MathHelper::PI_OVER_2 / n;
+
+			//Quarter turns; angles too large for an int64 quotient have no meaningful fraction left.
+			double turns = angle * (1.0 / MathHelper::PI_OVER_2);
+
+			if (!(turns > -9.0e15 && turns < 9.0e15)) {
+				sin = std::sin(angle);
+				cos = std::cos(angle);
+				return;
+			}
+
+			int64_t quadrant = static_cast<int64_t>(turns);
+			if (static_cast<double>(quadrant) > turns) {
+				quadrant--;
+			}
+
+			double position = (turns - static_cast<double>(quadrant)) * n;
+			size_t i = static_cast<size_t>(position);
+			if (i >= n) {
+				i = n - 1;
+			}
+
+			double u = position - static_cast<double>(i);
+			double s0 = SinTable.Values[i];
+			double s1 = SinTable.Values[i + 1];
+			double c0 = SinTable.Values[n - i];
+			double c1 = SinTable.Values[n - i - 1];
+
+			double s = FastMathTables::Interpolate(s0, s1, c0 * step, c1 * step, u);
+			double c = FastMathTables::Interpolate(c0, c1, -s0 * step, -s1 * step, u);
+
+			switch (quadrant & 3) {
+			case 0:
+				sin = s;
+				cos = c;
+				break;
+			case 1:
+				sin = c;
+				cos = -s;
+				break;
+			case 2:
+				sin = -s;
+				cos = -c;
+				break;
+			default:
+				sin = -c;
+				cos = s;
+				break;
+			}
+		}
+
+		static constexpr double Sin(double angle) {
+			double sin = 0;
+			double cos = 0;
+			SinCos(angle, sin, cos);
+			return sin;
+		}
+
+		static constexpr double Cos(double angle) {
+			double sin = 0;
+			double cos = 0;
+			SinCos(angle, sin, cos);
+			return cos;
+		}
+
+		static constexpr double Atan(double value) {
+			constexpr size_t n = FastMathTables::Size;
+			constexpr double step = 1.0 / n;
+
+			if (value != value) {
+				return value;
+			}
+
+			double x = value < 0 ? -value : value;
+			bool inverted = x > 1.0;
+
+			if (inverted) {
+				x = 1.0 / x;
+			}
+
+			double position = x * n;
+			size_t i = static_cast<size_t>(position);
+			if (i >= n) {
+				i = n - 1;
+			}
+
+			double u = position - static_cast<double>(i);
+			double x0 = static_cast<double>(i) * step;
+			double x1 = x0 + step;
+
+			double result = FastMathTables::Interpolate(AtanTable.Values[i], AtanTable.Values[i + 1],
+				step / (1.0 + x0 * x0), step / (1.0 + x1 * x1), u);
+
+			if (inverted) {
+				result = MathHelper::PI_OVER_2 - result;
+			}
+
+			return value < 0 ? -result : result;
+		}
+
+		//Same quadrant rules as std::atan2; returns 0 for (0, 0).
+		static constexpr double Atan2(double y, double x) {
+			if (x > 0) {
+				return Atan(y / x);
+			}
+
+			if (x < 0) {
+				return y < 0 ? Atan(y / x) - MathHelper::PI : Atan(y / x) + MathHelper::PI;
+			}
+
+			if (y > 0) {
+				return MathHelper::PI_OVER_2;
+			}
+
+			return y < 0 ? -MathHelper::PI_OVER_2 : 0.0;
+		}
+	};
+}
+
+#endif
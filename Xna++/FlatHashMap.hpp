@@ -0,0 +1,261 @@
+#ifndef _FLATHASHMAP_H_
+#define _FLATHASHMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Xna {
+
+	/*
+	 Open addressing hash map with linear probing and backward shift deletion (no tombstones).
+	 Keys, values and slot states live in separate arrays, so probing a run of small keys such as Point
+	 stays within a few cache lines. The hash is spread over the table with Fibonacci hashing, which keeps
+	 neighbouring grid coordinates apart even with a weak hasher.
+	 Pointers returned by Find and operator[] are invalidated by any insertion or removal.
+	*/
+	template <typename TKey, typename TValue, typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+	class FlatHashMap {
+	public:
+		FlatHashMap() {}
+		FlatHashMap(size_t capacity) { Reserve(capacity); }
+
+		size_t Count() const { return count; }
+		bool IsEmpty() const { return count == 0; }
+		//Number of slots, a power of two.
+		size_t Capacity() const { return states.size(); }
+
+		void Clear() {
+			for (size_t i = 0; i < states.size(); i++) {
+				if (states[i] != 0) {
+					keys[i] = TKey();
+					values[i] = TValue();
+					states[i] = 0;
+				}
+			}
+
+			count = 0;
+		}
+
+		//Makes room for 'capacity' entries without rehashing.
+		void Reserve(size_t capacity) {
+			size_t slots = MinCapacity;
+
+			while (slots - slots / 4 < capacity) {
+				slots *= 2;
+			}
+
+			if (slots > states.size()) {
+				Rehash(slots);
+			}
+		}
+
+		//Returns false and leaves the stored value untouched if the key already exists.
+		bool Insert(TKey const& key, TValue const& value) {
+			size_t slot;
+			if (FindSlot(key, slot)) {
+				return false;
+			}
+
+			values[InsertAt(key, slot)] = value;
+			return true;
+		}
+
+		//Returns the value of 'key', inserting a default value if it is missing.
+		TValue& operator[](TKey const& key) {
+			size_t slot;
+			if (FindSlot(key, slot)) {
+				return values[slot];
+			}
+
+			return values[InsertAt(key, slot)];
+		}
+
+		TValue* Find(TKey const& key) {
+			size_t slot;
+			return FindSlot(key, slot) ? &values[slot] : nullptr;
+		}
+
+		TValue const* Find(TKey const& key) const {
+			size_t slot;
+			return FindSlot(key, slot) ? &values[slot] : nullptr;
+		}
+
+		bool TryGetValue(TKey const& key, TValue& value) const {
+			size_t slot;
+			if (!FindSlot(key, slot)) {
+				return false;
+			}
+
+			value = values[slot];
+			return true;
+		}
+
+		bool ContainsKey(TKey const& key) const {
+			size_t slot;
+			return FindSlot(key, slot);
+		}
+
+		bool Remove(TKey const& key) {
+			size_t slot;
+			if (!FindSlot(key, slot)) {
+				return false;
+			}
+
+			size_t mask = states.size() - 1;
+			size_t hole = slot;
+
+			//Moves back every following entry of the run that may live in the hole.
+			for (size_t next = (hole + 1) & mask; states[next] != 0; next = (next + 1) & mask) {
+				size_t home = Index(keys[next]);
+
+				if (((next - home) & mask) >= ((next - hole) & mask)) {
+					keys[hole] = std::move(keys[next]);
+					values[hole] = std::move(values[next]);
+					hole = next;
+				}
+			}
+
+			keys[hole] = TKey();
+			values[hole] = TValue();
+			states[hole] = 0;
+			count--;
+			return true;
+		}
+
+		//Calls func(key, value) for every entry, in slot order.
+		template <typename TFunc>
+		void ForEach(TFunc func) {
+			for (size_t i = 0; i < states.size(); i++) {
+				if (states[i] != 0) {
+					func(keys[i], values[i]);
+				}
+			}
+		}
+
+		template <typename TFunc>
+		void ForEach(TFunc func) const {
+			for (size_t i = 0; i < states.size(); i++) {
+				if (states[i] != 0) {
+					func(keys[i], values[i]);
+				}
+			}
+		}
+
+	private:
+		static constexpr size_t MinCapacity = 16;
+
+		std::vector<TKey> keys;
+		std::vector<TValue> values;
+		std::vector<uint8_t> states;
+		size_t count{ 0 };
+		uint32_t shift{ 64 };
+		THash hasher;
+		TEqual equal;
+
+		size_t Index(TKey const& key) const {
+			return static_cast<size_t>((static_cast<uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull) >> shift);
+		}
+
+		//Returns true and the slot of 'key' if it exists, otherwise false and the empty slot where it belongs.
+		bool FindSlot(TKey const& key, size_t& slot) const {
+			if (states.empty()) {
+				slot = 0;
+				return false;
+			}
+
+			size_t mask = states.size() - 1;
+
+			for (size_t i = Index(key); ; i = (i + 1) & mask) {
+				if (states[i] == 0) {
+					slot = i;
+					return false;
+				}
+
+				if (equal(keys[i], key)) {
+					slot = i;
+					return true;
+				}
+			}
+		}
+
+		//Stores 'key' in the empty slot returned by FindSlot, growing the table first if needed.
+		size_t InsertAt(TKey const& key, size_t slot) {
+			if (states.empty() || count + 1 > states.size() - states.size() / 4) {
+				Rehash(states.empty() ? MinCapacity : states.size() * 2);
+				FindSlot(key, slot);
+			}
+
+			keys[slot] = key;
+			states[slot] = 1;
+			count++;
+			return slot;
+		}
+
+		void Rehash(size_t capacity) {
+			std::vector<TKey> oldKeys(capacity);
+			std::vector<TValue> oldValues(capacity);
+			std::vector<uint8_t> oldStates(capacity, 0);
+
+			keys.swap(oldKeys);
+			values.swap(oldValues);
+			states.swap(oldStates);
+
+			shift = 64;
+			for (size_t c = capacity; c > 1; c >>= 1) {
+				shift--;
+			}
+
+			size_t mask = capacity - 1;
+
+			for (size_t i = 0; i < oldStates.size(); i++) {
+				if (oldStates[i] == 0) {
+					continue;
+				}
+
+				size_t slot = Index(oldKeys[i]);
+				while (states[slot] != 0) {
+					slot = (slot + 1) & mask;
+				}
+
+				keys[slot] = std::move(oldKeys[i]);
+				values[slot] = std::move(oldValues[i]);
+				states[slot] = 1;
+			}
+		}
+	};
+
+	//Set counterpart of FlatHashMap, with the same probing and invalidation rules.
+	template <typename TKey, typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+	class FlatHashSet {
+	public:
+		FlatHashSet() {}
+		FlatHashSet(size_t capacity) : map(capacity) {}
+
+		size_t Count() const { return map.Count(); }
+		bool IsEmpty() const { return map.IsEmpty(); }
+		size_t Capacity() const { return map.Capacity(); }
+		void Clear() { map.Clear(); }
+		void Reserve(size_t capacity) { map.Reserve(capacity); }
+
+		//Returns false if the key was already in the set.
+		bool Add(TKey const& key) { return map.Insert(key, Empty()); }
+		bool Contains(TKey const& key) const { return map.ContainsKey(key); }
+		bool Remove(TKey const& key) { return map.Remove(key); }
+
+		//Calls func(key) for every key, in slot order.
+		template <typename TFunc>
+		void ForEach(TFunc func) const {
+			map.ForEach([&func](TKey const& key, Empty const&) { func(key); });
+		}
+
+	private:
+		struct Empty {};
+
+		FlatHashMap<TKey, Empty, THash, TEqual> map;
+	};
+}
+
+#endif
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "Game.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <mmsystem.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+namespace Xna {
+
+	//Weights of a new oversleep sample in the smoothed mean and deviation, as in the TCP round trip estimator.
+	static constexpr double OversleepGain = 1.0 / 8.0;
+	static constexpr double DeviationGain = 1.0 / 4.0;
+
+	void TimingStats::Add(TimeSpan duration) {
+		if (Count == 0 || duration < Min) {
+			Min = duration;
+		}
+
+		if (Count == 0 || duration > Max) {
+			Max = duration;
+		}
+
+		Count++;
+		Total += duration;
+		Last = duration;
+	}
+
+	TimeSpan TimingStats::Average() const {
+		return Count == 0 ? TimeSpan(0) : Total / Count;
+	}
+
+	void TimingStats::Reset() {
+		*this = TimingStats();
+	}
+
+	void GameStats::Reset() {
+		*this = GameStats();
+	}
+
+	/*
+	 Sets the Windows timer to 1 ms while it lives. The default 15.6 ms period rounds every sleep up to a
+	 tick, which is most of a 60 Hz frame; elsewhere sleeps are already that precise.
+	*/
+	class TimerResolution {
+	public:
+		TimerResolution() {
+#ifdef _WIN32
+			raised = timeBeginPeriod(1) == TIMERR_NOERROR;
+#endif
+		}
+
+		~TimerResolution() {
+#ifdef _WIN32
+			if (raised) {
+				timeEndPeriod(1);
+			}
+#endif
+		}
+
+		TimerResolution(TimerResolution const&) = delete;
+		TimerResolution& operator= (TimerResolution const&) = delete;
+
+	private:
+		bool raised{ false };
+	};
+
+	Game::Game() {}
+	Game::~Game() {}
+
+	void Game::Initialize() {
+		Components.Initialize();
+	}
+
+	void Game::BeginRun() {}
+	void Game::EndRun() {}
+
+	void Game::Update(GameTime const& gameTime) {
+		Components.Update(gameTime);
+	}
+
+	bool Game::BeginDraw() { return true; }
+	void Game::Draw(GameTime const&) {}
+	void Game::EndDraw() {}
+
+	void Game::Run() {
+		TimerResolution resolution;
+
+		DoInitialize();
+		BeginRun();
+
+		while (!shouldExit) {
+			Tick();
+		}
+
+		shouldExit = false;
+		EndRun();
+	}
+
+	void Game::RunOneFrame() {
+		DoInitialize();
+		BeginRun();
+		Tick();
+		EndRun();
+	}
+
+	void Game::Tick() {
+		Clock::time_point start = Clock::now();
+
+		Advance();
+
+		if (IsFixedTimeStep && accumulatedElapsedTime < TargetElapsedTime) {
+			WaitUntil(previousTime + (TargetElapsedTime - accumulatedElapsedTime));
+			Advance();
+			stats.Lateness.Add(accumulatedElapsedTime - TargetElapsedTime);
+		}
+
+		//Do not allow any update to take longer than our maximum.
+		if (accumulatedElapsedTime > MaxElapsedTime) {
+			stats.Dropped += accumulatedElapsedTime - MaxElapsedTime;
+			accumulatedElapsedTime = MaxElapsedTime;
+		}
+
+		if (IsFixedTimeStep) {
+			gameTime.ElapsedGameTime = TargetElapsedTime;
+			int32_t stepCount = 0;
+
+			while (accumulatedElapsedTime >= TargetElapsedTime && !shouldExit) {
+				gameTime.TotalGameTime += TargetElapsedTime;
+				accumulatedElapsedTime -= TargetElapsedTime;
+				stepCount++;
+
+				DoUpdate();
+			}
+
+			//Every update after the first accumulates lag.
+			updateFrameLag += std::max(0, stepCount - 1);
+
+			//Once running slowly, wait until the lag clears; start after 5 frames of lag.
+			if (gameTime.IsRunningSlowly) {
+				if (updateFrameLag == 0) {
+					gameTime.IsRunningSlowly = false;
+				}
+			}
+			else if (updateFrameLag >= 5) {
+				gameTime.IsRunningSlowly = true;
+			}
+
+			//A frame with exactly one update is on time, so it pays back some lag.
+			if (stepCount == 1 && updateFrameLag > 0) {
+				updateFrameLag--;
+			}
+
+			//Draw needs to know the time covered by the updates of the frame.
+			gameTime.ElapsedGameTime = TargetElapsedTime * stepCount;
+		}
+		else {
+			gameTime.ElapsedGameTime = accumulatedElapsedTime;
+			gameTime.TotalGameTime += accumulatedElapsedTime;
+			accumulatedElapsedTime = TimeSpan(0);
+
+			DoUpdate();
+		}
+
+		if (suppressDraw) {
+			suppressDraw = false;
+		}
+		else {
+			DoDraw();
+		}
+
+		stats.Tick.Add(std::chrono::duration_cast<TimeSpan>(Clock::now() - start));
+	}
+
+	void Game::Exit() {
+		shouldExit = true;
+		suppressDraw = true;
+	}
+
+	void Game::ResetElapsedTime() {
+		previousTime = Clock::now();
+		timerStarted = true;
+		accumulatedElapsedTime = TimeSpan(0);
+		gameTime.ElapsedGameTime = TimeSpan(0);
+	}
+
+	void Game::SuppressDraw() {
+		suppressDraw = true;
+	}
+
+	GameStats const& Game::Stats() const {
+		return stats;
+	}
+
+	void Game::ResetStats() {
+		stats.Reset();
+	}
+
+	void Game::DoInitialize() {
+		if (initialized) {
+			return;
+		}
+
+		Initialize();
+		initialized = true;
+		ResetElapsedTime();
+	}
+
+	void Game::DoUpdate() {
+		Clock::time_point start = Clock::now();
+		Update(gameTime);
+		stats.Update.Add(std::chrono::duration_cast<TimeSpan>(Clock::now() - start));
+	}
+
+	void Game::DoDraw() {
+		Clock::time_point start = Clock::now();
+
+		if (BeginDraw()) {
+			Draw(gameTime);
+			EndDraw();
+		}
+
+		stats.Draw.Add(std::chrono::duration_cast<TimeSpan>(Clock::now() - start));
+	}
+
+	//Adds the time since the last call to the accumulator.
+	void Game::Advance() {
+		Clock::time_point now = Clock::now();
+
+		if (!timerStarted) {
+			previousTime = now;
+			timerStarted = true;
+		}
+
+		accumulatedElapsedTime += std::chrono::duration_cast<TimeSpan>(now - previousTime);
+		previousTime = now;
+	}
+
+	/*
+	 Sleeps until the deadline minus SpinTime and the expected oversleep, then yields until the deadline.
+	 Each sleep updates the estimate of the oversleep, which keeps the wake up ahead of the deadline; it
+	 is small only with a fine OS timer, hence the resolution raised by Run on Windows.
+	*/
+	void Game::WaitUntil(Clock::time_point deadline) {
+		Clock::time_point now = Clock::now();
+		TimeSpan margin = SpinTime + TimeSpan(static_cast<int64_t>(oversleep + 4.0 * oversleepDeviation));
+
+		if (deadline - now > margin) {
+			TimeSpan request = std::chrono::duration_cast<TimeSpan>(deadline - now - margin);
+			std::this_thread::sleep_for(request);
+
+			Clock::time_point woken = Clock::now();
+			TimeSpan slept = std::chrono::duration_cast<TimeSpan>(woken - now);
+			double error = static_cast<double>((slept - request).count()) - oversleep;
+
+			oversleep += OversleepGain * error;
+			oversleepDeviation += DeviationGain * (std::fabs(error) - oversleepDeviation);
+			stats.Sleep.Add(slept);
+			now = woken;
+		}
+
+		Clock::time_point spinStart = now;
+
+		while (now < deadline) {
+			std::this_thread::yield();
+			now = Clock::now();
+		}
+
+		stats.Spin.Add(std::chrono::duration_cast<TimeSpan>(now - spinStart));
+	}
+}
@@ -0,0 +1,119 @@
+#ifndef _GAME_H_
+#define _GAME_H_
+
+#include <chrono>
+#include <cstdint>
+#include "GameComponentCollection.hpp"
+#include "GameTime.hpp"
+
+namespace Xna {
+
+	//Count, total and extremes of the durations of one phase of the game loop.
+	struct TimingStats {
+		int64_t Count{ 0 };
+		TimeSpan Total{ 0 };
+		TimeSpan Min{ 0 };
+		TimeSpan Max{ 0 };
+		TimeSpan Last{ 0 };
+
+		void Add(TimeSpan duration);
+		TimeSpan Average() const;
+		void Reset();
+	};
+
+	struct GameStats {
+		//Whole Tick calls, waiting included.
+		TimingStats Tick;
+		TimingStats Update;
+		TimingStats Draw;
+		//Time given back to the OS, and time spent spinning on the clock, while waiting for the next step.
+		TimingStats Sleep;
+		TimingStats Spin;
+		//How late the fixed step loop woke up past the time of the step, i.e. the tick jitter.
+		TimingStats Lateness;
+		//Time dropped because it exceeded MaxElapsedTime.
+		TimeSpan Dropped{ 0 };
+
+		void Reset();
+	};
+
+	/*
+	 Headless port of the XNA game loop (MonoGame's Game.Tick): derive from Game, override Update and Draw,
+	 and call Run, which ticks until Exit is called.
+
+	 With IsFixedTimeStep, each tick waits until TargetElapsedTime has passed and then calls Update once per
+	 whole TargetElapsedTime accumulated, and Draw once. Time beyond MaxElapsedTime is dropped, so a stall
+	 cannot make the loop catch up forever. The wait sleeps until SpinTime (plus the usual oversleep of the
+	 OS, learned as the loop runs) before the deadline and yields on steady_clock for the rest, which keeps
+	 the jitter in the microseconds without spinning through the whole frame. On Windows, Run sets the
+	 timer resolution to 1 ms (timeBeginPeriod) until it returns, since at the default 15.6 ms the
+	 oversleep alone would be most of a frame; loops driven by RunOneFrame or Tick should do the same.
+	 Otherwise, each tick calls Update once with the time since the last one, and Draw.
+	*/
+	class Game {
+	public:
+		bool IsFixedTimeStep{ true };
+		//60 updates per second.
+		TimeSpan TargetElapsedTime{ 16666667 };
+		TimeSpan MaxElapsedTime{ std::chrono::milliseconds(500) };
+		//Time before the deadline of a step that is spun rather than slept.
+		TimeSpan SpinTime{ std::chrono::microseconds(500) };
+		//Initialized by Initialize and updated by Update; overrides should call the base versions.
+		GameComponentCollection Components;
+
+		Game();
+		virtual ~Game();
+
+		//Initializes the game on the first call, then ticks until Exit.
+		void Run();
+		//Initializes the game if needed and runs a single tick.
+		void RunOneFrame();
+		//Waits for the next step if needed, then updates and draws.
+		void Tick();
+
+		//Ends Run at the end of the current tick, without drawing it.
+		void Exit();
+		//Restarts the measure of the elapsed time, e.g. after a long blocking load.
+		void ResetElapsedTime();
+		//Skips the next Draw.
+		void SuppressDraw();
+
+		GameStats const& Stats() const;
+		void ResetStats();
+
+	protected:
+		//Called once, before the first tick.
+		virtual void Initialize();
+		virtual void BeginRun();
+		virtual void EndRun();
+		virtual void Update(GameTime const& gameTime);
+		//Can return false to skip Draw and EndDraw.
+		virtual bool BeginDraw();
+		virtual void Draw(GameTime const& gameTime);
+		virtual void EndDraw();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		GameTime gameTime;
+		GameStats stats;
+		Clock::time_point previousTime;
+		TimeSpan accumulatedElapsedTime{ 0 };
+		int32_t updateFrameLag{ 0 };
+		//Smoothed oversleep of the OS and its mean deviation, in nanoseconds.
+		double oversleep{ 0 };
+		double oversleepDeviation{ 0 };
+		bool initialized{ false };
+		bool timerStarted{ false };
+		bool shouldExit{ false };
+		bool suppressDraw{ false };
+
+		void DoInitialize();
+		void DoUpdate();
+		void DoDraw();
+		void Advance();
+		void WaitUntil(Clock::time_point deadline);
+	};
+}
+
+#endif
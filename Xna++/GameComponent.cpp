@@ -0,0 +1,83 @@
+#include <algorithm>
+#include "GameComponent.hpp"
+
+namespace Xna {
+
+	static void Insert(std::vector<uint32_t>& resources, uint32_t resource) {
+		auto position = std::lower_bound(resources.begin(), resources.end(), resource);
+
+		if (position == resources.end() || *position != resource) {
+			resources.insert(position, resource);
+		}
+	}
+
+	//Whether two sorted lists share an id.
+	static bool Overlap(std::vector<uint32_t> const& a, std::vector<uint32_t> const& b) {
+		size_t i = 0;
+		size_t j = 0;
+
+		while (i < a.size() && j < b.size()) {
+			if (a[i] < b[j]) {
+				i++;
+			}
+			else if (b[j] < a[i]) {
+				j++;
+			}
+			else {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	GameComponent::GameComponent() {}
+	GameComponent::~GameComponent() {}
+
+	void GameComponent::Initialize() {}
+	void GameComponent::Update(GameTime const&) {}
+
+	void GameComponent::AddRead(uint32_t resource) {
+		Insert(reads, resource);
+		hasDependencies = true;
+		version++;
+	}
+
+	void GameComponent::AddWrite(uint32_t resource) {
+		Insert(writes, resource);
+		hasDependencies = true;
+		version++;
+	}
+
+	void GameComponent::SetIndependent() {
+		hasDependencies = true;
+		version++;
+	}
+
+	void GameComponent::ClearDependencies() {
+		reads.clear();
+		writes.clear();
+		hasDependencies = false;
+		version++;
+	}
+
+	bool GameComponent::HasDependencies() const {
+		return hasDependencies;
+	}
+
+	std::vector<uint32_t> const& GameComponent::Reads() const {
+		return reads;
+	}
+
+	std::vector<uint32_t> const& GameComponent::Writes() const {
+		return writes;
+	}
+
+	bool GameComponent::ConflictsWith(GameComponent const& other) const {
+		if (!hasDependencies || !other.hasDependencies) {
+			return true;
+		}
+
+		return Overlap(writes, other.writes) || Overlap(writes, other.reads) || Overlap(reads, other.writes);
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef _GAMECOMPONENT_H_
+#define _GAMECOMPONENT_H_
+
+#include <cstdint>
+#include <vector>
+#include "GameTime.hpp"
+
+namespace Xna {
+
+	/*
+	 Updateable part of a game, run by a GameComponentCollection in UpdateOrder.
+	 A component can declare the shared resources (any ids the game picks, e.g. one per system or
+	 per data set) its Update reads and writes; the collection then runs it in parallel with the
+	 components it does not conflict with. A component that declares nothing is assumed to touch
+	 everything and runs alone, in order.
+	*/
+	class GameComponent {
+	public:
+		bool Enabled{ true };
+		int32_t UpdateOrder{ 0 };
+
+		GameComponent();
+		virtual ~GameComponent();
+
+		virtual void Initialize();
+		virtual void Update(GameTime const& gameTime);
+
+		void AddRead(uint32_t resource);
+		void AddWrite(uint32_t resource);
+		//Declares that Update touches no state shared with other components.
+		void SetIndependent();
+		//Back to running alone.
+		void ClearDependencies();
+
+		bool HasDependencies() const;
+		//Sorted, without duplicates.
+		std::vector<uint32_t> const& Reads() const;
+		std::vector<uint32_t> const& Writes() const;
+
+		//Whether the two components may not run at the same time.
+		bool ConflictsWith(GameComponent const& other) const;
+
+	private:
+		friend class GameComponentCollection;
+
+		std::vector<uint32_t> reads;
+		std::vector<uint32_t> writes;
+		bool hasDependencies{ false };
+		//Changed by every declaration, so that the collection knows when to rebuild its schedule.
+		uint32_t version{ 0 };
+	};
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include "GameComponentCollection.hpp"
+
+namespace Xna {
+
+	static constexpr size_t None = static_cast<size_t>(-1);
+
+	size_t GameComponentCollection::Count() const {
+		return components.size();
+	}
+
+	GameComponent* GameComponentCollection::operator[](size_t index) const {
+		return components[index];
+	}
+
+	bool GameComponentCollection::Contains(GameComponent const* component) const {
+		return std::find(components.begin(), components.end(), component) != components.end();
+	}
+
+	bool GameComponentCollection::Add(GameComponent* component) {
+		if (component == nullptr || Contains(component)) {
+			return false;
+		}
+
+		components.push_back(component);
+		dirty = true;
+		return true;
+	}
+
+	bool GameComponentCollection::Remove(GameComponent const* component) {
+		auto position = std::find(components.begin(), components.end(), component);
+
+		if (position == components.end()) {
+			return false;
+		}
+
+		components.erase(position);
+		dirty = true;
+		return true;
+	}
+
+	void GameComponentCollection::Clear() {
+		components.clear();
+		dirty = true;
+	}
+
+	void GameComponentCollection::Initialize() {
+		for (size_t i = 0; i < components.size(); i++) {
+			components[i]->Initialize();
+		}
+	}
+
+	void GameComponentCollection::Update(GameTime const& gameTime) {
+		Refresh();
+
+		if (!parallel || Pool == nullptr || Pool->ThreadCount() < 2) {
+			for (size_t i = 0; i < ordered.size(); i++) {
+				ordered[i]->Update(gameTime);
+			}
+
+			return;
+		}
+
+		for (size_t i = 0; i < ordered.size(); i++) {
+			remaining[i].store(predecessors[i], std::memory_order_relaxed);
+		}
+
+		for (size_t i = 0; i < roots.size(); i++) {
+			size_t root = roots[i];
+			Pool->Submit([this, root, &gameTime] { Run(root, gameTime); });
+		}
+
+		Pool->Wait();
+	}
+
+	void GameComponentCollection::UpdateSerial(GameTime const& gameTime) {
+		Refresh();
+
+		for (size_t i = 0; i < ordered.size(); i++) {
+			ordered[i]->Update(gameTime);
+		}
+	}
+
+	//Rebuilds the order and the graph if a component was added, removed or changed since the last call.
+	void GameComponentCollection::Refresh() {
+		bool changed = dirty || keys.size() != components.size();
+
+		keys.resize(components.size());
+
+		for (size_t i = 0; i < components.size(); i++) {
+			GameComponent const& component = *components[i];
+			Key& key = keys[i];
+
+			if (key.Component != &component || key.UpdateOrder != component.UpdateOrder
+				|| key.Version != component.version || key.Enabled != component.Enabled) {
+
+				key = Key{ &component, component.UpdateOrder, component.version, component.Enabled };
+				changed = true;
+			}
+		}
+
+		if (changed) {
+			Build();
+			dirty = false;
+		}
+	}
+
+	/*
+	 Each component depends on every earlier component it conflicts with. Running a component only
+	 after all of those keeps every pair of conflicting components in their serial order.
+	*/
+	void GameComponentCollection::Build() {
+		ordered.clear();
+		parallel = false;
+
+		for (size_t i = 0; i < components.size(); i++) {
+			if (components[i]->Enabled) {
+				ordered.push_back(components[i]);
+				parallel = parallel || components[i]->HasDependencies();
+			}
+		}
+
+		std::stable_sort(ordered.begin(), ordered.end(), [](GameComponent const* a, GameComponent const* b) {
+			return a->UpdateOrder < b->UpdateOrder;
+		});
+
+		size_t count = ordered.size();
+		parallel = parallel && count > 1;
+
+		successors.assign(count, std::vector<size_t>());
+		predecessors.assign(count, 0);
+		remaining.reset(new std::atomic<int32_t>[count]);
+		roots.clear();
+
+		if (!parallel) {
+			return;
+		}
+
+		for (size_t j = 0; j < count; j++) {
+			for (size_t i = 0; i < j; i++) {
+				if (ordered[i]->ConflictsWith(*ordered[j])) {
+					successors[i].push_back(j);
+					predecessors[j]++;
+				}
+			}
+
+			if (predecessors[j] == 0) {
+				roots.push_back(j);
+			}
+		}
+	}
+
+	//Updates the component, then submits the successors it made ready and carries on with the first of them.
+	void GameComponentCollection::Run(size_t index, GameTime const& gameTime) {
+		while (index != None) {
+			ordered[index]->Update(gameTime);
+
+			size_t next = None;
+			std::vector<size_t> const& after = successors[index];
+
+			for (size_t i = 0; i < after.size(); i++) {
+				size_t successor = after[i];
+
+				if (remaining[successor].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+					continue;
+				}
+
+				if (next == None) {
+					next = successor;
+				}
+				else {
+					Pool->Submit([this, successor, &gameTime] { Run(successor, gameTime); });
+				}
+			}
+
+			index = next;
+		}
+	}
+}
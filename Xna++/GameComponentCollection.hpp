@@ -0,0 +1,68 @@
+#ifndef _GAMECOMPONENTCOLLECTION_H_
+#define _GAMECOMPONENTCOLLECTION_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "GameComponent.hpp"
+#include "GameTime.hpp"
+#include "ThreadPool.hpp"
+
+namespace Xna {
+
+	/*
+	 Components of a game, which must outlive their membership (the collection does not own them).
+
+	 Update calls the enabled components in UpdateOrder (ties in the order they were added), like XNA.
+	 When Pool is set and some components declare their dependencies, the order becomes a graph instead:
+	 each component waits only for the earlier components it conflicts with, and the ready ones run on
+	 the pool. The result is the same as the serial order. Enabled, UpdateOrder and the dependencies are
+	 read at the start of Update, and the graph is only rebuilt when one of them changed.
+	*/
+	class GameComponentCollection {
+	public:
+		//null runs every Update serially.
+		ThreadPool* Pool{ nullptr };
+
+		size_t Count() const;
+		GameComponent* operator[](size_t index) const;
+		bool Contains(GameComponent const* component) const;
+
+		//Returns false if component is null or already in the collection.
+		bool Add(GameComponent* component);
+		bool Remove(GameComponent const* component);
+		void Clear();
+
+		void Initialize();
+		void Update(GameTime const& gameTime);
+		//Same calls, in order, on the calling thread.
+		void UpdateSerial(GameTime const& gameTime);
+
+	private:
+		struct Key {
+			GameComponent const* Component;
+			int32_t UpdateOrder;
+			uint32_t Version;
+			bool Enabled;
+		};
+
+		std::vector<GameComponent*> components;
+		//Enabled components in update order, and the graph between them.
+		std::vector<GameComponent*> ordered;
+		std::vector<std::vector<size_t>> successors;
+		std::vector<int32_t> predecessors;
+		std::unique_ptr<std::atomic<int32_t>[]> remaining;
+		std::vector<size_t> roots;
+		std::vector<Key> keys;
+		bool parallel{ false };
+		bool dirty{ true };
+
+		void Refresh();
+		void Build();
+		void Run(size_t index, GameTime const& gameTime);
+	};
+}
+
+#endif
@@ -0,0 +1,10 @@
+#include "GameTime.hpp"
+
+namespace Xna {
+
+	GameTime::GameTime() {}
+	GameTime::GameTime(TimeSpan totalGameTime, TimeSpan elapsedGameTime) :
+		TotalGameTime(totalGameTime), ElapsedGameTime(elapsedGameTime) {}
+	GameTime::GameTime(TimeSpan totalGameTime, TimeSpan elapsedGameTime, bool isRunningSlowly) :
+		TotalGameTime(totalGameTime), ElapsedGameTime(elapsedGameTime), IsRunningSlowly(isRunningSlowly) {}
+}
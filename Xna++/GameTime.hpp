@@ -0,0 +1,26 @@
+#ifndef _GAMETIME_H_
+#define _GAMETIME_H_
+
+#include <chrono>
+
+namespace Xna {
+
+	//Game time spans, with the 100 ns resolution of the .NET TimeSpan refined to 1 ns.
+	using TimeSpan = std::chrono::nanoseconds;
+
+	class GameTime {
+	public:
+		//Game time since the start of the game.
+		TimeSpan TotalGameTime{ 0 };
+		//Game time since the last update (or, in Draw, the time covered by the updates of the frame).
+		TimeSpan ElapsedGameTime{ 0 };
+		//True while the fixed step loop cannot keep up with TargetElapsedTime.
+		bool IsRunningSlowly{ false };
+
+		GameTime();
+		GameTime(TimeSpan totalGameTime, TimeSpan elapsedGameTime);
+		GameTime(TimeSpan totalGameTime, TimeSpan elapsedGameTime, bool isRunningSlowly);
+	};
+}
+
+#endif
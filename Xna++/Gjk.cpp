@@ -0,0 +1,671 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "Gjk.hpp"
+
+namespace Xna {
+
+	//The distance has converged when |v|^2 - v.w falls below this fraction of |v|^2.
+	static constexpr double RelativeTolerance = 1e-10;
+	//Squared distance, relative to the simplex size, under which the origin is on the simplex.
+	static constexpr double ContactTolerance = 1e-20;
+	static constexpr double EpaTolerance = 1e-8;
+	static constexpr size_t EpaMaxFaces = 256;
+
+	//Vertex of the Minkowski difference a - b, with the points of a and b that produced it.
+	struct SupportPoint {
+		Vector3 W;
+		Vector3 A;
+		Vector3 B;
+		Vector3 Direction;
+	};
+
+	struct Simplex {
+		SupportPoint V[4];
+		//Barycentric coordinates of the point closest to the origin.
+		double L[4];
+		int32_t Count{ 0 };
+	};
+
+	//With cores, of the shapes without their Radius.
+	static SupportPoint Support(ConvexShape const& a, ConvexShape const& b, bool cores, Vector3 const& direction) {
+		SupportPoint p;
+		p.Direction = direction;
+		p.A = cores ? a.CoreSupport(direction) : a.Support(direction);
+		p.B = cores ? b.CoreSupport(-direction) : b.Support(-direction);
+		p.W = p.A - p.B;
+		return p;
+	}
+
+	static double LengthSquared(Vector3 const& v) {
+		return Vector3::Dot(v, v);
+	}
+
+	static Vector3 ClosestPoint(Simplex const& s) {
+		Vector3 v;
+
+		for (int32_t i = 0; i < s.Count; i++) {
+			v += s.V[i].W * s.L[i];
+		}
+
+		return v;
+	}
+
+	static void Keep(Simplex& s, int32_t i0) {
+		s.V[0] = s.V[i0];
+		s.L[0] = 1;
+		s.Count = 1;
+	}
+
+	static void Keep(Simplex& s, int32_t i0, int32_t i1, double t) {
+		SupportPoint v0 = s.V[i0];
+		SupportPoint v1 = s.V[i1];
+		s.V[0] = v0;
+		s.V[1] = v1;
+		s.L[0] = 1 - t;
+		s.L[1] = t;
+		s.Count = 2;
+	}
+
+	static void ReduceSegment(Simplex& s) {
+		Vector3 a = s.V[0].W;
+		Vector3 ab = s.V[1].W - a;
+		double length = LengthSquared(ab);
+		double t = length > 0 ? -Vector3::Dot(a, ab) / length : 0;
+
+		if (t <= 0) {
+			Keep(s, 0);
+		}
+		else if (t >= 1) {
+			Keep(s, 1);
+		}
+		else {
+			Keep(s, 0, 1, t);
+		}
+	}
+
+	//Ericson, Real-Time Collision Detection 5.1.5, for the origin.
+	static void ReduceTriangle(Simplex& s) {
+		Vector3 a = s.V[0].W;
+		Vector3 b = s.V[1].W;
+		Vector3 c = s.V[2].W;
+		Vector3 ab = b - a;
+		Vector3 ac = c - a;
+
+		double d1 = -Vector3::Dot(ab, a);
+		double d2 = -Vector3::Dot(ac, a);
+		if (d1 <= 0 && d2 <= 0) {
+			Keep(s, 0);
+			return;
+		}
+
+		double d3 = -Vector3::Dot(ab, b);
+		double d4 = -Vector3::Dot(ac, b);
+		if (d3 >= 0 && d4 <= d3) {
+			Keep(s, 1);
+			return;
+		}
+
+		double vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+			Keep(s, 0, 1, d1 / (d1 - d3));
+			return;
+		}
+
+		double d5 = -Vector3::Dot(ab, c);
+		double d6 = -Vector3::Dot(ac, c);
+		if (d6 >= 0 && d5 <= d6) {
+			Keep(s, 2);
+			return;
+		}
+
+		double vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+			Keep(s, 0, 2, d2 / (d2 - d6));
+			return;
+		}
+
+		double va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+			Keep(s, 1, 2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+			return;
+		}
+
+		double sum = va + vb + vc;
+
+		//Collinear vertices: the closest point is on one of the edges.
+		if (!(sum > 0)) {
+			Simplex best;
+			double bestDistance = std::numeric_limits<double>::infinity();
+			int32_t edges[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+			for (auto const& edge : edges) {
+				Simplex candidate;
+				candidate.V[0] = s.V[edge[0]];
+				candidate.V[1] = s.V[edge[1]];
+				candidate.Count = 2;
+				ReduceSegment(candidate);
+
+				double distance = LengthSquared(ClosestPoint(candidate));
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					best = candidate;
+				}
+			}
+
+			s = best;
+			return;
+		}
+
+		s.L[1] = vb / sum;
+		s.L[2] = vc / sum;
+		s.L[0] = 1 - s.L[1] - s.L[2];
+	}
+
+	//Returns true if the origin is inside the tetrahedron, leaving it whole; otherwise reduces to the closest face.
+	static bool ReduceTetrahedron(Simplex& s) {
+		int32_t faces[4][4] = { { 0, 1, 2, 3 }, { 0, 1, 3, 2 }, { 0, 2, 3, 1 }, { 1, 2, 3, 0 } };
+		bool inside = true;
+		Simplex best;
+		double bestDistance = std::numeric_limits<double>::infinity();
+
+		for (auto const& face : faces) {
+			Vector3 a = s.V[face[0]].W;
+			Vector3 n = Vector3::Cross(s.V[face[1]].W - a, s.V[face[2]].W - a);
+			Vector3 opposite = s.V[face[3]].W - a;
+			double sideOrigin = -Vector3::Dot(n, a);
+			double sideOpposite = Vector3::Dot(n, opposite);
+			bool flat = std::fabs(sideOpposite) <= 1e-12 * std::sqrt(LengthSquared(n) * LengthSquared(opposite));
+
+			if (!flat && sideOrigin * sideOpposite >= 0) {
+				continue;
+			}
+
+			inside = false;
+
+			Simplex candidate;
+			candidate.V[0] = s.V[face[0]];
+			candidate.V[1] = s.V[face[1]];
+			candidate.V[2] = s.V[face[2]];
+			candidate.Count = 3;
+			ReduceTriangle(candidate);
+
+			double distance = LengthSquared(ClosestPoint(candidate));
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				best = candidate;
+			}
+		}
+
+		if (inside) {
+			return true;
+		}
+
+		s = best;
+		return false;
+	}
+
+	//Reduces the simplex to the smallest one holding its point closest to the origin. Returns true if it encloses the origin.
+	static bool Reduce(Simplex& s) {
+		switch (s.Count) {
+		case 1:
+			s.L[0] = 1;
+			return false;
+		case 2:
+			ReduceSegment(s);
+			return false;
+		case 3:
+			ReduceTriangle(s);
+			return false;
+		default:
+			return ReduceTetrahedron(s);
+		}
+	}
+
+	static bool Contains(Simplex const& s, Vector3 const& w) {
+		for (int32_t i = 0; i < s.Count; i++) {
+			if (LengthSquared(s.V[i].W - w) <= ContactTolerance * (1 + LengthSquared(w))) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	static double Scale(Simplex const& s) {
+		double scale = 0;
+
+		for (int32_t i = 0; i < s.Count; i++) {
+			scale = std::max(scale, LengthSquared(s.V[i].W));
+		}
+
+		return scale;
+	}
+
+	/*
+	 The GJK loop. Returns true if the shapes (their cores with cores) intersect, with the final simplex in s.
+	 With overlapOnly, returns as soon as a separating axis is found.
+	*/
+	static bool Run(ConvexShape const& a, ConvexShape const& b, bool cores, GjkCache& cache, bool overlapOnly, Simplex& s, int32_t& iterations) {
+		s.Count = 0;
+		iterations = 0;
+
+		if (overlapOnly && cache.HasSeparatingAxis) {
+			Vector3 axis = cache.SeparatingAxis;
+
+			if (Vector3::Dot(axis, Support(a, b, cores, -axis).W) > 0) {
+				return false;
+			}
+		}
+
+		for (int32_t i = 0; i < cache.Count && i < 4; i++) {
+			SupportPoint p = Support(a, b, cores, cache.Directions[i]);
+
+			if (!Contains(s, p.W)) {
+				s.V[s.Count++] = p;
+			}
+		}
+
+		if (s.Count == 0) {
+			Vector3 direction = b.Position - a.Position;
+
+			if (LengthSquared(direction) == 0) {
+				direction = Vector3(1, 0, 0);
+			}
+
+			s.V[s.Count++] = Support(a, b, cores, direction);
+		}
+
+		bool intersecting = Reduce(s);
+		bool separated = false;
+		Vector3 v = ClosestPoint(s);
+
+		while (!intersecting && iterations < Gjk::MaxIterations) {
+			double vv = LengthSquared(v);
+
+			if (vv <= ContactTolerance * Scale(s)) {
+				intersecting = true;
+				break;
+			}
+
+			iterations++;
+			SupportPoint p = Support(a, b, cores, -v);
+			double vw = Vector3::Dot(v, p.W);
+
+			if (overlapOnly && vw > 0) {
+				separated = true;
+				break;
+			}
+
+			if (vv - vw <= RelativeTolerance * vv || Contains(s, p.W)) {
+				separated = vw > 0;
+				break;
+			}
+
+			s.V[s.Count++] = p;
+			intersecting = Reduce(s);
+
+			Vector3 next = ClosestPoint(s);
+
+			//No progress: numerical limit reached on a separated pair.
+			if (!intersecting && LengthSquared(next) >= vv) {
+				break;
+			}
+
+			v = next;
+		}
+
+		cache.Count = s.Count;
+		cache.HasSeparatingAxis = separated;
+		cache.SeparatingAxis = v;
+
+		for (int32_t i = 0; i < s.Count; i++) {
+			cache.Directions[i] = s.V[i].Direction;
+		}
+
+		return intersecting;
+	}
+
+	struct EpaFace {
+		int32_t I[3];
+		Vector3 Normal;
+		double Distance;
+	};
+
+	static bool MakeFace(std::vector<SupportPoint> const& vertices, int32_t i0, int32_t i1, int32_t i2, EpaFace& face) {
+		Vector3 a = vertices[i0].W;
+		Vector3 n = Vector3::Cross(vertices[i1].W - a, vertices[i2].W - a);
+		double length = std::sqrt(LengthSquared(n));
+
+		if (!(length > 0)) {
+			return false;
+		}
+
+		face.I[0] = i0;
+		face.I[1] = i1;
+		face.I[2] = i2;
+		face.Normal = n / length;
+		face.Distance = Vector3::Dot(face.Normal, a);
+		return true;
+	}
+
+	static double Volume(Simplex const& s) {
+		Vector3 a = s.V[0].W;
+		return Vector3::Dot(s.V[3].W - a, Vector3::Cross(s.V[1].W - a, s.V[2].W - a));
+	}
+
+	//Grows a GJK simplex that touches the origin into a tetrahedron. Returns false if the difference is flat.
+	static bool Inflate(ConvexShape const& a, ConvexShape const& b, bool cores, Simplex& s) {
+		static const Vector3 axes[] = {
+			Vector3(1, 0, 0), Vector3(-1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0), Vector3(0, 0, 1), Vector3(0, 0, -1)
+		};
+
+		if (s.Count == 1) {
+			for (Vector3 const& axis : axes) {
+				SupportPoint p = Support(a, b, cores, axis);
+
+				if (!Contains(s, p.W)) {
+					s.V[s.Count++] = p;
+					break;
+				}
+			}
+		}
+
+		if (s.Count == 2) {
+			Vector3 d = s.V[1].W - s.V[0].W;
+			Vector3 ad(std::fabs(d.X), std::fabs(d.Y), std::fabs(d.Z));
+			Vector3 axis = ad.X <= ad.Y && ad.X <= ad.Z ? axes[0] : (ad.Y <= ad.Z ? axes[2] : axes[4]);
+			Vector3 e1 = Vector3::Cross(d, axis);
+			Vector3 e2 = Vector3::Cross(d, e1);
+			Vector3 candidates[] = { e1, -e1, e2, -e2 };
+
+			for (Vector3 const& direction : candidates) {
+				SupportPoint p = Support(a, b, cores, direction);
+				Vector3 n = Vector3::Cross(d, p.W - s.V[0].W);
+
+				if (LengthSquared(n) > ContactTolerance * LengthSquared(d) * (1 + LengthSquared(p.W))) {
+					s.V[s.Count++] = p;
+					break;
+				}
+			}
+		}
+
+		if (s.Count == 3) {
+			Vector3 n = Vector3::Cross(s.V[1].W - s.V[0].W, s.V[2].W - s.V[0].W);
+			Vector3 candidates[] = { n, -n };
+
+			for (Vector3 const& direction : candidates) {
+				s.V[3] = Support(a, b, cores, direction);
+				s.Count = 4;
+
+				if (std::fabs(Volume(s)) > 1e-14 * (1 + Scale(s)) * std::sqrt(Scale(s))) {
+					break;
+				}
+
+				s.Count = 3;
+			}
+		}
+
+		return s.Count == 4 && Volume(s) != 0;
+	}
+
+	static void Barycentric(Vector3 const& p, Vector3 const& a, Vector3 const& b, Vector3 const& c, double& u, double& v, double& w) {
+		Vector3 v0 = b - a;
+		Vector3 v1 = c - a;
+		Vector3 v2 = p - a;
+		double d00 = Vector3::Dot(v0, v0);
+		double d01 = Vector3::Dot(v0, v1);
+		double d11 = Vector3::Dot(v1, v1);
+		double d20 = Vector3::Dot(v2, v0);
+		double d21 = Vector3::Dot(v2, v1);
+		double denominator = d00 * d11 - d01 * d01;
+
+		if (!(denominator > 0)) {
+			u = 1;
+			v = 0;
+			w = 0;
+			return;
+		}
+
+		v = (d11 * d20 - d01 * d21) / denominator;
+		w = (d00 * d21 - d01 * d20) / denominator;
+		u = 1 - v - w;
+	}
+
+	//Expanding polytope algorithm, from the tetrahedron enclosing the origin.
+	static void Epa(ConvexShape const& a, ConvexShape const& b, bool cores, Simplex const& s, GjkResult& result) {
+		std::vector<SupportPoint> vertices(s.V, s.V + 4);
+		std::vector<EpaFace> faces;
+		int32_t initial[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+		Vector3 centroid = (s.V[0].W + s.V[1].W + s.V[2].W + s.V[3].W) * 0.25;
+
+		for (auto const& f : initial) {
+			EpaFace face;
+
+			if (!MakeFace(vertices, f[0], f[1], f[2], face)) {
+				continue;
+			}
+
+			if (Vector3::Dot(face.Normal, vertices[f[0]].W - centroid) < 0) {
+				MakeFace(vertices, f[0], f[2], f[1], face);
+			}
+
+			faces.push_back(face);
+		}
+
+		size_t closest = 0;
+		std::vector<int32_t> edges;
+
+		for (int32_t iteration = 0; iteration < Gjk::MaxIterations && !faces.empty(); iteration++) {
+			closest = 0;
+
+			for (size_t i = 1; i < faces.size(); i++) {
+				if (faces[i].Distance < faces[closest].Distance) {
+					closest = i;
+				}
+			}
+
+			EpaFace const best = faces[closest];
+			SupportPoint p = Support(a, b, cores, best.Normal);
+			double distance = Vector3::Dot(p.W, best.Normal);
+
+			result.Iterations++;
+
+			if (distance - best.Distance <= EpaTolerance * (1 + std::fabs(distance)) || faces.size() >= EpaMaxFaces) {
+				break;
+			}
+
+			int32_t index = static_cast<int32_t>(vertices.size());
+			vertices.push_back(p);
+			edges.clear();
+
+			//Removes the faces seen from p, keeping the edges of the hole (those not shared by two removed faces).
+			for (size_t i = 0; i < faces.size();) {
+				EpaFace const& face = faces[i];
+
+				if (Vector3::Dot(face.Normal, p.W - vertices[face.I[0]].W) <= 0) {
+					i++;
+					continue;
+				}
+
+				for (int32_t e = 0; e < 3; e++) {
+					int32_t from = face.I[e];
+					int32_t to = face.I[(e + 1) % 3];
+					bool shared = false;
+
+					for (size_t k = 0; k < edges.size(); k += 2) {
+						if (edges[k] == to && edges[k + 1] == from) {
+							edges.erase(edges.begin() + k, edges.begin() + k + 2);
+							shared = true;
+							break;
+						}
+					}
+
+					if (!shared) {
+						edges.push_back(from);
+						edges.push_back(to);
+					}
+				}
+
+				faces[i] = faces.back();
+				faces.pop_back();
+			}
+
+			if (edges.empty()) {
+				faces.push_back(best);
+				break;
+			}
+
+			for (size_t k = 0; k < edges.size(); k += 2) {
+				EpaFace face;
+
+				if (MakeFace(vertices, edges[k], edges[k + 1], index, face)) {
+					faces.push_back(face);
+				}
+			}
+		}
+
+		if (faces.empty()) {
+			return;
+		}
+
+		closest = 0;
+		for (size_t i = 1; i < faces.size(); i++) {
+			if (faces[i].Distance < faces[closest].Distance) {
+				closest = i;
+			}
+		}
+
+		EpaFace const& face = faces[closest];
+		SupportPoint const& v0 = vertices[face.I[0]];
+		SupportPoint const& v1 = vertices[face.I[1]];
+		SupportPoint const& v2 = vertices[face.I[2]];
+		double u, v, w;
+		Barycentric(face.Normal * face.Distance, v0.W, v1.W, v2.W, u, v, w);
+
+		result.Distance = face.Distance;
+		result.Normal = face.Normal;
+		result.PointA = v0.A * u + v1.A * v + v2.A * w;
+		result.PointB = v0.B * u + v1.B * v + v2.B * w;
+	}
+
+	/*
+	 Contact of cores that overlap without volume (crossing segments, a point on a segment, coincident
+	 points), where EPA has no depth to measure: the normal is across the flat difference, or along the
+	 centers if it is a point, and the points are those of the origin in the simplex.
+	*/
+	static void FlatContact(ConvexShape const& a, ConvexShape const& b, Simplex const& s, GjkResult& result) {
+		Vector3 centers = b.Position - a.Position;
+		Vector3 normal = LengthSquared(centers) > 0 ? centers : Vector3(1, 0, 0);
+		int32_t count = std::min<int32_t>(s.Count, 3);
+		double weights[3] = { 1, 0, 0 };
+
+		if (count == 3) {
+			Vector3 n = Vector3::Cross(s.V[1].W - s.V[0].W, s.V[2].W - s.V[0].W);
+
+			if (LengthSquared(n) > 0) {
+				normal = n;
+			}
+
+			Barycentric(Vector3(), s.V[0].W, s.V[1].W, s.V[2].W, weights[0], weights[1], weights[2]);
+		}
+		else if (count == 2) {
+			Vector3 d = s.V[1].W - s.V[0].W;
+			double length = LengthSquared(d);
+			Vector3 across = length > 0 ? normal - d * (Vector3::Dot(normal, d) / length) : normal;
+
+			//Centers along the segment: any direction across it.
+			if (!(LengthSquared(across) > ContactTolerance * LengthSquared(normal))) {
+				Vector3 ad(std::fabs(d.X), std::fabs(d.Y), std::fabs(d.Z));
+				across = Vector3::Cross(d, ad.X <= ad.Y && ad.X <= ad.Z ? Vector3(1, 0, 0) : (ad.Y <= ad.Z ? Vector3(0, 1, 0) : Vector3(0, 0, 1)));
+			}
+
+			normal = across;
+			weights[1] = length > 0 ? std::min(1.0, std::max(0.0, -Vector3::Dot(s.V[0].W, d) / length)) : 0;
+			weights[0] = 1 - weights[1];
+		}
+
+		if (Vector3::Dot(normal, centers) < 0) {
+			normal = -normal;
+		}
+
+		result.Distance = 0;
+		result.Normal = Vector3::Normalize(normal);
+
+		for (int32_t i = 0; i < count; i++) {
+			result.PointA += s.V[i].A * weights[i];
+			result.PointB += s.V[i].B * weights[i];
+		}
+	}
+
+	void GjkCache::Reset() {
+		Count = 0;
+		HasSeparatingAxis = false;
+	}
+
+	bool Gjk::Intersects(ConvexShape const& a, ConvexShape const& b, GjkCache& cache) {
+		Simplex s;
+		int32_t iterations = 0;
+		return Run(a, b, false, cache, true, s, iterations);
+	}
+
+	bool Gjk::Intersects(ConvexShape const& a, ConvexShape const& b) {
+		GjkCache cache;
+		return Intersects(a, b, cache);
+	}
+
+	/*
+	 The radii of capsules and spheres are margins: GJK, and EPA if needed, run on the segments and points
+	 of their cores, then the radii are taken off the distance (added to the depth) along the normal.
+	*/
+	bool Gjk::Query(ConvexShape const& a, ConvexShape const& b, GjkCache& cache, GjkResult& result) {
+		Simplex s;
+		result = GjkResult();
+
+		double margin = a.Radius() + b.Radius();
+		bool cores = margin > 0;
+
+		if (!Run(a, b, cores, cache, false, s, result.Iterations)) {
+			Vector3 v = ClosestPoint(s);
+			double distance = std::sqrt(LengthSquared(v));
+			result.Normal = distance > 0 ? -v / distance : Vector3();
+
+			for (int32_t i = 0; i < s.Count; i++) {
+				result.PointA += s.V[i].A * s.L[i];
+				result.PointB += s.V[i].B * s.L[i];
+			}
+
+			result.PointA += result.Normal * a.Radius();
+			result.PointB -= result.Normal * b.Radius();
+			result.Intersecting = cores && distance <= margin;
+			result.Distance = result.Intersecting ? margin - distance : distance - margin;
+			return result.Intersecting;
+		}
+
+		result.Intersecting = true;
+
+		if (Inflate(a, b, cores, s)) {
+			Epa(a, b, cores, s, result);
+		}
+		else if (cores) {
+			FlatContact(a, b, s, result);
+		}
+		else {
+			//Touching contact, or a shape without volume: no depth to measure.
+			result.PointA = s.V[0].A;
+			result.PointB = s.V[0].B;
+			return true;
+		}
+
+		result.Distance += margin;
+		result.PointA += result.Normal * a.Radius();
+		result.PointB -= result.Normal * b.Radius();
+		return true;
+	}
+
+	bool Gjk::Query(ConvexShape const& a, ConvexShape const& b, GjkResult& result) {
+		GjkCache cache;
+		return Query(a, b, cache, result);
+	}
+}
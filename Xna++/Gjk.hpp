@@ -0,0 +1,58 @@
+#ifndef _GJK_H_
+#define _GJK_H_
+
+#include <cstdint>
+#include "ConvexShape.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	/*
+	 State kept between the queries of a persistent pair: the directions that produced the vertices of the
+	 last simplex, and the last separating axis. Intersects first tries the axis, which rejects a pair
+	 that is still apart with one support per shape (served by the shape's support cache while it only
+	 translates); otherwise a query rebuilds the simplex along the directions, so a pair that barely
+	 moved converges in one or two iterations. A default constructed cache (or Reset) starts cold.
+	*/
+	struct GjkCache {
+		int32_t Count{ 0 };
+		Vector3 Directions[4];
+		bool HasSeparatingAxis{ false };
+		Vector3 SeparatingAxis;
+
+		void Reset();
+	};
+
+	struct GjkResult {
+		bool Intersecting{ false };
+		//Distance between the shapes when apart, penetration depth when intersecting.
+		double Distance{ 0 };
+		//Unit vector from a towards b: moving b by Normal * Depth separates intersecting shapes.
+		Vector3 Normal;
+		//Closest points when apart, deepest points when intersecting, in world space.
+		Vector3 PointA;
+		Vector3 PointB;
+		int32_t Iterations{ 0 };
+	};
+
+	/*
+	 Gilbert-Johnson-Keerthi distance between two convex shapes, with the expanding polytope algorithm
+	 for the penetration of intersecting ones. Query treats the Radius of capsules and spheres as a margin
+	 around their segment or point: the distance of those cores, minus the radii, needs no curved
+	 supports, and EPA only runs when the cores themselves overlap.
+	*/
+	class Gjk {
+	public:
+		static constexpr int32_t MaxIterations = 64;
+
+		//Overlap test only: stops at the first separating axis, without computing distances.
+		static bool Intersects(ConvexShape const& a, ConvexShape const& b, GjkCache& cache);
+		static bool Intersects(ConvexShape const& a, ConvexShape const& b);
+
+		//Fills result with the distance and closest points, or the penetration if the shapes intersect. Returns result.Intersecting.
+		static bool Query(ConvexShape const& a, ConvexShape const& b, GjkCache& cache, GjkResult& result);
+		static bool Query(ConvexShape const& a, ConvexShape const& b, GjkResult& result);
+	};
+}
+
+#endif
@@ -0,0 +1,24 @@
+#include "Hash.hpp"
+
+namespace Xna {
+
+	int32_t Hash::ComputeHash(uint8_t const* data, size_t length) {
+		const uint32_t p = 16777619;
+		uint32_t hash = 2166136261;
+
+		for (size_t i = 0; i < length; i++) {
+			hash = (hash ^ data[i]) * p;
+		}
+
+		hash += hash << 13;
+		hash ^= static_cast<uint32_t>(static_cast<int32_t>(hash) >> 7);
+		hash += hash << 3;
+		hash ^= static_cast<uint32_t>(static_cast<int32_t>(hash) >> 17);
+		hash += hash << 5;
+		return static_cast<int32_t>(hash);
+	}
+
+	int32_t Hash::ComputeHash(std::vector<uint8_t> const& data) {
+		return ComputeHash(data.data(), data.size());
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef _HASH_H_
+#define _HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Xna {
+
+	class Hash {
+	public:
+		//Modified FNV hash from MonoGame.Framework/Utilities/Hash.cs.
+		static int32_t ComputeHash(uint8_t const* data, size_t length);
+		static int32_t ComputeHash(std::vector<uint8_t> const& data);
+
+		//splitmix64 finalizer: every input bit affects every output bit.
+		static uint64_t Mix(uint64_t value) {
+			value ^= value >> 30;
+			value *= 0xBF58476D1CE4E5B9ull;
+			value ^= value >> 27;
+			value *= 0x94D049BB133111EBull;
+			value ^= value >> 31;
+			return value;
+		}
+
+		static uint64_t Combine(uint64_t seed, uint64_t value) {
+			return Mix(seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)));
+		}
+
+		//Bits of a double with -0.0 folded into 0.0, so that values equal under == give the same hash.
+		static uint64_t OfDouble(double value) {
+			if (value == 0.0) {
+				return 0;
+			}
+
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		static uint64_t OfInt32Pair(int32_t first, int32_t second) {
+			return static_cast<uint64_t>(static_cast<uint32_t>(first))
+				| (static_cast<uint64_t>(static_cast<uint32_t>(second)) << 32);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,255 @@
+#include <cstring>
+#include "Lz4DecoderStream.hpp"
+
+namespace Xna {
+
+	static constexpr size_t MinMatch = 4;
+
+	Lz4DecoderStream::Lz4DecoderStream() :
+		history(HistorySize) {}
+
+	Lz4DecoderStream::Lz4DecoderStream(uint8_t const* source, size_t length) :
+		history(HistorySize) {
+		Reset(source, length);
+	}
+
+	void Lz4DecoderStream::Reset(uint8_t const* source, size_t length) {
+		input = source;
+		inputLength = source != nullptr ? length : 0;
+		inputPosition = 0;
+		historyPosition = 0;
+		totalOutput = 0;
+		literalLength = 0;
+		matchLength = 0;
+		matchOffset = 0;
+		phase = DecodePhase::ReadToken;
+	}
+
+	bool Lz4DecoderStream::IsFinished() const {
+		return phase == DecodePhase::Finished;
+	}
+
+	bool Lz4DecoderStream::Failed() const {
+		return phase == DecodePhase::Error;
+	}
+
+	bool Lz4DecoderStream::ReadLength(size_t& length) {
+		uint8_t byte;
+
+		do {
+			if (inputPosition >= inputLength) {
+				return false;
+			}
+
+			byte = input[inputPosition++];
+			length += byte;
+		} while (byte == 255);
+
+		return true;
+	}
+
+	bool Lz4DecoderStream::ReadMatchHeader() {
+		if (inputLength - inputPosition < 2) {
+			return false;
+		}
+
+		matchOffset = static_cast<size_t>(input[inputPosition]) | (static_cast<size_t>(input[inputPosition + 1]) << 8);
+		inputPosition += 2;
+
+		if (matchOffset == 0 || matchOffset > totalOutput) {
+			return false;
+		}
+
+		if (matchLength == 15 && !ReadLength(matchLength)) {
+			return false;
+		}
+
+		matchLength += MinMatch;
+		return true;
+	}
+
+	void Lz4DecoderStream::Remember(uint8_t const* bytes, size_t count) {
+		if (count >= HistorySize) {
+			bytes += count - HistorySize;
+			count = HistorySize;
+		}
+
+		size_t first = HistorySize - historyPosition;
+		if (first > count) {
+			first = count;
+		}
+
+		std::memcpy(history.data() + historyPosition, bytes, first);
+		std::memcpy(history.data(), bytes + first, count - first);
+		historyPosition = (historyPosition + count) & HistoryMask;
+	}
+
+	size_t Lz4DecoderStream::Read(uint8_t* buffer, size_t count) {
+		size_t written = 0;
+
+		while (written < count) {
+			switch (phase) {
+			case DecodePhase::ReadToken: {
+				//The last sequence ends after its literals, so running out of input here is a normal end.
+				if (inputPosition >= inputLength) {
+					phase = DecodePhase::Finished;
+					return written;
+				}
+
+				uint8_t token = input[inputPosition++];
+				literalLength = token >> 4;
+				matchLength = token & 0xF;
+
+				if (literalLength == 15 && !ReadLength(literalLength)) {
+					phase = DecodePhase::Error;
+					return written;
+				}
+
+				phase = DecodePhase::CopyLiteral;
+				break;
+			}
+			case DecodePhase::CopyLiteral: {
+				size_t n = count - written < literalLength ? count - written : literalLength;
+
+				if (inputLength - inputPosition < n) {
+					phase = DecodePhase::Error;
+					return written;
+				}
+
+				std::memcpy(buffer + written, input + inputPosition, n);
+				Remember(buffer + written, n);
+				inputPosition += n;
+				written += n;
+				totalOutput += n;
+				literalLength -= n;
+
+				if (literalLength == 0) {
+					if (inputPosition >= inputLength) {
+						phase = DecodePhase::Finished;
+						return written;
+					}
+
+					phase = ReadMatchHeader() ? DecodePhase::CopyMatch : DecodePhase::Error;
+				}
+				break;
+			}
+			case DecodePhase::CopyMatch: {
+				size_t n = count - written < matchLength ? count - written : matchLength;
+				matchLength -= n;
+
+				while (n > 0) {
+					//Copy the largest run that neither wraps the ring nor overlaps its own output.
+					size_t source = (historyPosition - matchOffset) & HistoryMask;
+					size_t run = n;
+					if (run > matchOffset) run = matchOffset;
+					if (run > HistorySize - matchOffset) run = HistorySize - matchOffset;
+					if (run > HistorySize - source) run = HistorySize - source;
+					if (run > HistorySize - historyPosition) run = HistorySize - historyPosition;
+
+					std::memcpy(buffer + written, history.data() + source, run);
+					std::memmove(history.data() + historyPosition, history.data() + source, run);
+					historyPosition = (historyPosition + run) & HistoryMask;
+					written += run;
+					totalOutput += run;
+					n -= run;
+				}
+
+				if (matchLength == 0) {
+					phase = DecodePhase::ReadToken;
+				}
+				break;
+			}
+			default:
+				return written;
+			}
+		}
+
+		return written;
+	}
+
+	bool Lz4DecoderStream::Decode(uint8_t const* source, size_t sourceLength, uint8_t* destination, size_t destinationLength) {
+		uint8_t const* in = source;
+		uint8_t const* inEnd = source + sourceLength;
+		uint8_t* out = destination;
+		uint8_t* outEnd = destination + destinationLength;
+
+		while (in < inEnd) {
+			uint8_t token = *in++;
+			size_t literals = token >> 4;
+
+			if (literals == 15) {
+				uint8_t byte;
+				do {
+					if (in >= inEnd) {
+						return false;
+					}
+
+					byte = *in++;
+					literals += byte;
+				} while (byte == 255);
+			}
+
+			if (static_cast<size_t>(inEnd - in) < literals
+				|| static_cast<size_t>(outEnd - out) < literals) {
+				return false;
+			}
+
+			std::memcpy(out, in, literals);
+			in += literals;
+			out += literals;
+
+			if (in >= inEnd) {
+				break;
+			}
+
+			if (inEnd - in < 2) {
+				return false;
+			}
+
+			size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+			in += 2;
+
+			if (offset == 0 || offset > static_cast<size_t>(out - destination)) {
+				return false;
+			}
+
+			size_t length = token & 0xF;
+
+			if (length == 15) {
+				uint8_t byte;
+				do {
+					if (in >= inEnd) {
+						return false;
+					}
+
+					byte = *in++;
+					length += byte;
+				} while (byte == 255);
+			}
+
+			length += MinMatch;
+
+			if (static_cast<size_t>(outEnd - out) < length) {
+				return false;
+			}
+
+			uint8_t const* match = out - offset;
+
+			if (offset >= 8) {
+				//Non-overlapping 8 byte steps; the tail is finished byte by byte below.
+				while (length >= 8) {
+					std::memcpy(out, match, 8);
+					out += 8;
+					match += 8;
+					length -= 8;
+				}
+			}
+
+			while (length-- > 0) {
+				*out++ = *match++;
+			}
+		}
+
+		return out == outEnd;
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef _LZ4DECODERSTREAM_H_
+#define _LZ4DECODERSTREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Xna {
+
+	/*
+	 Decoder for the raw LZ4 block format used by LZ4 compressed .xnb files.
+	 Read() can be called with buffers of any size; the last 64KB of output are kept
+	 so that matches can reach back across calls.
+	*/
+	class Lz4DecoderStream {
+	public:
+		Lz4DecoderStream();
+		Lz4DecoderStream(uint8_t const* source, size_t length);
+
+		//The source buffer must outlive the decoder.
+		void Reset(uint8_t const* source, size_t length);
+
+		//Decodes up to 'count' bytes into 'buffer' and returns how many were written.
+		//Returns less than 'count' only at the end of the data or if the data is invalid.
+		size_t Read(uint8_t* buffer, size_t count);
+
+		bool IsFinished() const;
+		bool Failed() const;
+
+		//Decodes a whole block when the decompressed size is known. Faster than Read since
+		//the destination itself is used as the history window.
+		static bool Decode(uint8_t const* source, size_t sourceLength, uint8_t* destination, size_t destinationLength);
+
+	private:
+		static constexpr size_t HistorySize = 0x10000;
+		static constexpr size_t HistoryMask = 0xFFFF;
+
+		enum class DecodePhase {
+			ReadToken,
+			CopyLiteral,
+			CopyMatch,
+			Finished,
+			Error
+		};
+
+		uint8_t const* input{ nullptr };
+		size_t inputLength{ 0 };
+		size_t inputPosition{ 0 };
+
+		std::vector<uint8_t> history;
+		size_t historyPosition{ 0 };
+		uint64_t totalOutput{ 0 };
+
+		DecodePhase phase{ DecodePhase::Finished };
+		size_t literalLength{ 0 };
+		size_t matchLength{ 0 };
+		size_t matchOffset{ 0 };
+
+		bool ReadLength(size_t& length);
+		bool ReadMatchHeader();
+		void Remember(uint8_t const* bytes, size_t count);
+	};
+}
+
+#endif
@@ -0,0 +1,762 @@
+#include <cstring>
+#include "LzxDecoder.hpp"
+
+namespace Xna {
+
+	struct LzxTables {
+		uint8_t ExtraBits[52];
+		uint32_t PositionBase[51];
+
+		LzxTables() {
+			for (int32_t i = 0, j = 0; i <= 50; i += 2) {
+				ExtraBits[i] = ExtraBits[i + 1] = static_cast<uint8_t>(j);
+
+				if ((i != 0) && (j < 17)) {
+					j++;
+				}
+			}
+
+			for (int32_t i = 0, j = 0; i <= 50; i++) {
+				PositionBase[i] = static_cast<uint32_t>(j);
+				j += 1 << ExtraBits[i];
+			}
+		}
+	};
+
+	static const LzxTables tables;
+
+	void LzxDecoder::BitBuffer::Init() {
+		buffer = 0;
+		bitsLeft = 0;
+	}
+
+	void LzxDecoder::BitBuffer::EnsureBits(uint32_t bits) {
+		while (bitsLeft < bits) {
+			//Bytes past the end read as zero; Decompress rejects them if they are actually used.
+			uint32_t lo = Position < Length ? Data[Position] : 0;
+			uint32_t hi = Position + 1 < Length ? Data[Position + 1] : 0;
+			Position += 2;
+
+			buffer |= ((hi << 8) | lo) << (32 - 16 - bitsLeft);
+			bitsLeft += 16;
+		}
+	}
+
+	uint32_t LzxDecoder::BitBuffer::PeekBits(uint32_t bits) const {
+		return buffer >> (32 - bits);
+	}
+
+	void LzxDecoder::BitBuffer::RemoveBits(uint32_t bits) {
+		buffer <<= bits;
+		bitsLeft -= bits;
+	}
+
+	uint32_t LzxDecoder::BitBuffer::ReadBits(uint32_t bits) {
+		uint32_t value = 0;
+
+		if (bits > 0) {
+			EnsureBits(bits);
+			value = PeekBits(bits);
+			RemoveBits(bits);
+		}
+
+		return value;
+	}
+
+	uint32_t LzxDecoder::BitBuffer::Buffer() const {
+		return buffer;
+	}
+
+	uint32_t LzxDecoder::BitBuffer::BitsLeft() const {
+		return bitsLeft;
+	}
+
+	LzxDecoder::LzxDecoder() {
+		Reset(16);
+	}
+
+	bool LzxDecoder::Reset(int32_t windowBits) {
+		if (windowBits < 15 || windowBits > 21) {
+			return false;
+		}
+
+		windowSize = 1u << windowBits;
+		window.assign(windowSize, 0xDC);
+		windowPosition = 0;
+
+		int32_t positionSlots;
+
+		if (windowBits == 20) {
+			positionSlots = 42;
+		}
+		else if (windowBits == 21) {
+			positionSlots = 50;
+		}
+		else {
+			positionSlots = windowBits << 1;
+		}
+
+		R0 = R1 = R2 = 1;
+		mainElements = NumChars + (static_cast<uint32_t>(positionSlots) << 3);
+		headerRead = false;
+		framesRead = 0;
+		blockRemaining = 0;
+		blockLength = 0;
+		blockType = BlockType::Invalid;
+		intelFileSize = 0;
+		intelCurrentPosition = 0;
+		intelStarted = false;
+
+		//Deltas are applied to the previous lengths, so they must start at zero.
+		std::memset(maintreeLengths, 0, sizeof(maintreeLengths));
+		std::memset(lengthLengths, 0, sizeof(lengthLengths));
+
+		return true;
+	}
+
+	bool LzxDecoder::Decompress(uint8_t const* source, size_t sourceLength, uint8_t* destination, size_t destinationLength) {
+		if (destinationLength > windowSize) {
+			return false;
+		}
+
+		BitBuffer bits;
+		bits.Data = source;
+		bits.Length = sourceLength;
+		bits.Init();
+
+		int32_t togo = static_cast<int32_t>(destinationLength);
+
+		if (!headerRead) {
+			if (bits.ReadBits(1) != 0) {
+				uint32_t i = bits.ReadBits(16);
+				uint32_t j = bits.ReadBits(16);
+				intelFileSize = static_cast<int32_t>((i << 16) | j);
+			}
+
+			headerRead = true;
+		}
+
+		while (togo > 0) {
+			//Last block finished, new block expected.
+			if (blockRemaining == 0) {
+				if (blockType == BlockType::Uncompressed) {
+					//Realign the bitstream to a word.
+					if ((blockLength & 1) == 1) {
+						bits.Position++;
+					}
+
+					bits.Init();
+				}
+
+				blockType = static_cast<BlockType>(bits.ReadBits(3));
+				uint32_t i = bits.ReadBits(16);
+				uint32_t j = bits.ReadBits(8);
+				blockRemaining = blockLength = (i << 8) | j;
+
+				switch (blockType) {
+				case BlockType::Aligned:
+					for (i = 0; i < 8; i++) {
+						alignedLengths[i] = static_cast<uint8_t>(bits.ReadBits(3));
+					}
+
+					if (!MakeDecodeTable(AlignedMaxSymbols, AlignedTableBits, alignedLengths, alignedTable)) {
+						return false;
+					}
+					//The rest of the aligned header is the same as verbatim.
+					//fall through
+				case BlockType::Verbatim:
+					if (!ReadLengths(maintreeLengths, 0, 256, bits)
+						|| !ReadLengths(maintreeLengths, 256, mainElements, bits)
+						|| !MakeDecodeTable(MaintreeMaxSymbols, MaintreeTableBits, maintreeLengths, maintreeTable)) {
+						return false;
+					}
+
+					if (maintreeLengths[0xE8] != 0) {
+						intelStarted = true;
+					}
+
+					if (!ReadLengths(lengthLengths, 0, NumSecondaryLengths, bits)
+						|| !MakeDecodeTable(LengthMaxSymbols, LengthTableBits, lengthLengths, lengthTable)) {
+						return false;
+					}
+					break;
+				case BlockType::Uncompressed: {
+					//Because we can't assume otherwise.
+					intelStarted = true;
+
+					//Get up to 16 pad bits into the buffer and align the bitstream.
+					bits.EnsureBits(16);
+					if (bits.BitsLeft() > 16) {
+						bits.Position -= 2;
+					}
+
+					if (bits.Position > sourceLength || sourceLength - bits.Position < 12) {
+						return false;
+					}
+
+					uint32_t offsets[3];
+					std::memcpy(offsets, source + bits.Position, 12);
+					bits.Position += 12;
+
+					R0 = offsets[0];
+					R1 = offsets[1];
+					R2 = offsets[2];
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+
+			/*
+			 It's possible to have a file where the next run is less than 16 bits in size,
+			 in which case building the tables reads past the end of the input. Allow it,
+			 but only if those bits are not used.
+			*/
+			if (bits.Position > sourceLength) {
+				if (bits.Position > sourceLength + 2 || bits.BitsLeft() < 16) {
+					return false;
+				}
+			}
+
+			int32_t thisRun;
+
+			while ((thisRun = static_cast<int32_t>(blockRemaining)) > 0 && togo > 0) {
+				if (thisRun > togo) {
+					thisRun = togo;
+				}
+
+				togo -= thisRun;
+				blockRemaining -= static_cast<uint32_t>(thisRun);
+
+				windowPosition &= windowSize - 1;
+
+				//Runs can't straddle the window wraparound.
+				if (windowPosition + static_cast<uint32_t>(thisRun) > windowSize) {
+					return false;
+				}
+
+				switch (blockType) {
+				case BlockType::Verbatim:
+				case BlockType::Aligned:
+					if (!DecodeRun(bits, thisRun)) {
+						return false;
+					}
+
+					//The final match may overrun the requested run; it still belongs to this block and frame.
+					if (thisRun < 0) {
+						uint32_t overrun = static_cast<uint32_t>(-thisRun);
+
+						if (overrun > blockRemaining || static_cast<int32_t>(overrun) > togo) {
+							return false;
+						}
+
+						blockRemaining -= overrun;
+						togo -= static_cast<int32_t>(overrun);
+					}
+					break;
+				case BlockType::Uncompressed:
+					if (bits.Position > sourceLength || sourceLength - bits.Position < static_cast<size_t>(thisRun)) {
+						return false;
+					}
+
+					std::memcpy(window.data() + windowPosition, source + bits.Position, static_cast<size_t>(thisRun));
+					bits.Position += static_cast<size_t>(thisRun);
+					windowPosition += static_cast<uint32_t>(thisRun);
+					break;
+				default:
+					return false;
+				}
+			}
+		}
+
+		if (togo != 0) {
+			return false;
+		}
+
+		size_t start = windowPosition == 0 ? windowSize : windowPosition;
+		start -= destinationLength;
+		std::memcpy(destination, window.data() + start, destinationLength);
+
+		TranslateIntelE8(destination, destinationLength);
+
+		return true;
+	}
+
+	//Decodes a verbatim or aligned run. 'run' ends at zero or below if the last match went past it.
+	bool LzxDecoder::DecodeRun(BitBuffer& bits, int32_t& run) {
+		uint8_t* data = window.data();
+		bool aligned = blockType == BlockType::Aligned;
+
+		while (run > 0) {
+			uint32_t mainElement;
+			if (!ReadHuffSym(maintreeTable, maintreeLengths, MaintreeMaxSymbols, MaintreeTableBits, bits, mainElement)) {
+				return false;
+			}
+
+			if (mainElement < NumChars) {
+				//Literal: 0 to NumChars - 1.
+				data[windowPosition++] = static_cast<uint8_t>(mainElement);
+				run--;
+				continue;
+			}
+
+			//Match: NumChars + ((slot << 3) | length_header (3 bits)).
+			mainElement -= NumChars;
+			uint32_t matchLength = mainElement & NumPrimaryLengths;
+
+			if (matchLength == NumPrimaryLengths) {
+				uint32_t lengthFooter;
+				if (!ReadHuffSym(lengthTable, lengthLengths, LengthMaxSymbols, LengthTableBits, bits, lengthFooter)) {
+					return false;
+				}
+
+				matchLength += lengthFooter;
+			}
+
+			matchLength += MinMatch;
+			uint32_t matchOffset = mainElement >> 3;
+
+			if (matchOffset > 2) {
+				//Not a repeated offset.
+				uint32_t extra = tables.ExtraBits[matchOffset];
+
+				if (!aligned) {
+					if (matchOffset != 3) {
+						matchOffset = tables.PositionBase[matchOffset] - 2 + bits.ReadBits(extra);
+					}
+					else {
+						matchOffset = 1;
+					}
+				}
+				else {
+					matchOffset = tables.PositionBase[matchOffset] - 2;
+
+					if (extra > 3) {
+						//Verbatim and aligned bits.
+						uint32_t alignedBits;
+						matchOffset += bits.ReadBits(extra - 3) << 3;
+
+						if (!ReadHuffSym(alignedTable, alignedLengths, AlignedMaxSymbols, AlignedTableBits, bits, alignedBits)) {
+							return false;
+						}
+
+						matchOffset += alignedBits;
+					}
+					else if (extra == 3) {
+						//Aligned bits only.
+						uint32_t alignedBits;
+						if (!ReadHuffSym(alignedTable, alignedLengths, AlignedMaxSymbols, AlignedTableBits, bits, alignedBits)) {
+							return false;
+						}
+
+						matchOffset += alignedBits;
+					}
+					else if (extra > 0) {
+						//Verbatim bits only.
+						matchOffset += bits.ReadBits(extra);
+					}
+					else {
+						matchOffset = 1;
+					}
+				}
+
+				//Update the repeated offset LRU queue.
+				R2 = R1;
+				R1 = R0;
+				R0 = matchOffset;
+			}
+			else if (matchOffset == 0) {
+				matchOffset = R0;
+			}
+			else if (matchOffset == 1) {
+				matchOffset = R1;
+				R1 = R0;
+				R0 = matchOffset;
+			}
+			else {
+				matchOffset = R2;
+				R2 = R0;
+				R0 = matchOffset;
+			}
+
+			if (matchOffset == 0 || matchOffset > windowSize
+				|| windowPosition + matchLength > windowSize) {
+				return false;
+			}
+
+			uint32_t destination = windowPosition;
+			uint32_t source;
+			run -= static_cast<int32_t>(matchLength);
+
+			if (windowPosition >= matchOffset) {
+				//No wrap.
+				source = destination - matchOffset;
+			}
+			else {
+				//Copy any wrapped around source data first.
+				source = destination + (windowSize - matchOffset);
+				uint32_t copyLength = matchOffset - windowPosition;
+
+				if (copyLength < matchLength) {
+					matchLength -= copyLength;
+					windowPosition += copyLength;
+
+					while (copyLength-- > 0) {
+						data[destination++] = data[source++];
+					}
+
+					source = 0;
+				}
+			}
+
+			windowPosition += matchLength;
+
+			//Copy match data, no worries about destination wraps.
+			while (matchLength-- > 0) {
+				data[destination++] = data[source++];
+			}
+		}
+
+		return true;
+	}
+
+	void LzxDecoder::TranslateIntelE8(uint8_t* data, size_t length) {
+		if (framesRead++ >= 32768 || intelFileSize == 0) {
+			return;
+		}
+
+		if (length <= 10 || !intelStarted) {
+			intelCurrentPosition += static_cast<int32_t>(length);
+			return;
+		}
+
+		uint8_t* end = data + length - 10;
+		int32_t position = intelCurrentPosition;
+
+		while (data < end) {
+			if (*data++ != 0xE8) {
+				position++;
+				continue;
+			}
+
+			int32_t absolute;
+			std::memcpy(&absolute, data, 4);
+
+			if ((absolute >= -position) && (absolute < intelFileSize)) {
+				int32_t relative = (absolute >= 0) ? absolute - position : absolute + intelFileSize;
+				std::memcpy(data, &relative, 4);
+			}
+
+			data += 4;
+			position += 5;
+		}
+
+		intelCurrentPosition += static_cast<int32_t>(length);
+	}
+
+	bool LzxDecoder::MakeDecodeTable(uint32_t symbols, uint32_t bits, uint8_t const* lengths, uint16_t* table) {
+		uint32_t tableSize = (1u << bits) + (symbols << 1);
+		uint32_t position = 0;
+		uint32_t tableMask = 1u << bits;
+		//Don't do 0 length codes.
+		uint32_t bitMask = tableMask >> 1;
+		//Base of allocation for long codes.
+		uint32_t nextSymbol = bitMask;
+		uint32_t bitNum = 1;
+
+		//Fill entries for codes short enough for a direct mapping.
+		while (bitNum <= bits) {
+			for (uint32_t symbol = 0; symbol < symbols; symbol++) {
+				if (lengths[symbol] == bitNum) {
+					uint32_t leaf = position;
+
+					if ((position += bitMask) > tableMask) {
+						//Table overrun.
+						return false;
+					}
+
+					for (uint32_t fill = bitMask; fill > 0; fill--) {
+						table[leaf++] = static_cast<uint16_t>(symbol);
+					}
+				}
+			}
+
+			bitMask >>= 1;
+			bitNum++;
+		}
+
+		//If there are any codes longer than 'bits'.
+		if (position != tableMask) {
+			//Clear the remainder of the table.
+			for (uint32_t symbol = position; symbol < tableMask; symbol++) {
+				table[symbol] = 0;
+			}
+
+			//Give ourselves room for codes to grow by up to 16 more bits.
+			position <<= 16;
+			tableMask <<= 16;
+			bitMask = 1u << 15;
+
+			while (bitNum <= 16) {
+				for (uint32_t symbol = 0; symbol < symbols; symbol++) {
+					if (lengths[symbol] == bitNum) {
+						uint32_t leaf = position >> 16;
+
+						for (uint32_t fill = 0; fill < bitNum - bits; fill++) {
+							//If this path hasn't been taken yet, 'allocate' two entries.
+							if (table[leaf] == 0) {
+								if ((nextSymbol << 1) + 1 >= tableSize) {
+									return false;
+								}
+
+								table[nextSymbol << 1] = 0;
+								table[(nextSymbol << 1) + 1] = 0;
+								table[leaf] = static_cast<uint16_t>(nextSymbol++);
+							}
+
+							//Follow the path and select either left or right for the next bit.
+							leaf = static_cast<uint32_t>(table[leaf]) << 1;
+
+							if (((position >> (15 - fill)) & 1) == 1) {
+								leaf++;
+							}
+						}
+
+						table[leaf] = static_cast<uint16_t>(symbol);
+
+						if ((position += bitMask) > tableMask) {
+							return false;
+						}
+					}
+				}
+
+				bitMask >>= 1;
+				bitNum++;
+			}
+		}
+
+		if (position == tableMask) {
+			return true;
+		}
+
+		//Either an erroneous table, or all elements are 0.
+		for (uint32_t symbol = 0; symbol < symbols; symbol++) {
+			if (lengths[symbol] != 0) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool LzxDecoder::ReadHuffSym(uint16_t const* table, uint8_t const* lengths, uint32_t symbols, uint32_t bits,
+		BitBuffer& bitBuffer, uint32_t& symbol) {
+
+		bitBuffer.EnsureBits(16);
+		uint32_t i = table[bitBuffer.PeekBits(bits)];
+
+		if (i >= symbols) {
+			uint32_t j = 1u << (32 - bits);
+
+			do {
+				j >>= 1;
+				i <<= 1;
+				i |= (bitBuffer.Buffer() & j) != 0 ? 1u : 0u;
+
+				if (j == 0) {
+					return false;
+				}
+			} while ((i = table[i]) >= symbols);
+		}
+
+		bitBuffer.RemoveBits(lengths[i]);
+		symbol = i;
+
+		return true;
+	}
+
+	bool LzxDecoder::ReadLengths(uint8_t* lengths, uint32_t first, uint32_t last, BitBuffer& bits) {
+		for (uint32_t x = 0; x < 20; x++) {
+			pretreeLengths[x] = static_cast<uint8_t>(bits.ReadBits(4));
+		}
+
+		if (!MakeDecodeTable(PretreeMaxSymbols, PretreeTableBits, pretreeLengths, pretreeTable)) {
+			return false;
+		}
+
+		for (uint32_t x = first; x < last;) {
+			uint32_t z;
+			if (!ReadHuffSym(pretreeTable, pretreeLengths, PretreeMaxSymbols, PretreeTableBits, bits, z)) {
+				return false;
+			}
+
+			uint32_t y;
+
+			if (z == 17) {
+				y = bits.ReadBits(4) + 4;
+			}
+			else if (z == 18) {
+				y = bits.ReadBits(5) + 20;
+			}
+			else if (z == 19) {
+				y = bits.ReadBits(1) + 4;
+			}
+			else {
+				y = 1;
+			}
+
+			//Runs may spill into the safety margin past 'last', never further.
+			if (x + y > last + LenTableSafety) {
+				return false;
+			}
+
+			if (z == 17 || z == 18) {
+				while (y-- != 0) {
+					lengths[x++] = 0;
+				}
+			}
+			else if (z == 19) {
+				if (!ReadHuffSym(pretreeTable, pretreeLengths, PretreeMaxSymbols, PretreeTableBits, bits, z)) {
+					return false;
+				}
+
+				int32_t value = static_cast<int32_t>(lengths[x]) - static_cast<int32_t>(z);
+				if (value < 0) {
+					value += 17;
+				}
+
+				while (y-- != 0) {
+					lengths[x++] = static_cast<uint8_t>(value);
+				}
+			}
+			else {
+				int32_t value = static_cast<int32_t>(lengths[x]) - static_cast<int32_t>(z);
+				if (value < 0) {
+					value += 17;
+				}
+
+				lengths[x++] = static_cast<uint8_t>(value);
+			}
+		}
+
+		return true;
+	}
+
+	LzxDecoderStream::LzxDecoderStream() {}
+
+	LzxDecoderStream::LzxDecoderStream(uint8_t const* source, size_t length) {
+		Reset(source, length);
+	}
+
+	void LzxDecoderStream::Reset(uint8_t const* source, size_t length) {
+		decoder.Reset(16);
+		input = source;
+		inputLength = source != nullptr ? length : 0;
+		inputPosition = 0;
+		frameLength = 0;
+		framePosition = 0;
+		finished = false;
+		failed = false;
+
+		if (frame.empty()) {
+			frame.resize(0x10000);
+		}
+	}
+
+	bool LzxDecoderStream::IsFinished() const {
+		return finished && framePosition == frameLength;
+	}
+
+	bool LzxDecoderStream::Failed() const {
+		return failed;
+	}
+
+	bool LzxDecoderStream::ReadBlockHeader(size_t& blockSize, size_t& frameSize) {
+		/*
+		 Normal 32KB frames are preceded by a big endian short holding the compressed block size.
+		 Frames of any other size are preceded by 0xFF, then a short with the frame size and
+		 another with the block size.
+		*/
+		if (inputLength - inputPosition < 2) {
+			finished = true;
+			return false;
+		}
+
+		uint8_t const* bytes = input + inputPosition;
+		blockSize = (static_cast<size_t>(bytes[0]) << 8) | bytes[1];
+		frameSize = 0x8000;
+
+		if (bytes[0] == 0xFF) {
+			if (inputLength - inputPosition < 5) {
+				failed = true;
+				return false;
+			}
+
+			frameSize = (static_cast<size_t>(bytes[1]) << 8) | bytes[2];
+			blockSize = (static_cast<size_t>(bytes[3]) << 8) | bytes[4];
+			inputPosition += 5;
+		}
+		else {
+			inputPosition += 2;
+		}
+
+		//Either says there is nothing more to decode.
+		if (blockSize == 0 || frameSize == 0) {
+			finished = true;
+			return false;
+		}
+
+		if (blockSize > inputLength - inputPosition) {
+			failed = true;
+			return false;
+		}
+
+		return true;
+	}
+
+	size_t LzxDecoderStream::Read(uint8_t* buffer, size_t count) {
+		size_t written = 0;
+
+		while (written < count) {
+			if (framePosition < frameLength) {
+				size_t n = frameLength - framePosition;
+				if (n > count - written) {
+					n = count - written;
+				}
+
+				std::memcpy(buffer + written, frame.data() + framePosition, n);
+				framePosition += n;
+				written += n;
+				continue;
+			}
+
+			size_t blockSize;
+			size_t frameSize;
+
+			if (finished || failed || !ReadBlockHeader(blockSize, frameSize)) {
+				break;
+			}
+
+			bool direct = count - written >= frameSize;
+			uint8_t* target = direct ? buffer + written : frame.data();
+
+			if (!decoder.Decompress(input + inputPosition, blockSize, target, frameSize)) {
+				failed = true;
+				break;
+			}
+
+			inputPosition += blockSize;
+
+			if (direct) {
+				written += frameSize;
+			}
+			else {
+				frameLength = frameSize;
+				framePosition = 0;
+			}
+		}
+
+		return written;
+	}
+}
@@ -0,0 +1,135 @@
+#ifndef _LZXDECODER_H_
+#define _LZXDECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ Port of MonoGame's LzxDecoder.cs, itself derived from lzxd.c in libmspack
+ (C) 2003-2004 Stuart Caie, (C) 2011 Ali Scissons. Dual licensed LGPL 2.1 / MS-PL.
+*/
+
+namespace Xna {
+
+	//Decodes LZX frames. The window persists between frames, so frames must be decoded in order.
+	class LzxDecoder {
+	public:
+		LzxDecoder();
+
+		//Window size in bits, 15 to 21. XNB content always uses 16.
+		bool Reset(int32_t windowBits = 16);
+
+		//Decodes one frame of 'sourceLength' compressed bytes into exactly 'destinationLength' bytes.
+		bool Decompress(uint8_t const* source, size_t sourceLength, uint8_t* destination, size_t destinationLength);
+
+	private:
+		static constexpr uint32_t MinMatch = 2;
+		static constexpr uint32_t NumChars = 256;
+		static constexpr uint32_t NumPrimaryLengths = 7;
+		static constexpr uint32_t NumSecondaryLengths = 249;
+		static constexpr uint32_t PretreeMaxSymbols = 20;
+		static constexpr uint32_t PretreeTableBits = 6;
+		static constexpr uint32_t MaintreeMaxSymbols = NumChars + 50 * 8;
+		static constexpr uint32_t MaintreeTableBits = 12;
+		static constexpr uint32_t LengthMaxSymbols = NumSecondaryLengths + 1;
+		static constexpr uint32_t LengthTableBits = 12;
+		static constexpr uint32_t AlignedMaxSymbols = 8;
+		static constexpr uint32_t AlignedTableBits = 7;
+		static constexpr uint32_t LenTableSafety = 64;
+
+		enum class BlockType : uint32_t {
+			Invalid = 0,
+			Verbatim = 1,
+			Aligned = 2,
+			Uncompressed = 3
+		};
+
+		class BitBuffer {
+		public:
+			uint8_t const* Data{ nullptr };
+			size_t Length{ 0 };
+			size_t Position{ 0 };
+
+			void Init();
+			void EnsureBits(uint32_t bits);
+			uint32_t PeekBits(uint32_t bits) const;
+			void RemoveBits(uint32_t bits);
+			uint32_t ReadBits(uint32_t bits);
+			uint32_t Buffer() const;
+			uint32_t BitsLeft() const;
+
+		private:
+			uint32_t buffer{ 0 };
+			uint32_t bitsLeft{ 0 };
+		};
+
+		uint32_t R0{ 1 };
+		uint32_t R1{ 1 };
+		uint32_t R2{ 1 };
+		uint32_t mainElements{ 0 };
+		bool headerRead{ false };
+		BlockType blockType{ BlockType::Invalid };
+		uint32_t blockLength{ 0 };
+		uint32_t blockRemaining{ 0 };
+		uint32_t framesRead{ 0 };
+		int32_t intelFileSize{ 0 };
+		int32_t intelCurrentPosition{ 0 };
+		bool intelStarted{ false };
+
+		uint16_t pretreeTable[(1 << PretreeTableBits) + (PretreeMaxSymbols << 1)];
+		uint8_t pretreeLengths[PretreeMaxSymbols + LenTableSafety];
+		uint16_t maintreeTable[(1 << MaintreeTableBits) + (MaintreeMaxSymbols << 1)];
+		uint8_t maintreeLengths[MaintreeMaxSymbols + LenTableSafety];
+		uint16_t lengthTable[(1 << LengthTableBits) + (LengthMaxSymbols << 1)];
+		uint8_t lengthLengths[LengthMaxSymbols + LenTableSafety];
+		uint16_t alignedTable[(1 << AlignedTableBits) + (AlignedMaxSymbols << 1)];
+		uint8_t alignedLengths[AlignedMaxSymbols + LenTableSafety];
+
+		std::vector<uint8_t> window;
+		uint32_t windowSize{ 0 };
+		uint32_t windowPosition{ 0 };
+
+		static bool MakeDecodeTable(uint32_t symbols, uint32_t bits, uint8_t const* lengths, uint16_t* table);
+		static bool ReadHuffSym(uint16_t const* table, uint8_t const* lengths, uint32_t symbols, uint32_t bits,
+			BitBuffer& bitBuffer, uint32_t& symbol);
+		bool ReadLengths(uint8_t* lengths, uint32_t first, uint32_t last, BitBuffer& bitBuffer);
+		bool DecodeRun(BitBuffer& bitBuffer, int32_t& run);
+		void TranslateIntelE8(uint8_t* data, size_t length);
+	};
+
+	/*
+	 Reads the LZX block stream of a compressed .xnb (everything after the decompressed size field).
+	 Frames are decoded straight into the caller's buffer when it has room for a whole frame.
+	*/
+	class LzxDecoderStream {
+	public:
+		LzxDecoderStream();
+		LzxDecoderStream(uint8_t const* source, size_t length);
+
+		//The source buffer must outlive the decoder.
+		void Reset(uint8_t const* source, size_t length);
+
+		//Decodes up to 'count' bytes into 'buffer' and returns how many were written.
+		//Returns less than 'count' only at the end of the data or if the data is invalid.
+		size_t Read(uint8_t* buffer, size_t count);
+
+		bool IsFinished() const;
+		bool Failed() const;
+
+	private:
+		LzxDecoder decoder;
+		uint8_t const* input{ nullptr };
+		size_t inputLength{ 0 };
+		size_t inputPosition{ 0 };
+		std::vector<uint8_t> frame;
+		size_t frameLength{ 0 };
+		size_t framePosition{ 0 };
+		bool finished{ true };
+		bool failed{ false };
+
+		bool ReadBlockHeader(size_t& blockSize, size_t& frameSize);
+	};
+}
+
+#endif
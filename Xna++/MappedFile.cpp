@@ -0,0 +1,151 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Xna {
+	MappedFile::MappedFile() {}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = static_cast<MappedFile&&>(other);
+	}
+
+	MappedFile::~MappedFile() {
+		Close();
+	}
+
+	MappedFile& MappedFile::operator= (MappedFile&& other) noexcept {
+		if (this != &other) {
+			Close();
+			data = other.data;
+			size = other.size;
+			other.data = nullptr;
+			other.size = 0;
+#ifdef _WIN32
+			file = other.file;
+			mapping = other.mapping;
+			other.file = nullptr;
+			other.mapping = nullptr;
+#endif
+		}
+
+		return *this;
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(std::string const& path) {
+		Close();
+
+		HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (handle == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER length;
+		if (!GetFileSizeEx(handle, &length) || length.QuadPart == 0) {
+			CloseHandle(handle);
+			return false;
+		}
+
+		HANDLE map = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (map == nullptr) {
+			CloseHandle(handle);
+			return false;
+		}
+
+		void* view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr) {
+			CloseHandle(map);
+			CloseHandle(handle);
+			return false;
+		}
+
+		file = handle;
+		mapping = map;
+		data = static_cast<uint8_t const*>(view);
+		size = static_cast<size_t>(length.QuadPart);
+
+		return true;
+	}
+
+	void MappedFile::Close() {
+		if (data != nullptr) {
+			UnmapViewOfFile(data);
+		}
+
+		if (mapping != nullptr) {
+			CloseHandle(mapping);
+		}
+
+		if (file != nullptr) {
+			CloseHandle(file);
+		}
+
+		data = nullptr;
+		size = 0;
+		file = nullptr;
+		mapping = nullptr;
+	}
+#else
+	bool MappedFile::Open(std::string const& path) {
+		Close();
+
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+			close(fd);
+			return false;
+		}
+
+		void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		//The mapping keeps its own reference to the file.
+		close(fd);
+
+		if (view == MAP_FAILED) {
+			return false;
+		}
+
+		madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+		data = static_cast<uint8_t const*>(view);
+		size = static_cast<size_t>(info.st_size);
+
+		return true;
+	}
+
+	void MappedFile::Close() {
+		if (data != nullptr) {
+			munmap(const_cast<uint8_t*>(data), size);
+		}
+
+		data = nullptr;
+		size = 0;
+	}
+#endif
+
+	bool MappedFile::IsOpen() const {
+		return data != nullptr;
+	}
+
+	uint8_t const* MappedFile::Data() const {
+		return data;
+	}
+
+	size_t MappedFile::Size() const {
+		return size;
+	}
+}
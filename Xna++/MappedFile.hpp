@@ -0,0 +1,39 @@
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Xna {
+
+	//Read-only memory mapping of a whole file. The mapping lives as long as the object.
+	class MappedFile {
+	public:
+		MappedFile();
+		MappedFile(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator= (MappedFile const&) = delete;
+		MappedFile& operator= (MappedFile&& other) noexcept;
+
+		//Returns false if the file does not exist, is empty or cannot be mapped.
+		bool Open(std::string const& path);
+		void Close();
+
+		bool IsOpen() const;
+		uint8_t const* Data() const;
+		size_t Size() const;
+
+	private:
+		uint8_t const* data{ nullptr };
+		size_t size{ 0 };
+#ifdef _WIN32
+		void* file{ nullptr };
+		void* mapping{ nullptr };
+#endif
+	};
+}
+
+#endif
@@ -1,10 +1,13 @@
 #ifndef _MATHHELPER_H_
 #define _MATHHELPER_H_
 
+#include <cmath>
 #include <cstdint>
+#include <limits>
 
 namespace Xna {
 
+	//Every function is constexpr, so calls with constant arguments fold at compile time.
 	class MathHelper {
 	public:
 		static constexpr double LOG10E = 0.434294481903251827651;
@@ -14,25 +17,147 @@ namespace Xna {
 		static constexpr double TWO_PI = PI * 2.0;
 		static constexpr double TAU = TWO_PI;
 
-		static double Barycentric(double v1, double v2, double v3, double amount1, double amount2);
-		static double CatmullRom(double v1, double v2, double v3, double v4, double amount);
-		static double Clamp(double v, double min, double max);
-		static int32_t Clamp(int32_t v, int32_t min, int32_t max);
-		static double Distance(double v1, double v2);
-		static double Hermite(double v1, double tan1, double v2, double tan2, double amount);
-		static double Lerp(double v1, double v2, double amount);
-		static double LerpPrecise(double v1, double v2, double amount);
-		static double Max(double v1, double v2);
-		static int32_t Max(int32_t v1, int32_t v2);
-		static double Min(double v1, double v2);
-		static int32_t Min(int32_t v1, int32_t v2);
-		static double SmoothStep(double v1, double v2, double amount);
-		static double ToDegrees(double radians);
-		static double ToRadians(double degrees);
-		static double WrapAngle(double angle);
-		static bool IsPowerOfTwo(int32_t v);
+		static constexpr double Barycentric(double v1, double v2, double v3, double amount1, double amount2) {
+			return v1 + (v2 - v1) * amount1 + (v3 - v1) * amount2;
+		}
+
+		static constexpr double CatmullRom(double v1, double v2, double v3, double v4, double amount) {
+			double amountSquared = amount * amount;
+			double amountCubed = amountSquared * amount;
+
+			return (0.5 * (2.0 * v2 +
+				(v3 - v1) * amount +
+				(2.0 * v1 - 5.0 * v2 + 4.0 * v3 - v4) * amountSquared +
+				(3.0 * v2 - v1 - 3.0 * v3 + v4) * amountCubed));
+		}
+
+		static constexpr double Clamp(double v, double min, double max) {
+			v = (v > max) ? max : v;
+			v = (v < min) ? min : v;
+			return v;
+		}
+
+		static constexpr int32_t Clamp(int32_t v, int32_t min, int32_t max) {
+			v = (v > max) ? max : v;
+			v = (v < min) ? min : v;
+			return v;
+		}
+
+		static constexpr double Distance(double v1, double v2) {
+			return v1 > v2 ? v1 - v2 : v2 - v1;
+		}
+
+		static constexpr double Hermite(double v1, double tan1, double v2, double tan2, double amount) {
+			double aCubed = amount * amount * amount;
+			double aSquared = amount * amount;
+
+			if (amount == 0.0) {
+				return v1;
+			}
+
+			if (amount == 1.0) {
+				return v2;
+			}
+
+			return (2 * v1 - 2 * v2 + tan2 + tan1) * aCubed +
+				(3 * v2 - 3 * v1 - 2 * tan1 - tan2) * aSquared +
+				tan1 * amount +
+				v1;
+		}
+
+		static constexpr double Lerp(double v1, double v2, double amount) {
+			return v1 + (v2 - v1) * amount;
+		}
+
+		static constexpr double LerpPrecise(double v1, double v2, double amount) {
+			return ((1.0 - amount) * v1) + (v2 * amount);
+		}
+
+		static constexpr double Max(double v1, double v2) {
+			return v1 > v2 ? v1 : v2;
+		}
+
+		static constexpr int32_t Max(int32_t v1, int32_t v2) {
+			return v1 > v2 ? v1 : v2;
+		}
+
+		static constexpr double Min(double v1, double v2) {
+			return v1 < v2 ? v1 : v2;
+		}
+
+		static constexpr int32_t Min(int32_t v1, int32_t v2) {
+			return v1 < v2 ? v1 : v2;
+		}
+
+		static constexpr double SmoothStep(double v1, double v2, double amount) {
+			return Hermite(v1, 0.0, v2, 0.0, Clamp(amount, 0.0, 1.0));
+		}
+
+		static constexpr double ToDegrees(double radians) {
+			return radians * 57.295779513082320876798154814105;
+		}
+
+		static constexpr double ToRadians(double degrees) {
+			return degrees * 0.017453292519943295769236907684886;
+		}
+
+		static constexpr double WrapAngle(double angle) {
+			if ((angle > -PI) && (angle <= PI)) {
+				return angle;
+			}
+
+			angle = Remainder(angle, TWO_PI);
+
+			if (angle <= -PI) {
+				return angle + TWO_PI;
+			}
+
+			if (angle > PI) {
+				return angle - TWO_PI;
+			}
+
+			return angle;
+		}
+
+		static constexpr bool IsPowerOfTwo(int32_t v) {
+			return (v > 0) && ((v & (v - 1)) == 0);
+		}
+
 		//Returns - 1, 0, or 1 if the sign of the number is negative, 0, or positive.
-		static double Sign(double v);
+		static constexpr double Sign(double v) {
+			if (v < 0) {
+				return -1;
+			}
+
+			return v > 0 ? 1 : 0;
+		}
+
+	private:
+		/*
+		 fmod(value, divisor) for a positive divisor, by long division with the divisor doubled: every
+		 subtraction takes a step between half and all of the remainder, which is exact, so the result is
+		 the same as fmod while staying constexpr.
+		*/
+		static constexpr double Remainder(double value, double divisor) {
+			double remainder = value < 0 ? -value : value;
+
+			if (!(remainder < std::numeric_limits<double>::infinity())) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+
+			double step = divisor;
+
+			while (step * 2 <= remainder) {
+				step *= 2;
+			}
+
+			while (step >= divisor) {
+				remainder -= remainder >= step ? step : 0.0;
+				step *= 0.5;
+			}
+
+			return value < 0 ? -remainder : remainder;
+		}
 	};
 }
 
@@ -0,0 +1,512 @@
+#include <algorithm>
+#include "Noise.hpp"
+#include "MathHelper.hpp"
+#include "Parallel.hpp"
+#include "Random.hpp"
+
+namespace Xna {
+
+	//Gradients of the improved Perlin noise, indexed by hash & 15. Simplex and 2D noise use their X and Y.
+	static const double GradientX[16] = { 1, -1, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0, 1, 0, -1, 0 };
+	static const double GradientY[16] = { 1, 1, -1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1 };
+	static const double GradientZ[16] = { 0, 0, 0, 0, 1, 1, -1, -1, 1, 1, -1, -1, 0, 1, 0, -1 };
+
+	//Shifts every octave so that they do not all share the lattice origin.
+	static constexpr double OctaveOffsetX = 19.19;
+	static constexpr double OctaveOffsetY = 47.47;
+	static constexpr double OctaveOffsetZ = 73.73;
+
+	//Samples handed to each thread at least.
+	static constexpr size_t SampleGrain = 16384;
+
+	static int32_t FastFloor(double v) {
+		int32_t i = static_cast<int32_t>(v);
+		return v < i ? i - 1 : i;
+	}
+
+	static double Fade(double t) {
+		return t * t * t * (t * (t * 6 - 15) + 10);
+	}
+
+	static double Grad(uint8_t hash, double x, double y) {
+		return GradientX[hash & 15] * x + GradientY[hash & 15] * y;
+	}
+
+	static double Grad(uint8_t hash, double x, double y, double z) {
+		return GradientX[hash & 15] * x + GradientY[hash & 15] * y + GradientZ[hash & 15] * z;
+	}
+
+	static double Lattice(uint8_t hash) {
+		return hash * (2.0 / 255.0) - 1.0;
+	}
+
+	static double ValueAt(uint8_t const* p, double x, double y) {
+		int32_t xi = FastFloor(x);
+		int32_t yi = FastFloor(y);
+		int32_t X = xi & 255;
+		int32_t Y = yi & 255;
+		double u = Fade(x - xi);
+		double v = Fade(y - yi);
+		int32_t a = p[X] + Y;
+		int32_t b = p[X + 1] + Y;
+
+		return MathHelper::Lerp(
+			MathHelper::Lerp(Lattice(p[a]), Lattice(p[b]), u),
+			MathHelper::Lerp(Lattice(p[a + 1]), Lattice(p[b + 1]), u),
+			v);
+	}
+
+	static double ValueAt(uint8_t const* p, double x, double y, double z) {
+		int32_t xi = FastFloor(x);
+		int32_t yi = FastFloor(y);
+		int32_t zi = FastFloor(z);
+		int32_t X = xi & 255;
+		int32_t Y = yi & 255;
+		int32_t Z = zi & 255;
+		double u = Fade(x - xi);
+		double v = Fade(y - yi);
+		double w = Fade(z - zi);
+		int32_t a = p[X] + Y;
+		int32_t b = p[X + 1] + Y;
+		int32_t aa = p[a] + Z;
+		int32_t ab = p[a + 1] + Z;
+		int32_t ba = p[b] + Z;
+		int32_t bb = p[b + 1] + Z;
+
+		return MathHelper::Lerp(
+			MathHelper::Lerp(
+				MathHelper::Lerp(Lattice(p[aa]), Lattice(p[ba]), u),
+				MathHelper::Lerp(Lattice(p[ab]), Lattice(p[bb]), u), v),
+			MathHelper::Lerp(
+				MathHelper::Lerp(Lattice(p[aa + 1]), Lattice(p[ba + 1]), u),
+				MathHelper::Lerp(Lattice(p[ab + 1]), Lattice(p[bb + 1]), u), v),
+			w);
+	}
+
+	static double PerlinAt(uint8_t const* p, double x, double y) {
+		int32_t xi = FastFloor(x);
+		int32_t yi = FastFloor(y);
+		int32_t X = xi & 255;
+		int32_t Y = yi & 255;
+		double xf = x - xi;
+		double yf = y - yi;
+		double u = Fade(xf);
+		double v = Fade(yf);
+		int32_t a = p[X] + Y;
+		int32_t b = p[X + 1] + Y;
+
+		return MathHelper::Lerp(
+			MathHelper::Lerp(Grad(p[a], xf, yf), Grad(p[b], xf - 1, yf), u),
+			MathHelper::Lerp(Grad(p[a + 1], xf, yf - 1), Grad(p[b + 1], xf - 1, yf - 1), u),
+			v);
+	}
+
+	static double PerlinAt(uint8_t const* p, double x, double y, double z) {
+		int32_t xi = FastFloor(x);
+		int32_t yi = FastFloor(y);
+		int32_t zi = FastFloor(z);
+		int32_t X = xi & 255;
+		int32_t Y = yi & 255;
+		int32_t Z = zi & 255;
+		double xf = x - xi;
+		double yf = y - yi;
+		double zf = z - zi;
+		double u = Fade(xf);
+		double v = Fade(yf);
+		double w = Fade(zf);
+		int32_t a = p[X] + Y;
+		int32_t b = p[X + 1] + Y;
+		int32_t aa = p[a] + Z;
+		int32_t ab = p[a + 1] + Z;
+		int32_t ba = p[b] + Z;
+		int32_t bb = p[b + 1] + Z;
+
+		return MathHelper::Lerp(
+			MathHelper::Lerp(
+				MathHelper::Lerp(Grad(p[aa], xf, yf, zf), Grad(p[ba], xf - 1, yf, zf), u),
+				MathHelper::Lerp(Grad(p[ab], xf, yf - 1, zf), Grad(p[bb], xf - 1, yf - 1, zf), u), v),
+			MathHelper::Lerp(
+				MathHelper::Lerp(Grad(p[aa + 1], xf, yf, zf - 1), Grad(p[ba + 1], xf - 1, yf, zf - 1), u),
+				MathHelper::Lerp(Grad(p[ab + 1], xf, yf - 1, zf - 1), Grad(p[bb + 1], xf - 1, yf - 1, zf - 1), u), v),
+			w);
+	}
+
+	static double SimplexCorner(uint8_t hash, double x, double y) {
+		double t = 0.5 - x * x - y * y;
+
+		if (t < 0) {
+			return 0;
+		}
+
+		t *= t;
+		return t * t * Grad(hash, x, y);
+	}
+
+	static double SimplexCorner(uint8_t hash, double x, double y, double z) {
+		double t = 0.6 - x * x - y * y - z * z;
+
+		if (t < 0) {
+			return 0;
+		}
+
+		t *= t;
+		return t * t * Grad(hash, x, y, z);
+	}
+
+	//Stefan Gustavson's formulation.
+	static double SimplexAt(uint8_t const* p, double x, double y) {
+		const double F2 = 0.36602540378443864676;
+		const double G2 = 0.21132486540518711775;
+
+		double s = (x + y) * F2;
+		int32_t i = FastFloor(x + s);
+		int32_t j = FastFloor(y + s);
+		double t = (i + j) * G2;
+		double x0 = x - (i - t);
+		double y0 = y - (j - t);
+
+		int32_t i1 = x0 > y0 ? 1 : 0;
+		int32_t j1 = 1 - i1;
+
+		double x1 = x0 - i1 + G2;
+		double y1 = y0 - j1 + G2;
+		double x2 = x0 - 1.0 + 2.0 * G2;
+		double y2 = y0 - 1.0 + 2.0 * G2;
+
+		int32_t ii = i & 255;
+		int32_t jj = j & 255;
+
+		return 70.0 * (SimplexCorner(p[ii + p[jj]], x0, y0)
+			+ SimplexCorner(p[ii + i1 + p[jj + j1]], x1, y1)
+			+ SimplexCorner(p[ii + 1 + p[jj + 1]], x2, y2));
+	}
+
+	static double SimplexAt(uint8_t const* p, double x, double y, double z) {
+		const double F3 = 1.0 / 3.0;
+		const double G3 = 1.0 / 6.0;
+
+		double s = (x + y + z) * F3;
+		int32_t i = FastFloor(x + s);
+		int32_t j = FastFloor(y + s);
+		int32_t k = FastFloor(z + s);
+		double t = (i + j + k) * G3;
+		double x0 = x - (i - t);
+		double y0 = y - (j - t);
+		double z0 = z - (k - t);
+
+		int32_t i1, j1, k1, i2, j2, k2;
+
+		if (x0 >= y0) {
+			if (y0 >= z0) { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+			else if (x0 >= z0) { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1; }
+			else { i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1; }
+		}
+		else {
+			if (y0 < z0) { i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1; }
+			else if (x0 < z0) { i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1; }
+			else { i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+		}
+
+		double x1 = x0 - i1 + G3;
+		double y1 = y0 - j1 + G3;
+		double z1 = z0 - k1 + G3;
+		double x2 = x0 - i2 + 2.0 * G3;
+		double y2 = y0 - j2 + 2.0 * G3;
+		double z2 = z0 - k2 + 2.0 * G3;
+		double x3 = x0 - 1.0 + 3.0 * G3;
+		double y3 = y0 - 1.0 + 3.0 * G3;
+		double z3 = z0 - 1.0 + 3.0 * G3;
+
+		int32_t ii = i & 255;
+		int32_t jj = j & 255;
+		int32_t kk = k & 255;
+
+		return 32.0 * (SimplexCorner(p[ii + p[jj + p[kk]]], x0, y0, z0)
+			+ SimplexCorner(p[ii + i1 + p[jj + j1 + p[kk + k1]]], x1, y1, z1)
+			+ SimplexCorner(p[ii + i2 + p[jj + j2 + p[kk + k2]]], x2, y2, z2)
+			+ SimplexCorner(p[ii + 1 + p[jj + 1 + p[kk + 1]]], x3, y3, z3));
+	}
+
+	Noise::Noise() {
+		Seed(0);
+	}
+
+	Noise::Noise(uint64_t seed) {
+		Seed(seed);
+	}
+
+	void Noise::Seed(uint64_t seed) {
+		Random random(seed);
+
+		for (int32_t i = 0; i < 256; i++) {
+			perm[i] = static_cast<uint8_t>(i);
+		}
+
+		//Fisher-Yates.
+		for (int32_t i = 255; i > 0; i--) {
+			std::swap(perm[i], perm[random.Next(0, i + 1)]);
+		}
+
+		for (int32_t i = 0; i < 256; i++) {
+			perm[i + 256] = perm[i];
+		}
+	}
+
+	double Noise::Value(double x, double y) const {
+		return ValueAt(perm, x, y);
+	}
+
+	double Noise::Value(double x, double y, double z) const {
+		return ValueAt(perm, x, y, z);
+	}
+
+	double Noise::Perlin(double x, double y) const {
+		return PerlinAt(perm, x, y);
+	}
+
+	double Noise::Perlin(double x, double y, double z) const {
+		return PerlinAt(perm, x, y, z);
+	}
+
+	double Noise::Simplex(double x, double y) const {
+		return SimplexAt(perm, x, y);
+	}
+
+	double Noise::Simplex(double x, double y, double z) const {
+		return SimplexAt(perm, x, y, z);
+	}
+
+	double Noise::Evaluate(NoiseType type, double x, double y) const {
+		switch (type) {
+		case NoiseType::Value:
+			return ValueAt(perm, x, y);
+		case NoiseType::Simplex:
+			return SimplexAt(perm, x, y);
+		default:
+			return PerlinAt(perm, x, y);
+		}
+	}
+
+	double Noise::Evaluate(NoiseType type, double x, double y, double z) const {
+		switch (type) {
+		case NoiseType::Value:
+			return ValueAt(perm, x, y, z);
+		case NoiseType::Simplex:
+			return SimplexAt(perm, x, y, z);
+		default:
+			return PerlinAt(perm, x, y, z);
+		}
+	}
+
+	double Noise::Fractal(NoiseSettings const& settings, double x, double y) const {
+		double sum = 0;
+		double total = 0;
+		double amplitude = 1;
+		double frequency = settings.Frequency;
+
+		for (int32_t o = 0; o < settings.Octaves; o++) {
+			sum += amplitude * Evaluate(settings.Type, x * frequency + o * OctaveOffsetX, y * frequency + o * OctaveOffsetY);
+			total += amplitude;
+			amplitude *= settings.Gain;
+			frequency *= settings.Lacunarity;
+		}
+
+		return total != 0 ? sum / total : 0;
+	}
+
+	double Noise::Fractal(NoiseSettings const& settings, double x, double y, double z) const {
+		double sum = 0;
+		double total = 0;
+		double amplitude = 1;
+		double frequency = settings.Frequency;
+
+		for (int32_t o = 0; o < settings.Octaves; o++) {
+			sum += amplitude * Evaluate(settings.Type,
+				x * frequency + o * OctaveOffsetX, y * frequency + o * OctaveOffsetY, z * frequency + o * OctaveOffsetZ);
+			total += amplitude;
+			amplitude *= settings.Gain;
+			frequency *= settings.Lacunarity;
+		}
+
+		return total != 0 ? sum / total : 0;
+	}
+
+	bool Noise::Sample(NoiseSettings const& settings, std::vector<Vector2> const& positions, std::vector<double>& destination) const {
+		destination.resize(positions.size());
+
+		Parallel::For(0, positions.size(), SampleGrain, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) {
+				destination[i] = Fractal(settings, positions[i].X, positions[i].Y);
+			}
+		});
+
+		return true;
+	}
+
+	bool Noise::Sample(NoiseSettings const& settings, std::vector<Vector3> const& positions, std::vector<double>& destination) const {
+		destination.resize(positions.size());
+
+		Parallel::For(0, positions.size(), SampleGrain, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) {
+				destination[i] = Fractal(settings, positions[i].X, positions[i].Y, positions[i].Z);
+			}
+		});
+
+		return true;
+	}
+
+	/*
+	 Column terms of Value and Perlin noise for every octave of a grid: the fraction, its fade and
+	 the first permutation lookup do not depend on the row.
+	*/
+	struct GridColumns {
+		std::vector<double> Fraction;
+		std::vector<double> Fade;
+		std::vector<int32_t> Left;
+		std::vector<int32_t> Right;
+
+		GridColumns(uint8_t const* p, NoiseSettings const& settings, double originX, double spacingX, size_t width) {
+			size_t octaves = static_cast<size_t>(std::max(0, settings.Octaves));
+			double frequency = settings.Frequency;
+
+			Fraction.resize(octaves * width);
+			Fade.resize(octaves * width);
+			Left.resize(octaves * width);
+			Right.resize(octaves * width);
+
+			for (size_t o = 0; o < octaves; o++) {
+				for (size_t i = 0; i < width; i++) {
+					double x = (originX + i * spacingX) * frequency + o * OctaveOffsetX;
+					int32_t xi = FastFloor(x);
+					int32_t X = xi & 255;
+					size_t c = o * width + i;
+
+					Fraction[c] = x - xi;
+					Fade[c] = Xna::Fade(x - xi);
+					Left[c] = p[X];
+					Right[c] = p[X + 1];
+				}
+
+				frequency *= settings.Lacunarity;
+			}
+		}
+	};
+
+	bool Noise::SampleGrid(NoiseSettings const& settings, Vector2 const& origin, Vector2 const& spacing,
+		int32_t width, int32_t height, std::vector<double>& destination) const {
+		if (width < 0 || height < 0) {
+			return false;
+		}
+
+		size_t w = static_cast<size_t>(width);
+		size_t h = static_cast<size_t>(height);
+		destination.assign(w * h, 0.0);
+
+		if (w == 0 || h == 0) {
+			return true;
+		}
+
+		uint8_t const* p = perm;
+		double* output = destination.data();
+
+		Parallel::For(0, h, std::max<size_t>(1, SampleGrain / w), [&](size_t first, size_t last) {
+			bool separable = settings.Type != NoiseType::Simplex;
+			GridColumns columns(p, settings, origin.X, spacing.X, separable ? w : 0);
+
+			for (size_t j = first; j < last; j++) {
+				double* row = output + j * w;
+				double y = origin.Y + j * spacing.Y;
+				double total = 0;
+				double amplitude = 1;
+				double frequency = settings.Frequency;
+
+				for (int32_t o = 0; o < settings.Octaves; o++) {
+					double yo = y * frequency + o * OctaveOffsetY;
+
+					if (separable) {
+						int32_t yi = FastFloor(yo);
+						int32_t Y = yi & 255;
+						double yf = yo - yi;
+						double v = Fade(yf);
+						size_t c = static_cast<size_t>(o) * w;
+						double const* xf = columns.Fraction.data() + c;
+						double const* u = columns.Fade.data() + c;
+						int32_t const* left = columns.Left.data() + c;
+						int32_t const* right = columns.Right.data() + c;
+
+						if (settings.Type == NoiseType::Value) {
+							for (size_t i = 0; i < w; i++) {
+								int32_t a = left[i] + Y;
+								int32_t b = right[i] + Y;
+
+								row[i] += amplitude * MathHelper::Lerp(
+									MathHelper::Lerp(Lattice(p[a]), Lattice(p[b]), u[i]),
+									MathHelper::Lerp(Lattice(p[a + 1]), Lattice(p[b + 1]), u[i]),
+									v);
+							}
+						}
+						else {
+							for (size_t i = 0; i < w; i++) {
+								int32_t a = left[i] + Y;
+								int32_t b = right[i] + Y;
+
+								row[i] += amplitude * MathHelper::Lerp(
+									MathHelper::Lerp(Grad(p[a], xf[i], yf), Grad(p[b], xf[i] - 1, yf), u[i]),
+									MathHelper::Lerp(Grad(p[a + 1], xf[i], yf - 1), Grad(p[b + 1], xf[i] - 1, yf - 1), u[i]),
+									v);
+							}
+						}
+					}
+					else {
+						for (size_t i = 0; i < w; i++) {
+							double x = (origin.X + i * spacing.X) * frequency + o * OctaveOffsetX;
+							row[i] += amplitude * SimplexAt(p, x, yo);
+						}
+					}
+
+					total += amplitude;
+					amplitude *= settings.Gain;
+					frequency *= settings.Lacunarity;
+				}
+
+				if (total != 0) {
+					for (size_t i = 0; i < w; i++) {
+						row[i] /= total;
+					}
+				}
+			}
+		});
+
+		return true;
+	}
+
+	bool Noise::SampleGrid(NoiseSettings const& settings, Vector3 const& origin, Vector3 const& spacing,
+		int32_t width, int32_t height, int32_t depth, std::vector<double>& destination) const {
+		if (width < 0 || height < 0 || depth < 0) {
+			return false;
+		}
+
+		size_t w = static_cast<size_t>(width);
+		size_t h = static_cast<size_t>(height);
+		size_t rows = h * static_cast<size_t>(depth);
+		destination.resize(w * rows);
+
+		if (w == 0) {
+			return true;
+		}
+
+		Parallel::For(0, rows, std::max<size_t>(1, SampleGrain / w), [&](size_t first, size_t last) {
+			for (size_t r = first; r < last; r++) {
+				double y = origin.Y + (r % h) * spacing.Y;
+				double z = origin.Z + (r / h) * spacing.Z;
+				double* row = destination.data() + r * w;
+
+				for (size_t i = 0; i < w; i++) {
+					row[i] = Fractal(settings, origin.X + i * spacing.X, y, z);
+				}
+			}
+		});
+
+		return true;
+	}
+}
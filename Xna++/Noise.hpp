@@ -0,0 +1,76 @@
+#ifndef _NOISE_H_
+#define _NOISE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	enum class NoiseType {
+		Value,
+		Perlin,
+		Simplex
+	};
+
+	//Fractal Brownian motion: 'Octaves' layers, each 'Lacunarity' times the frequency and 'Gain' times the amplitude of the previous one.
+	struct NoiseSettings {
+		NoiseType Type{ NoiseType::Perlin };
+		int32_t Octaves{ 1 };
+		double Frequency{ 1.0 };
+		double Lacunarity{ 2.0 };
+		double Gain{ 0.5 };
+	};
+
+	/*
+	 Value, Perlin (improved) and Simplex noise over a permutation table shuffled from a seed,
+	 so a seed gives the same field on every platform. Results are roughly in [-1, 1];
+	 fractal sums are divided by the total amplitude to stay in the same range.
+	 Coordinates, once multiplied by the frequency, must fit in an int32.
+
+	 The batch methods split their work over Parallel::For. Grids are evaluated row by row:
+	 for Value and Perlin noise everything that depends only on the column is computed once per
+	 octave, which leaves a short branch-free inner loop per sample.
+	*/
+	class Noise {
+	public:
+		Noise();
+		Noise(uint64_t seed);
+
+		void Seed(uint64_t seed);
+
+		double Value(double x, double y) const;
+		double Value(double x, double y, double z) const;
+		double Perlin(double x, double y) const;
+		double Perlin(double x, double y, double z) const;
+		double Simplex(double x, double y) const;
+		double Simplex(double x, double y, double z) const;
+
+		double Evaluate(NoiseType type, double x, double y) const;
+		double Evaluate(NoiseType type, double x, double y, double z) const;
+		double Fractal(NoiseSettings const& settings, double x, double y) const;
+		double Fractal(NoiseSettings const& settings, double x, double y, double z) const;
+
+		//destination is resized to positions.size().
+		bool Sample(NoiseSettings const& settings, std::vector<Vector2> const& positions, std::vector<double>& destination) const;
+		bool Sample(NoiseSettings const& settings, std::vector<Vector3> const& positions, std::vector<double>& destination) const;
+
+		/*
+		 Samples origin + (i, j) * spacing for i < width and j < height, into destination[j * width + i].
+		 destination is resized; returns false if a dimension is negative.
+		*/
+		bool SampleGrid(NoiseSettings const& settings, Vector2 const& origin, Vector2 const& spacing,
+			int32_t width, int32_t height, std::vector<double>& destination) const;
+		//3D grid, into destination[(k * height + j) * width + i].
+		bool SampleGrid(NoiseSettings const& settings, Vector3 const& origin, Vector3 const& spacing,
+			int32_t width, int32_t height, int32_t depth, std::vector<double>& destination) const;
+
+	private:
+		//Duplicated so that perm[i + j] needs no wrapping for i, j < 256.
+		uint8_t perm[512];
+	};
+}
+
+#endif
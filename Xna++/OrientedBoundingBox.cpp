@@ -0,0 +1,334 @@
+#include <cmath>
+#include <limits>
+#include "OrientedBoundingBox.hpp"
+#include "Matrix.hpp"
+#include "Simd.hpp"
+
+namespace Xna {
+
+	//Added to the rotation terms so that nearly parallel edges, whose cross product vanishes, give no false separation.
+	static constexpr double ParallelEpsilon = 1e-12;
+
+	//Center, half extents and axes of T::Width boxes, one lane each.
+	template <typename T>
+	struct BoxLanes {
+		T Center[3];
+		T Extent[3];
+		T Axis[3][3];
+	};
+
+	static void Unpack(OrientedBoundingBox const& box, double* values) {
+		Vector3 const* vectors[] = { &box.Center, &box.HalfExtent, &box.AxisX, &box.AxisY, &box.AxisZ };
+
+		for (size_t v = 0; v < 5; v++) {
+			values[v * 3] = vectors[v]->X;
+			values[v * 3 + 1] = vectors[v]->Y;
+			values[v * 3 + 2] = vectors[v]->Z;
+		}
+	}
+
+	//values[field * T::Width + lane], with the fields in the order of Unpack.
+	template <typename T>
+	static BoxLanes<T> LoadLanes(double const* values) {
+		BoxLanes<T> lanes;
+
+		for (size_t k = 0; k < 3; k++) {
+			lanes.Center[k] = T::Load(values + k * T::Width);
+			lanes.Extent[k] = T::Load(values + (3 + k) * T::Width);
+
+			for (size_t a = 0; a < 3; a++) {
+				lanes.Axis[a][k] = T::Load(values + (6 + a * 3 + k) * T::Width);
+			}
+		}
+
+		return lanes;
+	}
+
+	template <typename T>
+	static BoxLanes<T> Broadcast(OrientedBoundingBox const& box) {
+		double values[15];
+		Unpack(box, values);
+
+		BoxLanes<T> lanes;
+
+		for (size_t k = 0; k < 3; k++) {
+			lanes.Center[k] = T::Set(values[k]);
+			lanes.Extent[k] = T::Set(values[3 + k]);
+
+			for (size_t a = 0; a < 3; a++) {
+				lanes.Axis[a][k] = T::Set(values[6 + a * 3 + k]);
+			}
+		}
+
+		return lanes;
+	}
+
+	/*
+	 Separating axis test (Ericson, Real-Time Collision Detection 4.4.1) between 'a' and every lane of 'b',
+	 done in the frame of 'a'. Returns the mask of the lanes that are separated.
+	*/
+	template <typename T>
+	static typename T::Mask Separated(BoxLanes<T> const& a, BoxLanes<T> const& b) {
+		T epsilon = T::Set(ParallelEpsilon);
+		T r[3][3];
+		T absR[3][3];
+
+		for (size_t i = 0; i < 3; i++) {
+			for (size_t j = 0; j < 3; j++) {
+				r[i][j] = a.Axis[i][0] * b.Axis[j][0] + a.Axis[i][1] * b.Axis[j][1] + a.Axis[i][2] * b.Axis[j][2];
+				absR[i][j] = T::Abs(r[i][j]) + epsilon;
+			}
+		}
+
+		T d[3];
+		for (size_t k = 0; k < 3; k++) {
+			d[k] = b.Center[k] - a.Center[k];
+		}
+
+		T t[3];
+		for (size_t i = 0; i < 3; i++) {
+			t[i] = d[0] * a.Axis[i][0] + d[1] * a.Axis[i][1] + d[2] * a.Axis[i][2];
+		}
+
+		typename T::Mask separated = T::Abs(t[0]) > a.Extent[0] + b.Extent[0] * absR[0][0] + b.Extent[1] * absR[0][1] + b.Extent[2] * absR[0][2];
+
+		for (size_t i = 1; i < 3; i++) {
+			T rb = b.Extent[0] * absR[i][0] + b.Extent[1] * absR[i][1] + b.Extent[2] * absR[i][2];
+			separated = separated | (T::Abs(t[i]) > a.Extent[i] + rb);
+		}
+
+		for (size_t j = 0; j < 3; j++) {
+			T ra = a.Extent[0] * absR[0][j] + a.Extent[1] * absR[1][j] + a.Extent[2] * absR[2][j];
+			T distance = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+			separated = separated | (T::Abs(distance) > ra + b.Extent[j]);
+		}
+
+		//Axis i of a crossed with axis j of b.
+		for (size_t i = 0; i < 3; i++) {
+			size_t i1 = (i + 1) % 3;
+			size_t i2 = (i + 2) % 3;
+
+			for (size_t j = 0; j < 3; j++) {
+				size_t j1 = (j + 1) % 3;
+				size_t j2 = (j + 2) % 3;
+
+				T ra = a.Extent[i1] * absR[i2][j] + a.Extent[i2] * absR[i1][j];
+				T rb = b.Extent[j1] * absR[i][j2] + b.Extent[j2] * absR[i][j1];
+				T distance = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+				separated = separated | (T::Abs(distance) > ra + rb);
+			}
+		}
+
+		return separated;
+	}
+
+	OrientedBoundingBox::OrientedBoundingBox() {}
+	OrientedBoundingBox::OrientedBoundingBox(Vector3 const& center, Vector3 const& halfExtent) :
+		Center(center), HalfExtent(halfExtent) {}
+	OrientedBoundingBox::OrientedBoundingBox(Vector3 const& center, Vector3 const& halfExtent, Quaternion const& orientation) :
+		Center(center), HalfExtent(halfExtent) {
+		SetOrientation(orientation);
+	}
+
+	bool operator== (OrientedBoundingBox const& b1, OrientedBoundingBox const& b2) {
+		return b1.Center == b2.Center
+			&& b1.HalfExtent == b2.HalfExtent
+			&& b1.AxisX == b2.AxisX
+			&& b1.AxisY == b2.AxisY
+			&& b1.AxisZ == b2.AxisZ;
+	}
+
+	bool operator!= (OrientedBoundingBox const& b1, OrientedBoundingBox const& b2) {
+		return !(b1 == b2);
+	}
+
+	bool OrientedBoundingBox::Intersects(OrientedBoundingBox const& box, std::vector<OrientedBoundingBox> const& boxes,
+		size_t index, size_t length, std::vector<size_t>& hits) {
+
+		if (index > boxes.size() || length > boxes.size() - index) {
+			return false;
+		}
+
+		hits.clear();
+
+		size_t i = index;
+		size_t last = index + length;
+
+#ifdef XNA_SIMD_SSE2
+		BoxLanes<Simd::Pair> pairA = Broadcast<Simd::Pair>(box);
+
+		for (; i + 2 <= last; i += 2) {
+			double fields[2][15];
+			double values[15 * 2];
+
+			Unpack(boxes[i], fields[0]);
+			Unpack(boxes[i + 1], fields[1]);
+
+			for (size_t f = 0; f < 15; f++) {
+				values[f * 2] = fields[0][f];
+				values[f * 2 + 1] = fields[1][f];
+			}
+
+			int separated = Separated(pairA, LoadLanes<Simd::Pair>(values)).Bits();
+
+			if ((separated & 1) == 0) {
+				hits.push_back(i);
+			}
+
+			if ((separated & 2) == 0) {
+				hits.push_back(i + 1);
+			}
+		}
+#endif
+
+		for (; i < last; i++) {
+			if (box.Intersects(boxes[i])) {
+				hits.push_back(i);
+			}
+		}
+
+		return true;
+	}
+
+	Quaternion OrientedBoundingBox::Orientation() const {
+		Matrix m{};
+		m.M11 = AxisX.X;
+		m.M12 = AxisX.Y;
+		m.M13 = AxisX.Z;
+		m.M21 = AxisY.X;
+		m.M22 = AxisY.Y;
+		m.M23 = AxisY.Z;
+		m.M31 = AxisZ.X;
+		m.M32 = AxisZ.Y;
+		m.M33 = AxisZ.Z;
+		m.M44 = 1;
+
+		return Quaternion::CreateFromRotationMatrix(m);
+	}
+
+	//The rows of the rotation matrix built from the quaternion, i.e. the unit axes rotated by it.
+	void OrientedBoundingBox::SetOrientation(Quaternion const& q) {
+		double xx = q.X * q.X;
+		double yy = q.Y * q.Y;
+		double zz = q.Z * q.Z;
+		double xy = q.X * q.Y;
+		double zw = q.Z * q.W;
+		double zx = q.Z * q.X;
+		double yw = q.Y * q.W;
+		double yz = q.Y * q.Z;
+		double xw = q.X * q.W;
+
+		AxisX = Vector3(1.0 - 2.0 * (yy + zz), 2.0 * (xy + zw), 2.0 * (zx - yw));
+		AxisY = Vector3(2.0 * (xy - zw), 1.0 - 2.0 * (zz + xx), 2.0 * (yz + xw));
+		AxisZ = Vector3(2.0 * (zx + yw), 2.0 * (yz - xw), 1.0 - 2.0 * (yy + xx));
+	}
+
+	void OrientedBoundingBox::GetCorners(std::vector<Vector3>& corners) const {
+		Vector3 x = AxisX * HalfExtent.X;
+		Vector3 y = AxisY * HalfExtent.Y;
+		Vector3 z = AxisZ * HalfExtent.Z;
+
+		corners.resize(8);
+		corners[0] = Center - x - y - z;
+		corners[1] = Center + x - y - z;
+		corners[2] = Center + x + y - z;
+		corners[3] = Center - x + y - z;
+		corners[4] = Center - x - y + z;
+		corners[5] = Center + x - y + z;
+		corners[6] = Center + x + y + z;
+		corners[7] = Center - x + y + z;
+	}
+
+	Vector3 OrientedBoundingBox::ClosestPoint(Vector3 const& point) const {
+		Vector3 d = point - Center;
+		Vector3 const* axes[] = { &AxisX, &AxisY, &AxisZ };
+		double extents[] = { HalfExtent.X, HalfExtent.Y, HalfExtent.Z };
+		Vector3 result = Center;
+
+		for (size_t i = 0; i < 3; i++) {
+			double distance = Vector3::Dot(d, *axes[i]);
+
+			if (distance > extents[i]) {
+				distance = extents[i];
+			}
+			else if (distance < -extents[i]) {
+				distance = -extents[i];
+			}
+
+			result += *axes[i] * distance;
+		}
+
+		return result;
+	}
+
+	bool OrientedBoundingBox::Contains(Vector3 const& point) const {
+		Vector3 d = point - Center;
+
+		return std::fabs(Vector3::Dot(d, AxisX)) <= HalfExtent.X
+			&& std::fabs(Vector3::Dot(d, AxisY)) <= HalfExtent.Y
+			&& std::fabs(Vector3::Dot(d, AxisZ)) <= HalfExtent.Z;
+	}
+
+	bool OrientedBoundingBox::Equals(OrientedBoundingBox const& other) const {
+		return *this == other;
+	}
+
+	bool OrientedBoundingBox::Intersects(OrientedBoundingBox const& other) const {
+		double values[15];
+		Unpack(other, values);
+
+		return Separated(Broadcast<Simd::Scalar>(*this), LoadLanes<Simd::Scalar>(values)).Bits() == 0;
+	}
+
+	bool OrientedBoundingBox::Intersects(Vector3 const& sphereCenter, double sphereRadius) const {
+		Vector3 d = sphereCenter - ClosestPoint(sphereCenter);
+		return Vector3::Dot(d, d) <= sphereRadius * sphereRadius;
+	}
+
+	//Slabs in the frame of the box.
+	bool OrientedBoundingBox::Intersects(Vector3 const& rayPosition, Vector3 const& rayDirection, double& distance) const {
+		Vector3 d = rayPosition - Center;
+		Vector3 const* axes[] = { &AxisX, &AxisY, &AxisZ };
+		double extents[] = { HalfExtent.X, HalfExtent.Y, HalfExtent.Z };
+		double tMin = 0.0;
+		double tMax = std::numeric_limits<double>::infinity();
+
+		for (size_t i = 0; i < 3; i++) {
+			double origin = Vector3::Dot(d, *axes[i]);
+			double direction = Vector3::Dot(rayDirection, *axes[i]);
+
+			if (std::fabs(direction) < 1e-15) {
+				if (std::fabs(origin) > extents[i]) {
+					return false;
+				}
+
+				continue;
+			}
+
+			double inverse = 1.0 / direction;
+			double t1 = (-extents[i] - origin) * inverse;
+			double t2 = (extents[i] - origin) * inverse;
+
+			if (t1 > t2) {
+				double swap = t1;
+				t1 = t2;
+				t2 = swap;
+			}
+
+			if (t1 > tMin) {
+				tMin = t1;
+			}
+
+			if (t2 < tMax) {
+				tMax = t2;
+			}
+
+			if (tMin > tMax) {
+				return false;
+			}
+		}
+
+		distance = tMin;
+		return true;
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef _ORIENTEDBOUNDINGBOX_H_
+#define _ORIENTEDBOUNDINGBOX_H_
+
+#include <cstddef>
+#include <vector>
+#include "Vector3.hpp"
+#include "Quaternion.hpp"
+
+namespace Xna {
+
+	/*
+	 Box of half size HalfExtent along three orthonormal axes around Center. The axes are stored instead of
+	 the orientation so that the tests do not rebuild them from a Quaternion: the constructor and
+	 SetOrientation compute them once per box.
+	*/
+	class OrientedBoundingBox {
+	public:
+		Vector3 Center;
+		Vector3 HalfExtent;
+		Vector3 AxisX{ 1, 0, 0 };
+		Vector3 AxisY{ 0, 1, 0 };
+		Vector3 AxisZ{ 0, 0, 1 };
+
+		OrientedBoundingBox();
+		OrientedBoundingBox(Vector3 const& center, Vector3 const& halfExtent);
+		OrientedBoundingBox(Vector3 const& center, Vector3 const& halfExtent, Quaternion const& orientation);
+
+		friend bool operator== (OrientedBoundingBox const&, OrientedBoundingBox const&);
+		friend bool operator!= (OrientedBoundingBox const&, OrientedBoundingBox const&);
+
+		/*
+		 Tests 'box' against boxes[index] to boxes[index + length - 1], two boxes per SSE2 instruction, and
+		 writes the indices of the intersecting ones into hits (cleared first).
+		 Returns false if the range is out of bounds.
+		*/
+		static bool Intersects(OrientedBoundingBox const& box, std::vector<OrientedBoundingBox> const& boxes,
+			size_t index, size_t length, std::vector<size_t>& hits);
+
+		Quaternion Orientation() const;
+		void SetOrientation(Quaternion const& orientation);
+		//Corners of the face at -AxisZ first, each face counterclockwise from (-X, -Y).
+		void GetCorners(std::vector<Vector3>& corners) const;
+		Vector3 ClosestPoint(Vector3 const& point) const;
+		bool Contains(Vector3 const& point) const;
+		bool Equals(OrientedBoundingBox const& other) const;
+		//Separating axis test over the 15 candidate axes.
+		bool Intersects(OrientedBoundingBox const& other) const;
+		bool Intersects(Vector3 const& sphereCenter, double sphereRadius) const;
+		/*
+		 Ray test; distance is measured in multiples of direction, and is 0 when the ray starts inside the box.
+		 Returns false, leaving distance untouched, if the ray misses.
+		*/
+		bool Intersects(Vector3 const& rayPosition, Vector3 const& rayDirection, double& distance) const;
+	};
+}
+
+#endif
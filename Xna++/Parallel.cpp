@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "Parallel.hpp"
+#include "ThreadPool.hpp"
+
+namespace Xna {
+
+	static std::atomic<size_t> threadCount{ 0 };
+
+	size_t Parallel::ThreadCount() {
+		size_t count = threadCount.load(std::memory_order_relaxed);
+
+		if (count == 0) {
+			count = std::thread::hardware_concurrency();
+		}
+
+		return count == 0 ? 1 : count;
+	}
+
+	void Parallel::SetThreadCount(size_t count) {
+		threadCount.store(count, std::memory_order_relaxed);
+	}
+
+	//Created by the first call that runs in parallel, and kept until exit.
+	static ThreadPool& Pool() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	//Ranges of one call of For, and the ones still running.
+	struct ParallelRanges {
+		std::function<void(size_t, size_t)> const* Body;
+		size_t Begin;
+		size_t Size;
+		size_t Remainder;
+		std::mutex Mutex;
+		std::condition_variable Done;
+		size_t Remaining;
+		std::exception_ptr Error;
+
+		void Run(size_t index) {
+			size_t first = Begin + index * Size + std::min(index, Remainder);
+			size_t last = first + Size + (index < Remainder ? 1 : 0);
+
+			try {
+				(*Body)(first, last);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(Mutex);
+
+				if (!Error) {
+					Error = std::current_exception();
+				}
+			}
+
+			//Counted down under the mutex, so that the caller cannot return before the notification is done.
+			std::lock_guard<std::mutex> lock(Mutex);
+
+			if (--Remaining == 0) {
+				Done.notify_all();
+			}
+		}
+
+		//Runs queued tasks while ranges are left, then sleeps until the running ones finish.
+		void Wait() {
+			while (true) {
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+
+					if (Remaining == 0) {
+						return;
+					}
+				}
+
+				if (!Pool().RunPending()) {
+					break;
+				}
+			}
+
+			std::unique_lock<std::mutex> lock(Mutex);
+			Done.wait(lock, [this] { return Remaining == 0; });
+		}
+	};
+
+	//Waits for the submitted ranges even when the range of the caller throws, since they use its stack.
+	struct ParallelWait {
+		ParallelRanges& Ranges;
+
+		~ParallelWait() {
+			Ranges.Wait();
+		}
+	};
+
+	void Parallel::For(size_t begin, size_t end, size_t grain, std::function<void(size_t, size_t)> const& body) {
+		if (end <= begin) {
+			return;
+		}
+
+		if (grain == 0) {
+			grain = 1;
+		}
+
+		size_t count = end - begin;
+		size_t ranges = count / grain;
+
+		if (ranges > ThreadCount()) {
+			ranges = ThreadCount();
+		}
+
+		if (ranges < 2) {
+			body(begin, end);
+			return;
+		}
+
+		ParallelRanges state;
+		state.Body = &body;
+		state.Begin = begin;
+		state.Size = count / ranges;
+		state.Remainder = count % ranges;
+		state.Remaining = ranges - 1;
+
+		ThreadPool& pool = Pool();
+
+		{
+			ParallelWait wait{ state };
+
+			for (size_t i = 1; i < ranges; i++) {
+				//A pointer and an index, small enough for std::function to store without allocating.
+				ParallelRanges* shared = &state;
+				pool.Submit([shared, i] { shared->Run(i); });
+			}
+
+			body(begin, begin + state.Size + (state.Remainder > 0 ? 1 : 0));
+		}
+
+		if (state.Error) {
+			std::rethrow_exception(state.Error);
+		}
+	}
+}
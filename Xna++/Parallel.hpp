@@ -0,0 +1,27 @@
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace Xna {
+
+	class Parallel {
+	public:
+		//Number of worker threads used by For, never less than 1.
+		static size_t ThreadCount();
+		//0 restores the hardware concurrency.
+		static void SetThreadCount(size_t count);
+
+		/*
+		 Splits [begin, end) into contiguous ranges of at least 'grain' items, at most ThreadCount(), and
+		 calls body(first, last) for each of them. The calling thread takes the first range, the others go
+		 to a ThreadPool created by the first call that needs it and kept until exit; while they run, the
+		 caller runs queued tasks too, so body may call For. Runs serially when the range is smaller than
+		 two grains. If body throws, For waits for the other ranges, then rethrows the first exception.
+		*/
+		static void For(size_t begin, size_t end, size_t grain, std::function<void(size_t, size_t)> const& body);
+	};
+}
+
+#endif
@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <cmath>
+#include "ParticleSystem.hpp"
+#include "MathHelper.hpp"
+#include "Parallel.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XNA_PARTICLES_SSE2
+#endif
+
+namespace Xna {
+
+	//Intervals of the baked curves over the normalized age.
+	static constexpr size_t TableSize = 256;
+	static constexpr size_t UpdateGrain = 16384;
+
+	static double SizeAt(Curve const& curve, double age) {
+		return curve.Keys.Count() == 0 ? 1.0 : curve.Evaluate(age);
+	}
+
+	static Color ColorAt(ParticleSettings const& settings, double age) {
+		double amount = settings.ColorCurve.Keys.Count() == 0 ? age : settings.ColorCurve.Evaluate(age);
+		return Color::Lerp(settings.StartColor, settings.EndColor, amount);
+	}
+
+	ParticleSystem::ParticleSystem(size_t capacity) {
+		SetCapacity(capacity);
+	}
+
+	ParticleSystem::ParticleSystem(size_t capacity, uint64_t seed) :
+		random(seed) {
+		SetCapacity(capacity);
+	}
+
+	void ParticleSystem::Seed(uint64_t seed) {
+		random.Seed(seed);
+	}
+
+	size_t ParticleSystem::Count() const {
+		return count;
+	}
+
+	size_t ParticleSystem::Capacity() const {
+		return age.size();
+	}
+
+	void ParticleSystem::SetCapacity(size_t capacity) {
+		positionX.resize(capacity);
+		positionY.resize(capacity);
+		positionZ.resize(capacity);
+		velocityX.resize(capacity);
+		velocityY.resize(capacity);
+		velocityZ.resize(capacity);
+		age.resize(capacity);
+		ageRate.resize(capacity);
+		spawnSize.resize(capacity);
+		size.resize(capacity);
+		color.resize(capacity);
+
+		count = std::min(count, capacity);
+	}
+
+	void ParticleSystem::Clear() {
+		count = 0;
+	}
+
+	size_t ParticleSystem::Emit(ParticleEmitter const& emitter, size_t amount) {
+		if (!(emitter.MinLifetime > 0) || !(emitter.MaxLifetime > 0)) {
+			return 0;
+		}
+
+		size_t first = count;
+		size_t n = std::min(amount, Capacity() - first);
+
+		if (n == 0) {
+			return 0;
+		}
+
+		double* px = positionX.data() + first;
+		double* py = positionY.data() + first;
+		double* pz = positionZ.data() + first;
+		double* vx = velocityX.data() + first;
+		double* vy = velocityY.data() + first;
+		double* vz = velocityZ.data() + first;
+		double* rates = ageRate.data() + first;
+		double* sizes = spawnSize.data() + first;
+		//Holds the speed uniforms until the sizes are drawn.
+		double* scratch = size.data() + first;
+
+		if (emitter.Radius > 0) {
+			random.InSphere(px, py, pz, n);
+		}
+		else {
+			std::fill(px, px + n, 0.0);
+			std::fill(py, py + n, 0.0);
+			std::fill(pz, pz + n, 0.0);
+		}
+
+		random.InCone(emitter.Direction, emitter.Spread, vx, vy, vz, n);
+		random.NextDoubles(scratch, n);
+		random.NextDoubles(rates, n);
+		random.NextDoubles(sizes, n);
+
+		Vector3 const& origin = emitter.Position;
+		double radius = emitter.Radius;
+		double speedRange = emitter.MaxSpeed - emitter.MinSpeed;
+		double lifetimeRange = emitter.MaxLifetime - emitter.MinLifetime;
+		double sizeRange = emitter.MaxSize - emitter.MinSize;
+
+		for (size_t i = 0; i < n; i++) {
+			px[i] = origin.X + px[i] * radius;
+			py[i] = origin.Y + py[i] * radius;
+			pz[i] = origin.Z + pz[i] * radius;
+
+			double speed = emitter.MinSpeed + speedRange * scratch[i];
+			vx[i] *= speed;
+			vy[i] *= speed;
+			vz[i] *= speed;
+
+			rates[i] = 1.0 / (emitter.MinLifetime + lifetimeRange * rates[i]);
+			sizes[i] = emitter.MinSize + sizeRange * sizes[i];
+		}
+
+		double initialSize = SizeAt(Settings.SizeCurve, 0.0);
+		Color initialColor = ColorAt(Settings, 0.0);
+
+		std::fill(age.data() + first, age.data() + first + n, 0.0);
+		std::fill(color.data() + first, color.data() + first + n, initialColor);
+
+		for (size_t i = 0; i < n; i++) {
+			scratch[i] = sizes[i] * initialSize;
+		}
+
+		count += n;
+		return n;
+	}
+
+	size_t ParticleSystem::EmitOverTime(ParticleEmitter& emitter, double elapsed) {
+		if (!(emitter.Rate > 0) || !(elapsed > 0)) {
+			return 0;
+		}
+
+		emitter.Accumulator += emitter.Rate * elapsed;
+		double whole = std::floor(emitter.Accumulator);
+		emitter.Accumulator -= whole;
+
+		return Emit(emitter, static_cast<size_t>(whole));
+	}
+
+	void ParticleSystem::Update(double elapsed) {
+		if (count == 0) {
+			return;
+		}
+
+		BakeCurves();
+
+		Parallel::For(0, count, UpdateGrain, [&](size_t first, size_t last) {
+			Integrate(first, last, elapsed);
+		});
+
+		RemoveDead();
+	}
+
+	double const* ParticleSystem::PositionX() const {
+		return positionX.data();
+	}
+
+	double const* ParticleSystem::PositionY() const {
+		return positionY.data();
+	}
+
+	double const* ParticleSystem::PositionZ() const {
+		return positionZ.data();
+	}
+
+	double const* ParticleSystem::VelocityX() const {
+		return velocityX.data();
+	}
+
+	double const* ParticleSystem::VelocityY() const {
+		return velocityY.data();
+	}
+
+	double const* ParticleSystem::VelocityZ() const {
+		return velocityZ.data();
+	}
+
+	double const* ParticleSystem::Ages() const {
+		return age.data();
+	}
+
+	double const* ParticleSystem::Sizes() const {
+		return size.data();
+	}
+
+	Color const* ParticleSystem::Colors() const {
+		return color.data();
+	}
+
+	void ParticleSystem::GetPositions(std::vector<Vector3>& destination) const {
+		destination.resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			destination[i] = Vector3(positionX[i], positionY[i], positionZ[i]);
+		}
+	}
+
+	//One extra entry so that the linear lookup of index TableSize - 1 can read its right neighbour.
+	void ParticleSystem::BakeCurves() {
+		if (Settings.SizeCurve.Keys.Count() == 0) {
+			sizeTable.assign(TableSize + 1, 1.0);
+		}
+		else {
+			Settings.SizeCurve.Sample(0.0, 1.0, TableSize + 1, sizeTable);
+		}
+
+		std::vector<double> amounts;
+
+		if (Settings.ColorCurve.Keys.Count() == 0) {
+			amounts.resize(TableSize + 1);
+
+			for (size_t i = 0; i <= TableSize; i++) {
+				amounts[i] = static_cast<double>(i) / TableSize;
+			}
+		}
+		else {
+			Settings.ColorCurve.Sample(0.0, 1.0, TableSize + 1, amounts);
+		}
+
+		colorTable.resize(TableSize + 1);
+
+		for (size_t i = 0; i <= TableSize; i++) {
+			colorTable[i] = Color::Lerp(Settings.StartColor, Settings.EndColor, amounts[i]);
+		}
+	}
+
+	//Semi-implicit Euler: the velocity is updated first and moves the particle in the same step.
+	void ParticleSystem::Integrate(size_t first, size_t last, double elapsed) {
+		double damping = std::exp(-Settings.Drag * elapsed);
+		double gx = Settings.Gravity.X * elapsed;
+		double gy = Settings.Gravity.Y * elapsed;
+		double gz = Settings.Gravity.Z * elapsed;
+
+		double* px = positionX.data();
+		double* py = positionY.data();
+		double* pz = positionZ.data();
+		double* vx = velocityX.data();
+		double* vy = velocityY.data();
+		double* vz = velocityZ.data();
+		double* ages = age.data();
+		double const* rates = ageRate.data();
+
+		size_t i = first;
+
+#ifdef XNA_PARTICLES_SSE2
+		__m128d dt = _mm_set1_pd(elapsed);
+		__m128d decay = _mm_set1_pd(damping);
+		__m128d ax = _mm_set1_pd(gx);
+		__m128d ay = _mm_set1_pd(gy);
+		__m128d az = _mm_set1_pd(gz);
+
+		for (; i + 2 <= last; i += 2) {
+			__m128d x = _mm_mul_pd(_mm_add_pd(_mm_loadu_pd(vx + i), ax), decay);
+			__m128d y = _mm_mul_pd(_mm_add_pd(_mm_loadu_pd(vy + i), ay), decay);
+			__m128d z = _mm_mul_pd(_mm_add_pd(_mm_loadu_pd(vz + i), az), decay);
+
+			_mm_storeu_pd(vx + i, x);
+			_mm_storeu_pd(vy + i, y);
+			_mm_storeu_pd(vz + i, z);
+			_mm_storeu_pd(px + i, _mm_add_pd(_mm_loadu_pd(px + i), _mm_mul_pd(x, dt)));
+			_mm_storeu_pd(py + i, _mm_add_pd(_mm_loadu_pd(py + i), _mm_mul_pd(y, dt)));
+			_mm_storeu_pd(pz + i, _mm_add_pd(_mm_loadu_pd(pz + i), _mm_mul_pd(z, dt)));
+			_mm_storeu_pd(ages + i, _mm_add_pd(_mm_loadu_pd(ages + i), _mm_mul_pd(_mm_loadu_pd(rates + i), dt)));
+		}
+#endif
+
+		for (; i < last; i++) {
+			vx[i] = (vx[i] + gx) * damping;
+			vy[i] = (vy[i] + gy) * damping;
+			vz[i] = (vz[i] + gz) * damping;
+			px[i] += vx[i] * elapsed;
+			py[i] += vy[i] * elapsed;
+			pz[i] += vz[i] * elapsed;
+			ages[i] += rates[i] * elapsed;
+		}
+
+		//Table lookups do not vectorize with SSE2, so the curves get their own scalar pass.
+		double const* sizes = spawnSize.data();
+		double const* table = sizeTable.data();
+		Color const* colors = colorTable.data();
+		double* outputSize = size.data();
+		Color* outputColor = color.data();
+
+		for (i = first; i < last; i++) {
+			double position = MathHelper::Clamp(ages[i], 0.0, 1.0) * TableSize;
+			size_t index = std::min(static_cast<size_t>(position), TableSize - 1);
+			double u = position - static_cast<double>(index);
+
+			outputSize[i] = sizes[i] * (table[index] + (table[index + 1] - table[index]) * u);
+			outputColor[i] = colors[static_cast<size_t>(position + 0.5)];
+		}
+	}
+
+	void ParticleSystem::Move(size_t from, size_t to) {
+		positionX[to] = positionX[from];
+		positionY[to] = positionY[from];
+		positionZ[to] = positionZ[from];
+		velocityX[to] = velocityX[from];
+		velocityY[to] = velocityY[from];
+		velocityZ[to] = velocityZ[from];
+		age[to] = age[from];
+		ageRate[to] = ageRate[from];
+		spawnSize[to] = spawnSize[from];
+		size[to] = size[from];
+		color[to] = color[from];
+	}
+
+	//Swap-remove: the last particle fills the slot and is checked in turn, so only dead particles cost a copy.
+	void ParticleSystem::RemoveDead() {
+		double const* ages = age.data();
+		size_t i = 0;
+
+		while (i < count) {
+#ifdef XNA_PARTICLES_SSE2
+			__m128d one = _mm_set1_pd(1.0);
+
+			while (i + 2 <= count && _mm_movemask_pd(_mm_cmpge_pd(_mm_loadu_pd(ages + i), one)) == 0) {
+				i += 2;
+			}
+
+			if (i >= count) {
+				break;
+			}
+#endif
+
+			if (ages[i] >= 1.0) {
+				count--;
+				Move(count, i);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+}
@@ -0,0 +1,119 @@
+#ifndef _PARTICLESYSTEM_H_
+#define _PARTICLESYSTEM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Color.hpp"
+#include "Curve.hpp"
+#include "Random.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	//Spawns particles inside a sphere, moving along a cone, with uniformly drawn speed, lifetime and size.
+	struct ParticleEmitter {
+		Vector3 Position;
+		double Radius{ 0 };
+		Vector3 Direction{ 0, 1, 0 };
+		//Half angle of the cone, in radians.
+		double Spread{ 0 };
+		double MinSpeed{ 1 };
+		double MaxSpeed{ 1 };
+		//In seconds, must be positive.
+		double MinLifetime{ 1 };
+		double MaxLifetime{ 1 };
+		double MinSize{ 1 };
+		double MaxSize{ 1 };
+		//Particles per second for ParticleSystem::EmitOverTime.
+		double Rate{ 0 };
+		//Fraction of a particle carried over between frames by EmitOverTime.
+		double Accumulator{ 0 };
+	};
+
+	/*
+	 Shared by every particle of a system. The curves are evaluated over the normalized age, from 0 at
+	 spawn to 1 at death: ColorCurve gives the amount from StartColor to EndColor (linear if it has no keys)
+	 and SizeCurve multiplies the spawn size (1 if it has no keys).
+	*/
+	struct ParticleSettings {
+		Vector3 Gravity;
+		//Velocity decays by exp(-Drag * elapsed), which does not depend on the frame rate.
+		double Drag{ 0 };
+		Color StartColor{ Color::White };
+		Color EndColor{ Color::White };
+		Curve ColorCurve;
+		Curve SizeCurve;
+	};
+
+	/*
+	 Particles stored as structure of arrays, one array per component, so Update streams through memory
+	 and integrates two particles per SSE2 instruction. Update splits the particles over Parallel::For,
+	 bakes the curves into tables once per call instead of evaluating them per particle, and removes dead
+	 particles by moving the last one into their slot, so the order of the particles is not stable.
+	 The arrays returned by the accessors hold Count() valid items and are invalidated by SetCapacity.
+	*/
+	class ParticleSystem {
+	public:
+		ParticleSettings Settings;
+
+		ParticleSystem(size_t capacity);
+		ParticleSystem(size_t capacity, uint64_t seed);
+
+		void Seed(uint64_t seed);
+
+		size_t Count() const;
+		size_t Capacity() const;
+		//Particles beyond the new capacity are dropped.
+		void SetCapacity(size_t capacity);
+		void Clear();
+
+		//Returns the number of particles spawned, less than amount if the system is full or 0 if a lifetime is not positive.
+		size_t Emit(ParticleEmitter const& emitter, size_t amount);
+		//Spawns emitter.Rate * elapsed particles, carrying the fraction in emitter.Accumulator.
+		size_t EmitOverTime(ParticleEmitter& emitter, double elapsed);
+
+		//Ages, accelerates and moves every particle by 'elapsed' seconds, then removes the dead ones.
+		void Update(double elapsed);
+
+		double const* PositionX() const;
+		double const* PositionY() const;
+		double const* PositionZ() const;
+		double const* VelocityX() const;
+		double const* VelocityY() const;
+		double const* VelocityZ() const;
+		//Normalized age, in [0, 1).
+		double const* Ages() const;
+		double const* Sizes() const;
+		Color const* Colors() const;
+
+		//destination is resized to Count().
+		void GetPositions(std::vector<Vector3>& destination) const;
+
+	private:
+		size_t count{ 0 };
+		std::vector<double> positionX;
+		std::vector<double> positionY;
+		std::vector<double> positionZ;
+		std::vector<double> velocityX;
+		std::vector<double> velocityY;
+		std::vector<double> velocityZ;
+		std::vector<double> age;
+		//Normalized age per second, the inverse of the lifetime.
+		std::vector<double> ageRate;
+		std::vector<double> spawnSize;
+		std::vector<double> size;
+		std::vector<Color> color;
+
+		std::vector<double> sizeTable;
+		std::vector<Color> colorTable;
+		Random random;
+
+		void BakeCurves();
+		void Integrate(size_t first, size_t last, double elapsed);
+		void Move(size_t from, size_t to);
+		void RemoveDead();
+	};
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include "AffineTransform.hpp"
+#include "Matrix.hpp"
+#include "PodTypes.hpp"
+
+namespace Xna {
+
+	void Vector3Pod::Transform(Vector3Pod const* source, size_t count, Matrix const& m, Vector3Pod* destination) {
+		for (size_t i = 0; i < count; i++) {
+			Vector3Pod position = source[i];
+
+			destination[i] = {
+				(position.X * m.M11) + (position.Y * m.M21) + (position.Z * m.M31) + m.M41,
+				(position.X * m.M12) + (position.Y * m.M22) + (position.Z * m.M32) + m.M42,
+				(position.X * m.M13) + (position.Y * m.M23) + (position.Z * m.M33) + m.M43
+			};
+		}
+	}
+
+	void Vector3Pod::Transform(Vector3Pod const* source, size_t count, Quaternion const& q, Vector3Pod* destination) {
+		for (size_t i = 0; i < count; i++) {
+			Vector3Pod position = source[i];
+
+			double x = 2 * (q.Y * position.Z - q.Z * position.Y);
+			double y = 2 * (q.Z * position.X - q.X * position.Z);
+			double z = 2 * (q.X * position.Y - q.Y * position.X);
+
+			destination[i] = {
+				position.X + x * q.W + (q.Y * z - q.Z * y),
+				position.Y + y * q.W + (q.Z * x - q.X * z),
+				position.Z + z * q.W + (q.X * y - q.Y * x)
+			};
+		}
+	}
+
+	void Vector3Pod::TransformNormal(Vector3Pod const* source, size_t count, Matrix const& m, Vector3Pod* destination) {
+		for (size_t i = 0; i < count; i++) {
+			Vector3Pod normal = source[i];
+
+			destination[i] = {
+				(normal.X * m.M11) + (normal.Y * m.M21) + (normal.Z * m.M31),
+				(normal.X * m.M12) + (normal.Y * m.M22) + (normal.Z * m.M32),
+				(normal.X * m.M13) + (normal.Y * m.M23) + (normal.Z * m.M33)
+			};
+		}
+	}
+
+	void Vector3Pod::Transform(Vector3Pod const* source, size_t count, AffineTransform const& t, Vector3Pod* destination) {
+		for (size_t i = 0; i < count; i++) {
+			Vector3Pod position = source[i];
+
+			destination[i] = {
+				(position.X * t.M11) + (position.Y * t.M21) + (position.Z * t.M31) + t.M41,
+				(position.X * t.M12) + (position.Y * t.M22) + (position.Z * t.M32) + t.M42,
+				(position.X * t.M13) + (position.Y * t.M23) + (position.Z * t.M33) + t.M43
+			};
+		}
+	}
+}
@@ -0,0 +1,196 @@
+#ifndef _PODTYPES_H_
+#define _PODTYPES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Point.hpp"
+#include "Quaternion.hpp"
+#include "Rectangle.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+
+namespace Xna {
+
+	class AffineTransform;
+	class Matrix;
+
+	/*
+	 Trivial counterparts of the math types, with the same members in the same layout. The math types zero
+	 their members in their default constructors, so std::vector<Vector3>(n) writes every element before it
+	 is used; these are left uninitialized, so large buffers (in an UninitializedVector, from
+	 MakeUninitialized or over a MappedFile) cost nothing until written. Both sides are trivially copyable and
+	 standard layout, so whole arrays convert with CopyAs.
+	*/
+	struct Vector2Pod {
+		double X;
+		double Y;
+
+		static Vector2Pod From(Vector2 const& v) { return { v.X, v.Y }; }
+		operator Vector2() const { return Vector2(X, Y); }
+	};
+
+	struct Vector3Pod {
+		double X;
+		double Y;
+		double Z;
+
+		static Vector3Pod From(Vector3 const& v) { return { v.X, v.Y, v.Z }; }
+		operator Vector3() const { return Vector3(X, Y, Z); }
+
+		//Batch Transform and TransformNormal of Vector3 over raw arrays. source and destination may be the same.
+		static void Transform(Vector3Pod const* source, size_t count, Matrix const& m, Vector3Pod* destination);
+		static void Transform(Vector3Pod const* source, size_t count, Quaternion const& q, Vector3Pod* destination);
+		static void TransformNormal(Vector3Pod const* source, size_t count, Matrix const& m, Vector3Pod* destination);
+		static void Transform(Vector3Pod const* source, size_t count, AffineTransform const& t, Vector3Pod* destination);
+	};
+
+	struct Vector4Pod {
+		double X;
+		double Y;
+		double Z;
+		double W;
+
+		static Vector4Pod From(Vector4 const& v) { return { v.X, v.Y, v.Z, v.W }; }
+		operator Vector4() const { return Vector4(X, Y, Z, W); }
+	};
+
+	struct QuaternionPod {
+		double X;
+		double Y;
+		double Z;
+		double W;
+
+		static QuaternionPod From(Quaternion const& q) { return { q.X, q.Y, q.Z, q.W }; }
+		operator Quaternion() const { return Quaternion(X, Y, Z, W); }
+	};
+
+	struct PointPod {
+		int32_t X;
+		int32_t Y;
+
+		static PointPod From(Point const& p) { return { p.X, p.Y }; }
+		operator Point() const { return Point(X, Y); }
+	};
+
+	struct RectanglePod {
+		int32_t X;
+		int32_t Y;
+		int32_t Width;
+		int32_t Height;
+
+		static RectanglePod From(Rectangle const& r) { return { r.X, r.Y, r.Width, r.Height }; }
+		operator Rectangle() const { return Rectangle(X, Y, Width, Height); }
+	};
+
+	static_assert(std::is_trivial<Vector2Pod>::value && std::is_standard_layout<Vector2Pod>::value, "Vector2Pod must be a POD.");
+	static_assert(std::is_trivial<Vector3Pod>::value && std::is_standard_layout<Vector3Pod>::value, "Vector3Pod must be a POD.");
+	static_assert(std::is_trivial<Vector4Pod>::value && std::is_standard_layout<Vector4Pod>::value, "Vector4Pod must be a POD.");
+	static_assert(std::is_trivial<QuaternionPod>::value && std::is_standard_layout<QuaternionPod>::value, "QuaternionPod must be a POD.");
+	static_assert(std::is_trivial<PointPod>::value && std::is_standard_layout<PointPod>::value, "PointPod must be a POD.");
+	static_assert(std::is_trivial<RectanglePod>::value && std::is_standard_layout<RectanglePod>::value, "RectanglePod must be a POD.");
+
+	//The math types themselves must stay copyable as bytes, with the layout of their counterparts.
+	template <typename Pod, typename T>
+	struct LayoutMatches : std::integral_constant<bool,
+		std::is_trivially_copyable<T>::value && std::is_standard_layout<T>::value
+		&& sizeof(Pod) == sizeof(T) && alignof(Pod) == alignof(T)> {
+	};
+
+	static_assert(LayoutMatches<Vector2Pod, Vector2>::value && offsetof(Vector2Pod, Y) == offsetof(Vector2, Y), "Vector2 layout changed.");
+	static_assert(LayoutMatches<Vector3Pod, Vector3>::value && offsetof(Vector3Pod, Z) == offsetof(Vector3, Z), "Vector3 layout changed.");
+	static_assert(LayoutMatches<Vector4Pod, Vector4>::value && offsetof(Vector4Pod, W) == offsetof(Vector4, W), "Vector4 layout changed.");
+	static_assert(LayoutMatches<QuaternionPod, Quaternion>::value && offsetof(QuaternionPod, W) == offsetof(Quaternion, W), "Quaternion layout changed.");
+	static_assert(LayoutMatches<PointPod, Point>::value && offsetof(PointPod, Y) == offsetof(Point, Y), "Point layout changed.");
+	static_assert(LayoutMatches<RectanglePod, Rectangle>::value && offsetof(RectanglePod, Height) == offsetof(Rectangle, Height), "Rectangle layout changed.");
+
+	/*
+	 Allocator whose value-initializing construct (the one resize and the count constructor use) default
+	 initializes instead, which leaves trivial types untouched. Other constructs are forwarded as usual.
+	*/
+	template <typename T>
+	class UninitializedAllocator : public std::allocator<T> {
+	public:
+		template <typename U>
+		struct rebind {
+			using other = UninitializedAllocator<U>;
+		};
+
+		UninitializedAllocator() noexcept {}
+
+		template <typename U>
+		UninitializedAllocator(UninitializedAllocator<U> const&) noexcept {}
+
+		template <typename U>
+		void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+			::new (static_cast<void*>(p)) U;
+		}
+
+		template <typename U, typename... Args>
+		void construct(U* p, Args&&... args) {
+			::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+		}
+
+		template <typename U>
+		void destroy(U* p) {
+			p->~U();
+		}
+	};
+
+	template <typename T, typename U>
+	bool operator== (UninitializedAllocator<T> const&, UninitializedAllocator<U> const&) {
+		return true;
+	}
+
+	template <typename T, typename U>
+	bool operator!= (UninitializedAllocator<T> const&, UninitializedAllocator<U> const&) {
+		return false;
+	}
+
+	//vector whose resize leaves new elements of a trivial T uninitialized.
+	template <typename T>
+	using UninitializedVector = std::vector<T, UninitializedAllocator<T>>;
+
+	//count uninitialized elements, or null if count is 0.
+	template <typename T>
+	std::unique_ptr<T[]> MakeUninitialized(size_t count) {
+		static_assert(std::is_trivial<T>::value, "Only trivial types can be left uninitialized.");
+		return std::unique_ptr<T[]>(count == 0 ? nullptr : new T[count]);
+	}
+
+	//Copies count items between arrays of types with the same layout, such as Vector3 and Vector3Pod.
+	template <typename To, typename From>
+	void CopyAs(From const* source, size_t count, To* destination) {
+		static_assert(std::is_trivially_copyable<From>::value && std::is_trivially_copyable<To>::value, "Items are copied as bytes.");
+		static_assert(sizeof(From) == sizeof(To), "Items must have the same size.");
+
+		if (count != 0) {
+			std::memcpy(static_cast<void*>(destination), static_cast<void const*>(source), count * sizeof(To));
+		}
+	}
+
+	/*
+	 Items of type T over raw bytes, such as MappedFile::Data(): the number of whole items goes to count.
+	 Returns null if data is not aligned for T.
+	*/
+	template <typename T>
+	T const* ViewAs(void const* data, size_t bytes, size_t& count) {
+		static_assert(std::is_trivial<T>::value && std::is_standard_layout<T>::value, "Only PODs can be viewed over bytes.");
+
+		if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0) {
+			count = 0;
+			return nullptr;
+		}
+
+		count = bytes / sizeof(T);
+		return static_cast<T const*>(data);
+	}
+}
+
+#endif
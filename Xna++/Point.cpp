@@ -56,8 +56,8 @@ namespace Xna {
 		return Vector2(X, Y);
 	}	
 
-	Point Point::operator-(Point p) {
-		return Point::Negate(p);
+	Point Point::operator- () const {
+		return Point::Negate(*this);
 	}
 
 	Point operator+ (Point p1, Point p2) {
@@ -2,6 +2,8 @@
 #define _POINT_H_
 
 #include <cstdint>
+#include <functional>
+#include "Hash.hpp"
 
 namespace Xna {
 
@@ -19,7 +21,7 @@ namespace Xna {
 
 		static const Point Zero;
 
-		Point operator- (Point);
+		Point operator- () const;
 		friend Point operator+ (Point, Point);
 		friend Point operator- (Point, Point);
 		friend Point operator* (Point, Point);
@@ -45,4 +47,13 @@ namespace Xna {
 	};
 }
 
+namespace std {
+	template <>
+	struct hash<Xna::Point> {
+		size_t operator()(Xna::Point const& p) const noexcept {
+			return static_cast<size_t>(Xna::Hash::Mix(Xna::Hash::OfInt32Pair(p.X, p.Y)));
+		}
+	};
+}
+
 #endif
\ No newline at end of file
@@ -3,8 +3,20 @@
 #include "Vector4.hpp"
 #include "Vector3.hpp"
 #include "Matrix.hpp"
+#include "FastMath.hpp"
 
 namespace Xna {
+
+	//Table based under XNA_FAST_TRIG, see FastMath.hpp.
+	static void SinCos(double angle, double& s, double& c) {
+#ifdef XNA_FAST_TRIG
+		FastMath::SinCos(angle, s, c);
+#else
+		s = sin(angle);
+		c = cos(angle);
+#endif
+	}
+
 	Quaternion::Quaternion() {}
 	Quaternion::Quaternion(Vector4 value) :
 		X(value.X), Y(value.Y), Z(value.Z), W(value.W) {}
@@ -105,8 +117,8 @@ namespace Xna {
 
 	Quaternion Quaternion::CreateFromAxisAngle(Vector3 const& axis, double angle) {
 		double half = angle * 0.5f;
-		double _sin = sin(half);
-		double _cos = cos(half);
+		double _sin, _cos;
+		SinCos(half, _sin, _cos);
 		return Quaternion(axis.X * _sin, axis.Y * _sin, axis.Z * _sin, _cos);
 	}
 
@@ -168,12 +180,10 @@ namespace Xna {
 		double halfPitch = pitch * 0.5;
 		double halfYaw = yaw * 0.5;
 
-		double sinRoll = sin(halfRoll);
-		double cosRoll = cos(halfRoll);
-		double sinPitch = sin(halfPitch);
-		double cosPitch = cos(halfPitch);
-		double sinYaw = sin(halfYaw);
-		double cosYaw = cos(halfYaw);
+		double sinRoll, cosRoll, sinPitch, cosPitch, sinYaw, cosYaw;
+		SinCos(halfRoll, sinRoll, cosRoll);
+		SinCos(halfPitch, sinPitch, cosPitch);
+		SinCos(halfYaw, sinYaw, cosYaw);
 
 		return Quaternion(
 			(cosYaw * sinPitch * cosRoll) + (sinYaw * cosPitch * sinRoll),
@@ -309,8 +319,8 @@ namespace Xna {
 		w = W;
 	}
 
-	Quaternion Quaternion::operator- (Quaternion v) {
-		return Quaternion::Negate(v);
+	Quaternion Quaternion::operator- () const {
+		return Quaternion::Negate(*this);
 	}
 
 	Quaternion operator+ (Quaternion v1, Quaternion v2) {
@@ -22,7 +22,7 @@ namespace Xna {
 
 		static const Quaternion Identity;
 
-		Quaternion operator- (Quaternion);
+		Quaternion operator- () const;
 		friend Quaternion operator+ (Quaternion, Quaternion);
 		friend Quaternion operator- (Quaternion, Quaternion);
 		friend Quaternion operator* (Quaternion, Quaternion);
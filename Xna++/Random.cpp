@@ -0,0 +1,440 @@
+#include <algorithm>
+#include <cmath>
+#include "Random.hpp"
+#include "FastMath.hpp"
+#include "Hash.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XNA_RANDOM_SSE2
+#endif
+
+namespace Xna {
+
+	static constexpr double UnitScale = 1.0 / 2147483648.0;
+	static constexpr size_t ChunkSize = 64;
+
+	static bool InRange(size_t size, size_t destIndex, size_t count) {
+		return destIndex <= size && size - destIndex >= count;
+	}
+
+	Random::Random() {
+		Seed(0);
+	}
+
+	Random::Random(uint64_t seed) {
+		Seed(seed);
+	}
+
+	void Random::Seed(uint64_t seed) {
+		for (size_t word = 0; word < 4; word++) {
+			for (size_t lane = 0; lane < Lanes; lane += 2) {
+				seed += 0x9E3779B97F4A7C15ull;
+				uint64_t value = Hash::Mix(seed);
+
+				state[word][lane] = static_cast<uint32_t>(value);
+				state[word][lane + 1] = static_cast<uint32_t>(value >> 32);
+			}
+		}
+
+		bufferPosition = Lanes;
+	}
+
+#ifdef XNA_RANDOM_SSE2
+	static void Advance(__m128i& s0, __m128i& s1, __m128i& s2, __m128i& s3) {
+		__m128i t = _mm_slli_epi32(s1, 9);
+
+		s2 = _mm_xor_si128(s2, s0);
+		s3 = _mm_xor_si128(s3, s1);
+		s1 = _mm_xor_si128(s1, s2);
+		s0 = _mm_xor_si128(s0, s3);
+		s2 = _mm_xor_si128(s2, t);
+		s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+	}
+
+	void Random::Steps(uint32_t* output, size_t steps) {
+		__m128i a0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[0]));
+		__m128i a1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[1]));
+		__m128i a2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[2]));
+		__m128i a3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[3]));
+		__m128i b0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[0] + 4));
+		__m128i b1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[1] + 4));
+		__m128i b2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[2] + 4));
+		__m128i b3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state[3] + 4));
+
+		for (size_t i = 0; i < steps; i++) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * Lanes), _mm_add_epi32(a0, a3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * Lanes + 4), _mm_add_epi32(b0, b3));
+
+			Advance(a0, a1, a2, a3);
+			Advance(b0, b1, b2, b3);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[0]), a0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[1]), a1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[2]), a2);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[3]), a3);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[0] + 4), b0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[1] + 4), b1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[2] + 4), b2);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state[3] + 4), b3);
+	}
+#else
+	void Random::Steps(uint32_t* output, size_t steps) {
+		for (size_t i = 0; i < steps; i++) {
+			for (size_t lane = 0; lane < Lanes; lane++) {
+				uint32_t s0 = state[0][lane];
+				uint32_t s1 = state[1][lane];
+				uint32_t s2 = state[2][lane];
+				uint32_t s3 = state[3][lane];
+				uint32_t t = s1 << 9;
+
+				output[i * Lanes + lane] = s0 + s3;
+
+				s2 ^= s0;
+				s3 ^= s1;
+				s1 ^= s2;
+				s0 ^= s3;
+				s2 ^= t;
+				s3 = (s3 << 11) | (s3 >> 21);
+
+				state[0][lane] = s0;
+				state[1][lane] = s1;
+				state[2][lane] = s2;
+				state[3][lane] = s3;
+			}
+		}
+	}
+#endif
+
+	uint32_t Random::NextUInt32() {
+		if (bufferPosition == Lanes) {
+			Steps(buffer, 1);
+			bufferPosition = 0;
+		}
+
+		return buffer[bufferPosition++];
+	}
+
+	double Random::NextDouble() {
+		return (NextUInt32() >> 1) * UnitScale;
+	}
+
+	double Random::NextDouble(double min, double max) {
+		return min + (max - min) * NextDouble();
+	}
+
+	int32_t Random::Next(int32_t min, int32_t max) {
+		if (max <= min) {
+			return min;
+		}
+
+		uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min);
+		return static_cast<int32_t>(min + static_cast<int64_t>((NextUInt32() * range) >> 32));
+	}
+
+	//Same sequence as repeated NextUInt32 calls; whole steps are written straight to the destination.
+	void Random::NextUInt32s(uint32_t* destination, size_t count) {
+		while (count > 0 && bufferPosition < Lanes) {
+			*destination++ = buffer[bufferPosition++];
+			count--;
+		}
+
+		size_t steps = count / Lanes;
+		Steps(destination, steps);
+		destination += steps * Lanes;
+		count -= steps * Lanes;
+
+		for (size_t i = 0; i < count; i++) {
+			destination[i] = NextUInt32();
+		}
+	}
+
+	void Random::NextDoubles(double* destination, size_t count) {
+		uint32_t values[256];
+
+		while (count > 0) {
+			size_t chunk = std::min<size_t>(count, 256);
+			size_t i = 0;
+
+			NextUInt32s(values, chunk);
+
+#ifdef XNA_RANDOM_SSE2
+			__m128d scale = _mm_set1_pd(UnitScale);
+
+			for (; i + 4 <= chunk; i += 4) {
+				__m128i bits = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(values + i)), 1);
+				_mm_storeu_pd(destination + i, _mm_mul_pd(_mm_cvtepi32_pd(bits), scale));
+				_mm_storeu_pd(destination + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(bits, 0x0E)), scale));
+			}
+#endif
+
+			for (; i < chunk; i++) {
+				destination[i] = (values[i] >> 1) * UnitScale;
+			}
+
+			destination += chunk;
+			count -= chunk;
+		}
+	}
+
+	//Calls sample(index, uniforms) for every item, with 'Uniforms' values in [0, 1) each.
+	template <size_t Uniforms, typename TSample>
+	void Random::Generate(size_t count, TSample sample) {
+		double uniforms[ChunkSize * Uniforms];
+
+		for (size_t first = 0; first < count; first += ChunkSize) {
+			size_t chunk = std::min(ChunkSize, count - first);
+			NextDoubles(uniforms, chunk * Uniforms);
+
+			for (size_t i = 0; i < chunk; i++) {
+				sample(first + i, uniforms + i * Uniforms);
+			}
+		}
+	}
+
+	static void SampleCircle(double const* u, double& x, double& y) {
+		FastMath::SinCos(MathHelper::TWO_PI * u[0], y, x);
+	}
+
+	static void SampleDisk(double const* u, double& x, double& y) {
+		double r = std::sqrt(u[0]);
+		FastMath::SinCos(MathHelper::TWO_PI * u[1], y, x);
+		x *= r;
+		y *= r;
+	}
+
+	//Archimedes: z is uniform on [-1, 1] for points uniform on the sphere.
+	static void SampleSphere(double const* u, double& x, double& y, double& z) {
+		z = 1.0 - 2.0 * u[0];
+		double r = std::sqrt(std::max(0.0, 1.0 - z * z));
+		FastMath::SinCos(MathHelper::TWO_PI * u[1], y, x);
+		x *= r;
+		y *= r;
+	}
+
+	static void SampleBall(double const* u, double& x, double& y, double& z) {
+		SampleSphere(u, x, y, z);
+		double r = std::cbrt(u[2]);
+		x *= r;
+		y *= r;
+		z *= r;
+	}
+
+	//Shoemake's uniform rotations.
+	static void SampleRotation(double const* u, double& x, double& y, double& z, double& w) {
+		double a = std::sqrt(1.0 - u[0]);
+		double b = std::sqrt(u[0]);
+		FastMath::SinCos(MathHelper::TWO_PI * u[1], x, y);
+		FastMath::SinCos(MathHelper::TWO_PI * u[2], z, w);
+		x *= a;
+		y *= a;
+		z *= b;
+		w *= b;
+	}
+
+	//Orthonormal frame around the cone axis; the cone is uniform in solid angle.
+	class ConeSampler {
+	public:
+		ConeSampler(Vector3 const& direction, double angle) {
+			double length = std::sqrt(direction.X * direction.X + direction.Y * direction.Y + direction.Z * direction.Z);
+
+			if (length > 0) {
+				axis[0] = direction.X / length;
+				axis[1] = direction.Y / length;
+				axis[2] = direction.Z / length;
+			}
+
+			//Any vector not parallel to the axis gives the first tangent.
+			double helper[3] = { 0, 0, 0 };
+			helper[std::fabs(axis[0]) < 0.5 ? 0 : (std::fabs(axis[1]) < 0.5 ? 1 : 2)] = 1;
+
+			tangent[0] = helper[1] * axis[2] - helper[2] * axis[1];
+			tangent[1] = helper[2] * axis[0] - helper[0] * axis[2];
+			tangent[2] = helper[0] * axis[1] - helper[1] * axis[0];
+			double tangentLength = std::sqrt(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]);
+			tangent[0] /= tangentLength;
+			tangent[1] /= tangentLength;
+			tangent[2] /= tangentLength;
+
+			bitangent[0] = axis[1] * tangent[2] - axis[2] * tangent[1];
+			bitangent[1] = axis[2] * tangent[0] - axis[0] * tangent[2];
+			bitangent[2] = axis[0] * tangent[1] - axis[1] * tangent[0];
+
+			oneMinusCos = 1.0 - std::cos(MathHelper::Clamp(angle, 0.0, MathHelper::PI));
+		}
+
+		void Sample(double const* u, double& x, double& y, double& z) const {
+			double h = 1.0 - u[0] * oneMinusCos;
+			double r = std::sqrt(std::max(0.0, 1.0 - h * h));
+			double s, c;
+			FastMath::SinCos(MathHelper::TWO_PI * u[1], s, c);
+			s *= r;
+			c *= r;
+
+			x = tangent[0] * c + bitangent[0] * s + axis[0] * h;
+			y = tangent[1] * c + bitangent[1] * s + axis[1] * h;
+			z = tangent[2] * c + bitangent[2] * s + axis[2] * h;
+		}
+
+	private:
+		double axis[3] = { 0, 0, 1 };
+		double tangent[3];
+		double bitangent[3];
+		double oneMinusCos;
+	};
+
+	bool Random::InRectangle(Rectangle const& rectangle, std::vector<Vector2>& destination, size_t destIndex, size_t count) {
+		if (!InRange(destination.size(), destIndex, count)) {
+			return false;
+		}
+
+		Vector2* output = destination.data() + destIndex;
+		double left = rectangle.X;
+		double top = rectangle.Y;
+		double width = rectangle.Width;
+		double height = rectangle.Height;
+
+		Generate<2>(count, [&](size_t i, double const* u) {
+			output[i].X = left + width * u[0];
+			output[i].Y = top + height * u[1];
+		});
+
+		return true;
+	}
+
+	void Random::InRectangle(Rectangle const& rectangle, double* x, double* y, size_t count) {
+		double left = rectangle.X;
+		double top = rectangle.Y;
+		double width = rectangle.Width;
+		double height = rectangle.Height;
+
+		Generate<2>(count, [&](size_t i, double const* u) {
+			x[i] = left + width * u[0];
+			y[i] = top + height * u[1];
+		});
+	}
+
+	bool Random::OnCircle(std::vector<Vector2>& destination, size_t destIndex, size_t count) {
+		if (!InRange(destination.size(), destIndex, count)) {
+			return false;
+		}
+
+		Vector2* output = destination.data() + destIndex;
+
+		Generate<1>(count, [&](size_t i, double const* u) {
+			SampleCircle(u, output[i].X, output[i].Y);
+		});
+
+		return true;
+	}
+
+	void Random::OnCircle(double* x, double* y, size_t count) {
+		Generate<1>(count, [&](size_t i, double const* u) {
+			SampleCircle(u, x[i], y[i]);
+		});
+	}
+
+	bool Random::InCircle(std::vector<Vector2>& destination, size_t destIndex, size_t count) {
+		if (!InRange(destination.size(), destIndex, count)) {
+			return false;
+		}
+
+		Vector2* output = destination.data() + destIndex;
+
+		Generate<2>(count, [&](size_t i, double const* u) {
+			SampleDisk(u, output[i].X, output[i].Y);
+		});
+
+		return true;
+	}
+
+	void Random::InCircle(double* x, double* y, size_t count) {
+		Generate<2>(count, [&](size_t i, double const* u) {
+			SampleDisk(u, x[i], y[i]);
+		});
+	}
+
+	bool Random::OnSphere(std::vector<Vector3>& destination, size_t destIndex, size_t count) {
+		if (!InRange(destination.size(), destIndex, count)) {
+			return false;
+		}
+
+		Vector3* output = destination.data() + destIndex;
+
+		Generate<2>(count, [&](size_t i, double const* u) {
+			SampleSphere(u, output[i].X, output[i].Y, output[i].Z);
+		});
+
+		return true;
+	}
+
+	void Random::OnSphere(double* x, double* y, double* z, size_t count) {
+		Generate<2>(count, [&](size_t i, double const* u) {
+			SampleSphere(u, x[i], y[i], z[i]);
+		});
+	}
+
+	bool Random::InSphere(std::vector<Vector3>& destination, size_t destIndex, size_t count) {
+		if (!InRange(destination.size(), destIndex, count)) {
+			return false;
+		}
+
+		Vector3* output = destination.data() + destIndex;
+
+		Generate<3>(count, [&](size_t i, double const* u) {
+			SampleBall(u, output[i].X, output[i].Y, output[i].Z);
+		});
+
+		return true;
+	}
+
+	void Random::InSphere(double* x, double* y, double* z, size_t count) {
+		Generate<3>(count, [&](size_t i, double const* u) {
+			SampleBall(u, x[i], y[i], z[i]);
+		});
+	}
+
+	bool Random::InCone(Vector3 const& direction, double angle, std::vector<Vector3>& destination, size_t destIndex, size_t count) {
+		if (!InRange(destination.size(), destIndex, count)) {
+			return false;
+		}
+
+		Vector3* output = destination.data() + destIndex;
+		ConeSampler cone(direction, angle);
+
+		Generate<2>(count, [&](size_t i, double const* u) {
+			cone.Sample(u, output[i].X, output[i].Y, output[i].Z);
+		});
+
+		return true;
+	}
+
+	void Random::InCone(Vector3 const& direction, double angle, double* x, double* y, double* z, size_t count) {
+		ConeSampler cone(direction, angle);
+
+		Generate<2>(count, [&](size_t i, double const* u) {
+			cone.Sample(u, x[i], y[i], z[i]);
+		});
+	}
+
+	bool Random::UnitQuaternions(std::vector<Quaternion>& destination, size_t destIndex, size_t count) {
+		if (!InRange(destination.size(), destIndex, count)) {
+			return false;
+		}
+
+		Quaternion* output = destination.data() + destIndex;
+
+		Generate<3>(count, [&](size_t i, double const* u) {
+			SampleRotation(u, output[i].X, output[i].Y, output[i].Z, output[i].W);
+		});
+
+		return true;
+	}
+
+	void Random::UnitQuaternions(double* x, double* y, double* z, double* w, size_t count) {
+		Generate<3>(count, [&](size_t i, double const* u) {
+			SampleRotation(u, x[i], y[i], z[i], w[i]);
+		});
+	}
+}
@@ -0,0 +1,82 @@
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Quaternion.hpp"
+#include "Rectangle.hpp"
+
+namespace Xna {
+
+	/*
+	 xoshiro128+ run on 8 independent lanes (two SSE2 registers, scalar elsewhere with the same output),
+	 seeded through splitmix64, so a seed gives the same sequence on every platform.
+	 The bulk generators draw their uniforms a block at a time and avoid rejection sampling and libm
+	 trigonometry (angles go through FastMath). They write into std::vector (returning false if
+	 destIndex + count is out of range, like the batch Transform methods) or into SoA arrays.
+	 Not thread safe: use one instance per thread.
+	*/
+	class Random {
+	public:
+		static constexpr size_t Lanes = 8;
+
+		Random();
+		Random(uint64_t seed);
+
+		void Seed(uint64_t seed);
+
+		uint32_t NextUInt32();
+		//Uniform in [0, 1), with 31 bits of randomness.
+		double NextDouble();
+		double NextDouble(double min, double max);
+		//Uniform in [min, max), or min if max <= min.
+		int32_t Next(int32_t min, int32_t max);
+
+		void NextUInt32s(uint32_t* destination, size_t count);
+		void NextDoubles(double* destination, size_t count);
+
+		//Uniform points inside the rectangle, in [X, X + Width) x [Y, Y + Height).
+		bool InRectangle(Rectangle const& rectangle, std::vector<Vector2>& destination, size_t destIndex, size_t count);
+		void InRectangle(Rectangle const& rectangle, double* x, double* y, size_t count);
+
+		//Uniform points on the unit circle.
+		bool OnCircle(std::vector<Vector2>& destination, size_t destIndex, size_t count);
+		void OnCircle(double* x, double* y, size_t count);
+
+		//Uniform points inside the unit circle.
+		bool InCircle(std::vector<Vector2>& destination, size_t destIndex, size_t count);
+		void InCircle(double* x, double* y, size_t count);
+
+		//Uniform points on the unit sphere, i.e. random directions.
+		bool OnSphere(std::vector<Vector3>& destination, size_t destIndex, size_t count);
+		void OnSphere(double* x, double* y, double* z, size_t count);
+
+		//Uniform points inside the unit sphere.
+		bool InSphere(std::vector<Vector3>& destination, size_t destIndex, size_t count);
+		void InSphere(double* x, double* y, double* z, size_t count);
+
+		//Unit vectors uniformly spread over the cone of half angle 'angle' (radians) around 'direction'.
+		bool InCone(Vector3 const& direction, double angle, std::vector<Vector3>& destination, size_t destIndex, size_t count);
+		void InCone(Vector3 const& direction, double angle, double* x, double* y, double* z, size_t count);
+
+		//Uniformly distributed rotations.
+		bool UnitQuaternions(std::vector<Quaternion>& destination, size_t destIndex, size_t count);
+		void UnitQuaternions(double* x, double* y, double* z, double* w, size_t count);
+
+	private:
+		uint32_t state[4][Lanes];
+		uint32_t buffer[Lanes];
+		size_t bufferPosition{ Lanes };
+
+		//Advances every lane 'steps' times, writing Lanes values per step.
+		void Steps(uint32_t* output, size_t steps);
+
+		template <size_t Uniforms, typename TSample>
+		void Generate(size_t count, TSample sample);
+	};
+}
+
+#endif
@@ -1,9 +1,52 @@
 #include <algorithm>
+#include <limits>
 #include "Rectangle.hpp"
 #include "Point.hpp"
 #include "Vector2.hpp"
+#include "Simd.hpp"
 
 namespace Xna {
+
+	/*
+	 Times, as fractions of the velocity, at which the moving edges [low, high] enter and leave the slab
+	 [otherLow, otherHigh] of one axis. Without motion on the axis the slab is either always or never entered.
+	*/
+	template <typename T>
+	static void SweepAxis(double low, double high, double velocity, T otherLow, T otherHigh, T& entry, T& exit) {
+		double infinity = std::numeric_limits<double>::infinity();
+
+		if (velocity > 0) {
+			T inverse = T::Set(1.0 / velocity);
+			entry = (otherLow - T::Set(high)) * inverse;
+			exit = (otherHigh - T::Set(low)) * inverse;
+		}
+		else if (velocity < 0) {
+			T inverse = T::Set(1.0 / velocity);
+			entry = (otherHigh - T::Set(low)) * inverse;
+			exit = (otherLow - T::Set(high)) * inverse;
+		}
+		else {
+			typename T::Mask overlap = (otherLow < T::Set(high)) & (T::Set(low) < otherHigh);
+			entry = T::Select(overlap, T::Set(-infinity), T::Set(infinity));
+			exit = T::Set(infinity);
+		}
+	}
+
+	//Time of impact of 'moving' against T::Width rectangles, or +infinity where they are missed.
+	template <typename T>
+	static T SweepTime(Rectangle const& moving, Vector2 const& velocity, T left, T top, T right, T bottom, T& entryX, T& entryY) {
+		T exitX, exitY;
+		SweepAxis(moving.Left(), moving.Right(), velocity.X, left, right, entryX, exitX);
+		SweepAxis(moving.Top(), moving.Bottom(), velocity.Y, top, bottom, entryY, exitY);
+
+		T entry = T::Max(entryX, entryY);
+		T exit = T::Min(exitX, exitY);
+		T zero = T::Set(0.0);
+		typename T::Mask hit = (entry < exit) & (exit > zero) & (entry <= T::Set(1.0));
+
+		return T::Select(hit, T::Max(entry, zero), T::Set(std::numeric_limits<double>::infinity()));
+	}
+
 	Rectangle::Rectangle() {}
 	Rectangle::Rectangle(int32_t x, int32_t y, int32_t width, int32_t height) :
 		X(x), Y(y), Width(width), Height(height) {}
@@ -163,4 +206,96 @@ namespace Xna {
 	bool operator!= (Rectangle r1, Rectangle r2) {
 		return !r1.Equals(r2);
 	}
-}
\ No newline at end of file
+
+	bool Rectangle::Sweep(Vector2 const& velocity, Rectangle other, double& time, Vector2& normal) const {
+		Simd::Scalar entryX, entryY;
+		Simd::Scalar t = SweepTime(*this, velocity,
+			Simd::Scalar::Set(other.Left()), Simd::Scalar::Set(other.Top()),
+			Simd::Scalar::Set(other.Right()), Simd::Scalar::Set(other.Bottom()), entryX, entryY);
+
+		if (!(t.Value <= 1.0)) {
+			return false;
+		}
+
+		time = t.Value;
+
+		if (entryX.Value < 0 && entryY.Value < 0) {
+			normal = Vector2();
+		}
+		else if (entryX.Value >= entryY.Value) {
+			normal = Vector2(velocity.X > 0 ? -1.0 : 1.0, 0.0);
+		}
+		else {
+			normal = Vector2(0.0, velocity.Y > 0 ? -1.0 : 1.0);
+		}
+
+		return true;
+	}
+
+	bool Rectangle::Sweep(Vector2 const& velocity, std::vector<Rectangle> const& others, size_t index, size_t length,
+		double& time, Vector2& normal, size_t& hit) const {
+
+		if (index > others.size() || length > others.size() - index) {
+			return false;
+		}
+
+		double bestTime = std::numeric_limits<double>::infinity();
+		size_t best = 0;
+		size_t i = index;
+		size_t last = index + length;
+
+#ifdef XNA_SIMD_SSE2
+		Simd::Pair pairBest = Simd::Pair::Set(bestTime);
+		Simd::Pair pairIndex = Simd::Pair::Set(0.0);
+
+		for (; i + 2 <= last; i += 2) {
+			Rectangle const& r0 = others[i];
+			Rectangle const& r1 = others[i + 1];
+			double left[2] = { static_cast<double>(r0.Left()), static_cast<double>(r1.Left()) };
+			double top[2] = { static_cast<double>(r0.Top()), static_cast<double>(r1.Top()) };
+			double right[2] = { static_cast<double>(r0.Right()), static_cast<double>(r1.Right()) };
+			double bottom[2] = { static_cast<double>(r0.Bottom()), static_cast<double>(r1.Bottom()) };
+			double lanes[2] = { static_cast<double>(i), static_cast<double>(i + 1) };
+
+			Simd::Pair entryX, entryY;
+			Simd::Pair t = SweepTime(*this, velocity, Simd::Pair::Load(left), Simd::Pair::Load(top),
+				Simd::Pair::Load(right), Simd::Pair::Load(bottom), entryX, entryY);
+
+			Simd::PairMask earlier = t < pairBest;
+			pairBest = Simd::Pair::Select(earlier, t, pairBest);
+			pairIndex = Simd::Pair::Select(earlier, Simd::Pair::Load(lanes), pairIndex);
+		}
+
+		double times[2];
+		double indices[2];
+		pairBest.Store(times);
+		pairIndex.Store(indices);
+
+		for (size_t l = 0; l < 2; l++) {
+			size_t candidate = static_cast<size_t>(indices[l]);
+
+			if (times[l] < bestTime || (times[l] == bestTime && times[l] <= 1.0 && candidate < best)) {
+				bestTime = times[l];
+				best = candidate;
+			}
+		}
+#endif
+
+		for (; i < last; i++) {
+			double t;
+			Vector2 n;
+
+			if (Sweep(velocity, others[i], t, n) && t < bestTime) {
+				bestTime = t;
+				best = i;
+			}
+		}
+
+		if (!(bestTime <= 1.0)) {
+			return false;
+		}
+
+		hit = best;
+		return Sweep(velocity, others[best], time, normal);
+	}
+}
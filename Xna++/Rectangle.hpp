@@ -1,7 +1,11 @@
 #ifndef _RECTANGLE_H_
 #define _RECTANGLE_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <vector>
+#include "Hash.hpp"
 
 namespace Xna {
 
@@ -50,6 +54,31 @@ namespace Xna {
 		void Offset(Point p);
 		void Offset(Vector2 v);
 		void Deconstruct(int32_t& x, int32_t& y, int32_t& width, int32_t& height) const;
+
+		/*
+		 Swept test of this rectangle moving by 'velocity' against a static one. On a hit, time is the fraction
+		 of velocity travelled when the edges meet, in [0, 1], and normal is the unit normal of the face of
+		 'other' that was hit. Rectangles that already overlap hit at time 0 with a zero normal;
+		 edges that only slide along each other do not hit.
+		*/
+		bool Sweep(Vector2 const& velocity, Rectangle other, double& time, Vector2& normal) const;
+		/*
+		 Earliest hit among others[index] to others[index + length - 1], two candidates per SSE2 instruction,
+		 with 'hit' set to its index. Returns false if nothing is hit or the range is out of bounds.
+		*/
+		bool Sweep(Vector2 const& velocity, std::vector<Rectangle> const& others, size_t index, size_t length,
+			double& time, Vector2& normal, size_t& hit) const;
+	};
+}
+
+namespace std {
+	template <>
+	struct hash<Xna::Rectangle> {
+		size_t operator()(Xna::Rectangle const& r) const noexcept {
+			return static_cast<size_t>(Xna::Hash::Combine(
+				Xna::Hash::Mix(Xna::Hash::OfInt32Pair(r.X, r.Y)),
+				Xna::Hash::OfInt32Pair(r.Width, r.Height)));
+		}
 	};
 }
 
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <cmath>
+#include "RigidBodyIntegrator.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+
+namespace Xna {
+
+	static constexpr size_t StepGrain = 8192;
+
+	struct StepParameters {
+		IntegrationMethod Method;
+		double TimeStep;
+		double GravityX;
+		double GravityY;
+		double GravityZ;
+		double LinearDecay;
+		double AngularDecay;
+	};
+
+	//Written once for Simd::Scalar and Simd::Pair, 'i' being the first of T::Width bodies.
+	template <typename T>
+	static void IntegrateBody(RigidBodySet& b, size_t i, StepParameters const& p) {
+		T dt = T::Set(p.TimeStep);
+		T zero = T::Set(0.0);
+		T one = T::Set(1.0);
+		T inverseMass = T::Load(&b.InverseMass[i]);
+
+		//Kinematic bodies get neither gravity nor damping.
+		typename T::Mask dynamic = inverseMass > zero;
+		T gx = T::Select(dynamic, T::Set(p.GravityX), zero);
+		T gy = T::Select(dynamic, T::Set(p.GravityY), zero);
+		T gz = T::Select(dynamic, T::Set(p.GravityZ), zero);
+		T linearDecay = T::Select(dynamic, T::Set(p.LinearDecay), one);
+		T angularDecay = T::Select(dynamic, T::Set(p.AngularDecay), one);
+
+		T ax = gx + T::Load(&b.ForceX[i]) * inverseMass;
+		T ay = gy + T::Load(&b.ForceY[i]) * inverseMass;
+		T az = gz + T::Load(&b.ForceZ[i]) * inverseMass;
+
+		T px = T::Load(&b.PositionX[i]);
+		T py = T::Load(&b.PositionY[i]);
+		T pz = T::Load(&b.PositionZ[i]);
+		T vx, vy, vz;
+		T nx, ny, nz;
+
+		if (p.Method == IntegrationMethod::Verlet) {
+			T dt2 = dt * dt;
+			nx = px + (px - T::Load(&b.PreviousX[i])) * linearDecay + ax * dt2;
+			ny = py + (py - T::Load(&b.PreviousY[i])) * linearDecay + ay * dt2;
+			nz = pz + (pz - T::Load(&b.PreviousZ[i])) * linearDecay + az * dt2;
+
+			T inverseStep = one / dt;
+			vx = (nx - px) * inverseStep;
+			vy = (ny - py) * inverseStep;
+			vz = (nz - pz) * inverseStep;
+		}
+		else {
+			vx = (T::Load(&b.VelocityX[i]) + ax * dt) * linearDecay;
+			vy = (T::Load(&b.VelocityY[i]) + ay * dt) * linearDecay;
+			vz = (T::Load(&b.VelocityZ[i]) + az * dt) * linearDecay;
+			nx = px + vx * dt;
+			ny = py + vy * dt;
+			nz = pz + vz * dt;
+		}
+
+		px.Store(&b.PreviousX[i]);
+		py.Store(&b.PreviousY[i]);
+		pz.Store(&b.PreviousZ[i]);
+		nx.Store(&b.PositionX[i]);
+		ny.Store(&b.PositionY[i]);
+		nz.Store(&b.PositionZ[i]);
+		vx.Store(&b.VelocityX[i]);
+		vy.Store(&b.VelocityY[i]);
+		vz.Store(&b.VelocityZ[i]);
+
+		T inverseInertia = T::Load(&b.InverseInertia[i]);
+		T wx = (T::Load(&b.AngularVelocityX[i]) + T::Load(&b.TorqueX[i]) * inverseInertia * dt) * angularDecay;
+		T wy = (T::Load(&b.AngularVelocityY[i]) + T::Load(&b.TorqueY[i]) * inverseInertia * dt) * angularDecay;
+		T wz = (T::Load(&b.AngularVelocityZ[i]) + T::Load(&b.TorqueZ[i]) * inverseInertia * dt) * angularDecay;
+
+		wx.Store(&b.AngularVelocityX[i]);
+		wy.Store(&b.AngularVelocityY[i]);
+		wz.Store(&b.AngularVelocityZ[i]);
+
+		//q += (dt / 2) * (w, 0) * q, the product expanded with a zero scalar part.
+		T qx = T::Load(&b.OrientationX[i]);
+		T qy = T::Load(&b.OrientationY[i]);
+		T qz = T::Load(&b.OrientationZ[i]);
+		T qw = T::Load(&b.OrientationW[i]);
+		T half = dt * T::Set(0.5);
+
+		T rx = qx + half * (wx * qw + wy * qz - wz * qy);
+		T ry = qy + half * (wy * qw + wz * qx - wx * qz);
+		T rz = qz + half * (wz * qw + wx * qy - wy * qx);
+		T rw = qw - half * (wx * qx + wy * qy + wz * qz);
+
+		T inverseLength = one / T::Sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+
+		(rx * inverseLength).Store(&b.OrientationX[i]);
+		(ry * inverseLength).Store(&b.OrientationY[i]);
+		(rz * inverseLength).Store(&b.OrientationZ[i]);
+		(rw * inverseLength).Store(&b.OrientationW[i]);
+	}
+
+	size_t RigidBodySet::Count() const {
+		return PositionX.size();
+	}
+
+	void RigidBodySet::Resize(size_t count) {
+		PositionX.resize(count);
+		PositionY.resize(count);
+		PositionZ.resize(count);
+		PreviousX.resize(count);
+		PreviousY.resize(count);
+		PreviousZ.resize(count);
+		VelocityX.resize(count);
+		VelocityY.resize(count);
+		VelocityZ.resize(count);
+		OrientationX.resize(count);
+		OrientationY.resize(count);
+		OrientationZ.resize(count);
+		OrientationW.resize(count, 1.0);
+		AngularVelocityX.resize(count);
+		AngularVelocityY.resize(count);
+		AngularVelocityZ.resize(count);
+		ForceX.resize(count);
+		ForceY.resize(count);
+		ForceZ.resize(count);
+		TorqueX.resize(count);
+		TorqueY.resize(count);
+		TorqueZ.resize(count);
+		InverseMass.resize(count, 1.0);
+		InverseInertia.resize(count, 1.0);
+	}
+
+	void RigidBodySet::Clear() {
+		Resize(0);
+	}
+
+	size_t RigidBodySet::Add(Vector3 const& position, Quaternion const& orientation, double inverseMass, double inverseInertia) {
+		size_t index = Count();
+		Resize(index + 1);
+
+		SetPosition(index, position);
+		SetOrientation(index, orientation);
+		InverseMass[index] = inverseMass;
+		InverseInertia[index] = inverseInertia;
+
+		return index;
+	}
+
+	void RigidBodySet::RemoveAt(size_t index) {
+		size_t last = Count() - 1;
+
+		if (index > last) {
+			return;
+		}
+
+		std::vector<double>* arrays[] = {
+			&PositionX, &PositionY, &PositionZ, &PreviousX, &PreviousY, &PreviousZ,
+			&VelocityX, &VelocityY, &VelocityZ,
+			&OrientationX, &OrientationY, &OrientationZ, &OrientationW,
+			&AngularVelocityX, &AngularVelocityY, &AngularVelocityZ,
+			&ForceX, &ForceY, &ForceZ, &TorqueX, &TorqueY, &TorqueZ,
+			&InverseMass, &InverseInertia
+		};
+
+		for (std::vector<double>* array : arrays) {
+			(*array)[index] = (*array)[last];
+			array->pop_back();
+		}
+	}
+
+	Vector3 RigidBodySet::Position(size_t index) const {
+		return Vector3(PositionX[index], PositionY[index], PositionZ[index]);
+	}
+
+	Vector3 RigidBodySet::Velocity(size_t index) const {
+		return Vector3(VelocityX[index], VelocityY[index], VelocityZ[index]);
+	}
+
+	Quaternion RigidBodySet::Orientation(size_t index) const {
+		return Quaternion(OrientationX[index], OrientationY[index], OrientationZ[index], OrientationW[index]);
+	}
+
+	Vector3 RigidBodySet::AngularVelocity(size_t index) const {
+		return Vector3(AngularVelocityX[index], AngularVelocityY[index], AngularVelocityZ[index]);
+	}
+
+	void RigidBodySet::SetPosition(size_t index, Vector3 const& position) {
+		PreviousX[index] = position.X - (PositionX[index] - PreviousX[index]);
+		PreviousY[index] = position.Y - (PositionY[index] - PreviousY[index]);
+		PreviousZ[index] = position.Z - (PositionZ[index] - PreviousZ[index]);
+		PositionX[index] = position.X;
+		PositionY[index] = position.Y;
+		PositionZ[index] = position.Z;
+	}
+
+	void RigidBodySet::SetVelocity(size_t index, Vector3 const& velocity, double timeStep) {
+		VelocityX[index] = velocity.X;
+		VelocityY[index] = velocity.Y;
+		VelocityZ[index] = velocity.Z;
+		PreviousX[index] = PositionX[index] - velocity.X * timeStep;
+		PreviousY[index] = PositionY[index] - velocity.Y * timeStep;
+		PreviousZ[index] = PositionZ[index] - velocity.Z * timeStep;
+	}
+
+	void RigidBodySet::SetOrientation(size_t index, Quaternion const& orientation) {
+		OrientationX[index] = orientation.X;
+		OrientationY[index] = orientation.Y;
+		OrientationZ[index] = orientation.Z;
+		OrientationW[index] = orientation.W;
+	}
+
+	void RigidBodySet::SetAngularVelocity(size_t index, Vector3 const& angularVelocity) {
+		AngularVelocityX[index] = angularVelocity.X;
+		AngularVelocityY[index] = angularVelocity.Y;
+		AngularVelocityZ[index] = angularVelocity.Z;
+	}
+
+	void RigidBodySet::AddForce(size_t index, Vector3 const& force) {
+		ForceX[index] += force.X;
+		ForceY[index] += force.Y;
+		ForceZ[index] += force.Z;
+	}
+
+	void RigidBodySet::AddTorque(size_t index, Vector3 const& torque) {
+		TorqueX[index] += torque.X;
+		TorqueY[index] += torque.Y;
+		TorqueZ[index] += torque.Z;
+	}
+
+	void RigidBodySet::ClearForces() {
+		std::fill(ForceX.begin(), ForceX.end(), 0.0);
+		std::fill(ForceY.begin(), ForceY.end(), 0.0);
+		std::fill(ForceZ.begin(), ForceZ.end(), 0.0);
+		std::fill(TorqueX.begin(), TorqueX.end(), 0.0);
+		std::fill(TorqueY.begin(), TorqueY.end(), 0.0);
+		std::fill(TorqueZ.begin(), TorqueZ.end(), 0.0);
+	}
+
+	void RigidBodyIntegrator::Step(RigidBodySet& bodies, double timeStep) const {
+		if (!(timeStep > 0)) {
+			return;
+		}
+
+		StepParameters parameters{
+			Method,
+			timeStep,
+			Gravity.X,
+			Gravity.Y,
+			Gravity.Z,
+			std::exp(-LinearDamping * timeStep),
+			std::exp(-AngularDamping * timeStep)
+		};
+
+		Parallel::For(0, bodies.Count(), StepGrain, [&](size_t first, size_t last) {
+			size_t i = first;
+
+#ifdef XNA_SIMD_SSE2
+			for (; i + 2 <= last; i += 2) {
+				IntegrateBody<Simd::Pair>(bodies, i, parameters);
+			}
+#endif
+
+			for (; i < last; i++) {
+				IntegrateBody<Simd::Scalar>(bodies, i, parameters);
+			}
+		});
+	}
+
+	int32_t RigidBodyIntegrator::Advance(RigidBodySet& bodies, double elapsed) {
+		if (!(TimeStep > 0)) {
+			return 0;
+		}
+
+		if (elapsed > 0) {
+			accumulator += elapsed;
+		}
+
+		int32_t steps = 0;
+
+		while (accumulator >= TimeStep && steps < MaxSteps) {
+			Step(bodies, TimeStep);
+			accumulator -= TimeStep;
+			steps++;
+		}
+
+		if (accumulator >= TimeStep) {
+			accumulator = std::fmod(accumulator, TimeStep);
+		}
+
+		return steps;
+	}
+
+	double RigidBodyIntegrator::Alpha() const {
+		return TimeStep > 0 ? accumulator / TimeStep : 0.0;
+	}
+
+	void RigidBodyIntegrator::Reset() {
+		accumulator = 0;
+	}
+}
@@ -0,0 +1,109 @@
+#ifndef _RIGIDBODYINTEGRATOR_H_
+#define _RIGIDBODYINTEGRATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Vector3.hpp"
+#include "Quaternion.hpp"
+
+namespace Xna {
+
+	/*
+	 Rigid bodies as structure of arrays: every array holds Count() items. Positions and velocities are in world
+	 space, angular velocities in radians per second around world axes. Bodies with an inverse mass of 0 are
+	 kinematic: they keep their velocity and ignore gravity and forces. Inertia is isotropic (one inverse
+	 inertia per body). Forces and torques accumulate until ClearForces is called.
+	*/
+	class RigidBodySet {
+	public:
+		std::vector<double> PositionX;
+		std::vector<double> PositionY;
+		std::vector<double> PositionZ;
+		//Positions before the last step, used by Verlet integration.
+		std::vector<double> PreviousX;
+		std::vector<double> PreviousY;
+		std::vector<double> PreviousZ;
+		std::vector<double> VelocityX;
+		std::vector<double> VelocityY;
+		std::vector<double> VelocityZ;
+		std::vector<double> OrientationX;
+		std::vector<double> OrientationY;
+		std::vector<double> OrientationZ;
+		std::vector<double> OrientationW;
+		std::vector<double> AngularVelocityX;
+		std::vector<double> AngularVelocityY;
+		std::vector<double> AngularVelocityZ;
+		std::vector<double> ForceX;
+		std::vector<double> ForceY;
+		std::vector<double> ForceZ;
+		std::vector<double> TorqueX;
+		std::vector<double> TorqueY;
+		std::vector<double> TorqueZ;
+		std::vector<double> InverseMass;
+		std::vector<double> InverseInertia;
+
+		size_t Count() const;
+		//New bodies are at rest at the origin, with the identity orientation and an inverse mass of 1.
+		void Resize(size_t count);
+		void Clear();
+		//Returns the index of the new body.
+		size_t Add(Vector3 const& position, Quaternion const& orientation, double inverseMass, double inverseInertia);
+		//Moves the last body into index.
+		void RemoveAt(size_t index);
+
+		Vector3 Position(size_t index) const;
+		Vector3 Velocity(size_t index) const;
+		Quaternion Orientation(size_t index) const;
+		Vector3 AngularVelocity(size_t index) const;
+		//Also moves the previous position, so that Verlet integration does not see a velocity.
+		void SetPosition(size_t index, Vector3 const& position);
+		//Also updates the previous position, assuming a step of 'timeStep' seconds.
+		void SetVelocity(size_t index, Vector3 const& velocity, double timeStep);
+		void SetOrientation(size_t index, Quaternion const& orientation);
+		void SetAngularVelocity(size_t index, Vector3 const& angularVelocity);
+		void AddForce(size_t index, Vector3 const& force);
+		void AddTorque(size_t index, Vector3 const& torque);
+		void ClearForces();
+	};
+
+	enum class IntegrationMethod {
+		SemiImplicitEuler,
+		Verlet
+	};
+
+	/*
+	 Integrates a RigidBodySet two bodies per SSE2 instruction (scalar elsewhere), split over Parallel::For.
+	 Orientations follow dq/dt = 0.5 * w * q and are renormalized every step.
+	 Both methods keep the positions, previous positions and velocities consistent, so the method can change
+	 between steps. Verlet derives the velocity from the positions and expects a constant time step.
+	*/
+	class RigidBodyIntegrator {
+	public:
+		IntegrationMethod Method{ IntegrationMethod::SemiImplicitEuler };
+		Vector3 Gravity;
+		//Velocities decay by exp(-damping * timeStep).
+		double LinearDamping{ 0 };
+		double AngularDamping{ 0 };
+		double TimeStep{ 1.0 / 60.0 };
+		//Steps per Advance call; the time beyond it is dropped so a slow frame cannot snowball.
+		int32_t MaxSteps{ 8 };
+
+		//Integrates every body by 'timeStep' seconds.
+		void Step(RigidBodySet& bodies, double timeStep) const;
+
+		/*
+		 Accumulates 'elapsed' seconds and runs as many steps of TimeStep as fit.
+		 Returns the number of steps taken.
+		*/
+		int32_t Advance(RigidBodySet& bodies, double elapsed);
+		//Fraction of a step left in the accumulator, to interpolate between the previous and current state.
+		double Alpha() const;
+		void Reset();
+
+	private:
+		double accumulator{ 0 };
+	};
+}
+
+#endif
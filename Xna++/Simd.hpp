@@ -0,0 +1,201 @@
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XNA_SIMD_SSE2
+#endif
+
+namespace Xna {
+
+	/*
+	 Lane types for kernels written once as templates and instantiated for one double (Scalar) and,
+	 when SSE2 is available, two doubles at a time (Pair). Comparisons return a Mask, combined with
+	 | and & and consumed by Select or Bits (bit i set for lane i).
+	*/
+	namespace Simd {
+
+		struct ScalarMask {
+			bool Value;
+
+			friend ScalarMask operator| (ScalarMask a, ScalarMask b) { return { a.Value || b.Value }; }
+			friend ScalarMask operator& (ScalarMask a, ScalarMask b) { return { a.Value && b.Value }; }
+			int Bits() const { return Value ? 1 : 0; }
+		};
+
+		struct Scalar {
+			using Mask = ScalarMask;
+			static constexpr size_t Width = 1;
+
+			double Value;
+
+			static Scalar Load(double const* p) { return { *p }; }
+			static Scalar Set(double d) { return { d }; }
+			void Store(double* p) const { *p = Value; }
+
+			Scalar operator- () const { return { -Value }; }
+			friend Scalar operator+ (Scalar a, Scalar b) { return { a.Value + b.Value }; }
+			friend Scalar operator- (Scalar a, Scalar b) { return { a.Value - b.Value }; }
+			friend Scalar operator* (Scalar a, Scalar b) { return { a.Value * b.Value }; }
+			friend Scalar operator/ (Scalar a, Scalar b) { return { a.Value / b.Value }; }
+			friend Mask operator< (Scalar a, Scalar b) { return { a.Value < b.Value }; }
+			friend Mask operator<= (Scalar a, Scalar b) { return { a.Value <= b.Value }; }
+			friend Mask operator> (Scalar a, Scalar b) { return { a.Value > b.Value }; }
+			friend Mask operator>= (Scalar a, Scalar b) { return { a.Value >= b.Value }; }
+
+			static Scalar Sqrt(Scalar a) { return { std::sqrt(a.Value) }; }
+			static Scalar Abs(Scalar a) { return { std::fabs(a.Value) }; }
+			static Scalar Min(Scalar a, Scalar b) { return { b.Value < a.Value ? b.Value : a.Value }; }
+			static Scalar Max(Scalar a, Scalar b) { return { b.Value > a.Value ? b.Value : a.Value }; }
+			//ifTrue where mask is set, otherwise.
+			static Scalar Select(Mask mask, Scalar ifTrue, Scalar otherwise) { return mask.Value ? ifTrue : otherwise; }
+		};
+
+#ifdef XNA_SIMD_SSE2
+		struct PairMask {
+			__m128d Value;
+
+			friend PairMask operator| (PairMask a, PairMask b) { return { _mm_or_pd(a.Value, b.Value) }; }
+			friend PairMask operator& (PairMask a, PairMask b) { return { _mm_and_pd(a.Value, b.Value) }; }
+			int Bits() const { return _mm_movemask_pd(Value); }
+		};
+
+		struct Pair {
+			using Mask = PairMask;
+			static constexpr size_t Width = 2;
+
+			__m128d Value;
+
+			static Pair Load(double const* p) { return { _mm_loadu_pd(p) }; }
+			static Pair Set(double d) { return { _mm_set1_pd(d) }; }
+			void Store(double* p) const { _mm_storeu_pd(p, Value); }
+
+			Pair operator- () const { return { _mm_sub_pd(_mm_setzero_pd(), Value) }; }
+			friend Pair operator+ (Pair a, Pair b) { return { _mm_add_pd(a.Value, b.Value) }; }
+			friend Pair operator- (Pair a, Pair b) { return { _mm_sub_pd(a.Value, b.Value) }; }
+			friend Pair operator* (Pair a, Pair b) { return { _mm_mul_pd(a.Value, b.Value) }; }
+			friend Pair operator/ (Pair a, Pair b) { return { _mm_div_pd(a.Value, b.Value) }; }
+			friend Mask operator< (Pair a, Pair b) { return { _mm_cmplt_pd(a.Value, b.Value) }; }
+			friend Mask operator<= (Pair a, Pair b) { return { _mm_cmple_pd(a.Value, b.Value) }; }
+			friend Mask operator> (Pair a, Pair b) { return { _mm_cmpgt_pd(a.Value, b.Value) }; }
+			friend Mask operator>= (Pair a, Pair b) { return { _mm_cmpge_pd(a.Value, b.Value) }; }
+
+			static Pair Sqrt(Pair a) { return { _mm_sqrt_pd(a.Value) }; }
+			static Pair Abs(Pair a) { return { _mm_andnot_pd(_mm_set1_pd(-0.0), a.Value) }; }
+			static Pair Min(Pair a, Pair b) { return { _mm_min_pd(a.Value, b.Value) }; }
+			static Pair Max(Pair a, Pair b) { return { _mm_max_pd(a.Value, b.Value) }; }
+			static Pair Select(Mask mask, Pair ifTrue, Pair otherwise) {
+				return { _mm_or_pd(_mm_and_pd(mask.Value, ifTrue.Value), _mm_andnot_pd(mask.Value, otherwise.Value)) };
+			}
+		};
+#endif
+
+		//Mask of Twice, whose halves are HalfWidth lanes wide.
+		template <typename M, size_t HalfWidth>
+		struct TwiceMask {
+			M Low;
+			M High;
+
+			friend TwiceMask operator| (TwiceMask a, TwiceMask b) { return { a.Low | b.Low, a.High | b.High }; }
+			friend TwiceMask operator& (TwiceMask a, TwiceMask b) { return { a.Low & b.Low, a.High & b.High }; }
+			int Bits() const { return Low.Bits() | (High.Bits() << HalfWidth); }
+		};
+
+		/*
+		 Two T side by side. Kernels whose lanes each run a long dependency chain (a series, an iteration)
+		 keep twice as many chains in flight with Twice<Pair> than with Pair.
+		*/
+		template <typename T>
+		struct Twice {
+			using Mask = TwiceMask<typename T::Mask, T::Width>;
+			static constexpr size_t Width = 2 * T::Width;
+
+			T Low;
+			T High;
+
+			static Twice Load(double const* p) { return { T::Load(p), T::Load(p + T::Width) }; }
+			static Twice Set(double d) { return { T::Set(d), T::Set(d) }; }
+			void Store(double* p) const { Low.Store(p); High.Store(p + T::Width); }
+
+			Twice operator- () const { return { -Low, -High }; }
+			friend Twice operator+ (Twice a, Twice b) { return { a.Low + b.Low, a.High + b.High }; }
+			friend Twice operator- (Twice a, Twice b) { return { a.Low - b.Low, a.High - b.High }; }
+			friend Twice operator* (Twice a, Twice b) { return { a.Low * b.Low, a.High * b.High }; }
+			friend Twice operator/ (Twice a, Twice b) { return { a.Low / b.Low, a.High / b.High }; }
+			friend Mask operator< (Twice a, Twice b) { return { a.Low < b.Low, a.High < b.High }; }
+			friend Mask operator<= (Twice a, Twice b) { return { a.Low <= b.Low, a.High <= b.High }; }
+			friend Mask operator> (Twice a, Twice b) { return { a.Low > b.Low, a.High > b.High }; }
+			friend Mask operator>= (Twice a, Twice b) { return { a.Low >= b.Low, a.High >= b.High }; }
+
+			static Twice Sqrt(Twice a) { return { T::Sqrt(a.Low), T::Sqrt(a.High) }; }
+			static Twice Abs(Twice a) { return { T::Abs(a.Low), T::Abs(a.High) }; }
+			static Twice Min(Twice a, Twice b) { return { T::Min(a.Low, b.Low), T::Min(a.High, b.High) }; }
+			static Twice Max(Twice a, Twice b) { return { T::Max(a.Low, b.Low), T::Max(a.High, b.High) }; }
+			static Twice Select(Mask mask, Twice ifTrue, Twice otherwise) {
+				return { T::Select(mask.Low, ifTrue.Low, otherwise.Low), T::Select(mask.High, ifTrue.High, otherwise.High) };
+			}
+		};
+
+		/*
+		 Coefficients of the slerp series of D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP":
+		 u[i] = 1 / ((i + 1) (2i + 3)) and v[i] = (i + 1) / (2i + 3), with the last pair scaled by mu to make
+		 up for the truncated terms. Eberly's 8 terms are off by 2e-5 for quaternions 90 degrees apart; 16
+		 terms, with mu fitted again, stay within 3.1e-8 over all of [0, 1].
+		*/
+		static constexpr size_t SlerpTerms = 16;
+		static constexpr double SlerpMu = 1.9167;
+		static constexpr double SlerpU[SlerpTerms] = {
+			1.0 / 3.0, 1.0 / 10.0, 1.0 / 21.0, 1.0 / 36.0, 1.0 / 55.0, 1.0 / 78.0, 1.0 / 105.0, 1.0 / 136.0,
+			1.0 / 171.0, 1.0 / 210.0, 1.0 / 253.0, 1.0 / 300.0, 1.0 / 351.0, 1.0 / 406.0, 1.0 / 465.0,
+			SlerpMu / 528.0
+		};
+		static constexpr double SlerpV[SlerpTerms] = {
+			1.0 / 3.0, 2.0 / 5.0, 3.0 / 7.0, 4.0 / 9.0, 5.0 / 11.0, 6.0 / 13.0, 7.0 / 15.0, 8.0 / 17.0,
+			9.0 / 19.0, 10.0 / 21.0, 11.0 / 23.0, 12.0 / 25.0, 13.0 / 27.0, 14.0 / 29.0, 15.0 / 31.0,
+			SlerpMu * 16.0 / 33.0
+		};
+
+		/*
+		 Slerp of the unit quaternions from and to (X, Y, Z, W) by amount in [0, 1], along the shorter arc,
+		 without trigonometry. result may be from.
+		*/
+		template <typename T>
+		inline void Slerp(T const* from, T const* to, T amount, T* result) {
+			T one = T::Set(1.0);
+			T dot = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+			//q and -q are the same rotation.
+			typename T::Mask flip = dot < T::Set(0.0);
+
+			T xm1 = T::Abs(dot) - one;
+			T d = one - amount;
+			T squareT = amount * amount;
+			T squareD = d * d;
+			T cT = one;
+			T cD = one;
+			T productT = one;
+			T productD = one;
+
+			//1 + b0 (1 + b1 (1 + ...)) summed as 1 + b0 + b0 b1 + ..., so that only the products form a dependency chain.
+			for (size_t k = 0; k < SlerpTerms; k++) {
+				T u = T::Set(SlerpU[k]);
+				T v = T::Set(SlerpV[k]);
+				productT = productT * ((u * squareT - v) * xm1);
+				productD = productD * ((u * squareD - v) * xm1);
+				cT = cT + productT;
+				cD = cD + productD;
+			}
+
+			cT = T::Select(flip, -(cT * amount), cT * amount);
+			cD = cD * d;
+
+			for (size_t k = 0; k < 4; k++) {
+				result[k] = cD * from[k] + cT * to[k];
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include "SnapshotBuffer.hpp"
+#include "Simd.hpp"
+
+namespace Xna {
+
+	/*
+	 Lerps the positions (columns 0 to 2) and slerps the rotations (3 to 6) of the lanes from i, by amount for the
+	 positions and by amount clamped to [0, 1] for the rotations.
+	*/
+	template <typename T>
+	static void Interpolate(double const* const* from, double const* const* to, double amount,
+		Vector3* positions, Quaternion* rotations, size_t i) {
+
+		T t = T::Set(amount);
+		double lanes[7][T::Width];
+
+		for (size_t k = 0; k < 3; k++) {
+			T a = T::Load(from[k] + i);
+			T b = T::Load(to[k] + i);
+			(a + (b - a) * t).Store(lanes[k]);
+		}
+
+		T q0[4];
+		T q1[4];
+		T q[4];
+
+		for (size_t k = 0; k < 4; k++) {
+			q0[k] = T::Load(from[3 + k] + i);
+			q1[k] = T::Load(to[3 + k] + i);
+		}
+
+		Simd::Slerp(q0, q1, T::Max(T::Min(t, T::Set(1.0)), T::Set(0.0)), q);
+
+		for (size_t k = 0; k < 4; k++) {
+			q[k].Store(lanes[3 + k]);
+		}
+
+		for (size_t l = 0; l < T::Width; l++) {
+			positions[i + l].X = lanes[0][l];
+			positions[i + l].Y = lanes[1][l];
+			positions[i + l].Z = lanes[2][l];
+			rotations[i + l].X = lanes[3][l];
+			rotations[i + l].Y = lanes[4][l];
+			rotations[i + l].Z = lanes[5][l];
+			rotations[i + l].W = lanes[6][l];
+		}
+	}
+
+	//Amount from 'first' to 'second' at 'time', extrapolating past 'second' by at most 'maxExtrapolation'.
+	static double Amount(double first, double second, double time, double maxExtrapolation) {
+		if (second <= first) {
+			return 0;
+		}
+
+		double end = second + maxExtrapolation;
+		return ((time < end ? time : end) - first) / (second - first);
+	}
+
+	SnapshotBuffer::SnapshotBuffer(size_t entityCount, size_t capacity) :
+		entityCount(entityCount), snapshots(capacity < 2 ? 2 : capacity) {
+
+		for (size_t s = 0; s < snapshots.size(); s++) {
+			for (size_t k = 0; k < 7; k++) {
+				snapshots[s].Columns[k].resize(entityCount);
+			}
+
+			snapshots[s].Present.resize(entityCount);
+		}
+	}
+
+	size_t SnapshotBuffer::Count() const {
+		return entityCount;
+	}
+
+	size_t SnapshotBuffer::Capacity() const {
+		return snapshots.size();
+	}
+
+	size_t SnapshotBuffer::SnapshotCount() const {
+		return order.size();
+	}
+
+	size_t SnapshotBuffer::SnapshotCount(size_t entity) const {
+		size_t count = 0;
+
+		for (size_t s = 0; s < order.size() && entity < entityCount; s++) {
+			count += snapshots[order[s]].Present[entity];
+		}
+
+		return count;
+	}
+
+	double SnapshotBuffer::NewestTime() const {
+		return order.empty() ? 0 : snapshots[order.back()].Time;
+	}
+
+	void SnapshotBuffer::Resize(size_t entityCount) {
+		for (size_t s = 0; s < snapshots.size(); s++) {
+			for (size_t k = 0; k < 7; k++) {
+				snapshots[s].Columns[k].resize(entityCount);
+			}
+
+			snapshots[s].Present.resize(entityCount, 0);
+		}
+
+		this->entityCount = entityCount;
+	}
+
+	void SnapshotBuffer::Clear() {
+		order.clear();
+	}
+
+	void SnapshotBuffer::Clear(size_t entity) {
+		for (size_t s = 0; s < snapshots.size() && entity < entityCount; s++) {
+			snapshots[s].Present[entity] = 0;
+		}
+	}
+
+	bool SnapshotBuffer::Push(double time, std::vector<Vector3> const& positions, std::vector<Quaternion> const& rotations) {
+		if (positions.size() != entityCount || rotations.size() != entityCount) {
+			return false;
+		}
+
+		size_t index = Insert(time);
+
+		if (index == snapshots.size()) {
+			return false;
+		}
+
+		Snapshot& snapshot = snapshots[index];
+		double* columns[7];
+
+		for (size_t k = 0; k < 7; k++) {
+			columns[k] = snapshot.Columns[k].data();
+		}
+
+		for (size_t i = 0; i < entityCount; i++) {
+			columns[0][i] = positions[i].X;
+			columns[1][i] = positions[i].Y;
+			columns[2][i] = positions[i].Z;
+			columns[3][i] = rotations[i].X;
+			columns[4][i] = rotations[i].Y;
+			columns[5][i] = rotations[i].Z;
+			columns[6][i] = rotations[i].W;
+		}
+
+		std::fill(snapshot.Present.begin(), snapshot.Present.end(), static_cast<uint8_t>(1));
+		return true;
+	}
+
+	bool SnapshotBuffer::Push(size_t entity, double time, Vector3 const& position, Quaternion const& rotation) {
+		if (entity >= entityCount) {
+			return false;
+		}
+
+		size_t index = Insert(time);
+
+		if (index == snapshots.size()) {
+			return false;
+		}
+
+		Snapshot& snapshot = snapshots[index];
+		double values[7] = { position.X, position.Y, position.Z, rotation.X, rotation.Y, rotation.Z, rotation.W };
+
+		for (size_t k = 0; k < 7; k++) {
+			snapshot.Columns[k][entity] = values[k];
+		}
+
+		snapshot.Present[entity] = 1;
+		return true;
+	}
+
+	void SnapshotBuffer::Sample(double time, std::vector<Vector3>& positions, std::vector<Quaternion>& rotations) const {
+		positions.resize(entityCount);
+		rotations.resize(entityCount);
+
+		if (order.empty()) {
+			std::fill(positions.begin(), positions.end(), Vector3());
+			std::fill(rotations.begin(), rotations.end(), Quaternion(0, 0, 0, 1));
+			return;
+		}
+
+		//The two snapshots around the time, or the oldest twice.
+		size_t k = 1;
+
+		while (k < order.size() - 1 && snapshots[order[k]].Time <= time) {
+			k++;
+		}
+
+		Snapshot const* first = &snapshots[order[0]];
+		Snapshot const* second = first;
+		double amount = 0;
+
+		if (order.size() > 1 && time > first->Time) {
+			first = &snapshots[order[k - 1]];
+			second = &snapshots[order[k]];
+			amount = Amount(first->Time, second->Time, time, MaxExtrapolation);
+		}
+
+		double const* from[7];
+		double const* to[7];
+
+		for (size_t c = 0; c < 7; c++) {
+			from[c] = first->Columns[c].data();
+			to[c] = second->Columns[c].data();
+		}
+
+		size_t i = 0;
+
+#ifdef XNA_SIMD_SSE2
+		for (; i + 2 <= entityCount; i += 2) {
+			Interpolate<Simd::Pair>(from, to, amount, positions.data(), rotations.data(), i);
+		}
+#endif
+		for (; i < entityCount; i++) {
+			Interpolate<Simd::Scalar>(from, to, amount, positions.data(), rotations.data(), i);
+		}
+
+		for (size_t e = 0; e < entityCount; e++) {
+			if (!first->Present[e] || !second->Present[e]) {
+				SampleEntity(e, time, positions[e], rotations[e]);
+			}
+		}
+
+		//The series only covers [0, 1]: rotations past the newest snapshot are extrapolated one at a time.
+		if (amount > 1) {
+			for (size_t e = 0; e < entityCount; e++) {
+				if (first->Present[e] && second->Present[e]) {
+					Quaternion q0(from[3][e], from[4][e], from[5][e], from[6][e]);
+					Quaternion q1(to[3][e], to[4][e], to[5][e], to[6][e]);
+					rotations[e] = Quaternion::Normalize(Quaternion::SLerp(q0, q1, amount));
+				}
+			}
+		}
+	}
+
+	size_t SnapshotBuffer::Insert(double time) {
+		size_t k = 0;
+
+		while (k < order.size() && snapshots[order[k]].Time < time) {
+			k++;
+		}
+
+		if (k < order.size() && snapshots[order[k]].Time == time) {
+			return order[k];
+		}
+
+		size_t index;
+
+		if (order.size() == snapshots.size()) {
+			if (k == 0) {
+				return snapshots.size();
+			}
+
+			index = order[0];
+			order.erase(order.begin());
+			k--;
+		}
+		else {
+			index = order.size();
+
+			//Indices freed by Clear are reused in any order, so look for one not in use.
+			while (std::find(order.begin(), order.end(), index) != order.end()) {
+				index = (index + 1) % snapshots.size();
+			}
+		}
+
+		order.insert(order.begin() + k, index);
+		snapshots[index].Time = time;
+		std::fill(snapshots[index].Present.begin(), snapshots[index].Present.end(), static_cast<uint8_t>(0));
+
+		return index;
+	}
+
+	//Interpolates an entity between its own nearest snapshots, for entities missing from the shared ones.
+	void SnapshotBuffer::SampleEntity(size_t entity, double time, Vector3& position, Quaternion& rotation) const {
+		size_t count = 0;
+		size_t last = 0;
+		size_t previous = 0;
+		size_t next = order.size();
+
+		for (size_t s = 0; s < order.size(); s++) {
+			Snapshot const& snapshot = snapshots[order[s]];
+
+			if (!snapshot.Present[entity]) {
+				continue;
+			}
+
+			if (snapshot.Time > time) {
+				next = s;
+				break;
+			}
+
+			previous = last;
+			last = s;
+			count++;
+		}
+
+		Snapshot const* first;
+		Snapshot const* second;
+		double amount = 0;
+
+		if (count == 0) {
+			if (next == order.size()) {
+				position = Vector3();
+				rotation = Quaternion(0, 0, 0, 1);
+				return;
+			}
+
+			first = &snapshots[order[next]];
+			second = first;
+		}
+		else if (next < order.size()) {
+			first = &snapshots[order[last]];
+			second = &snapshots[order[next]];
+			amount = Amount(first->Time, second->Time, time, MaxExtrapolation);
+		}
+		else if (count > 1) {
+			first = &snapshots[order[previous]];
+			second = &snapshots[order[last]];
+			amount = Amount(first->Time, second->Time, time, MaxExtrapolation);
+		}
+		else {
+			first = &snapshots[order[last]];
+			second = first;
+		}
+
+		Vector3 p0(first->Columns[0][entity], first->Columns[1][entity], first->Columns[2][entity]);
+		Vector3 p1(second->Columns[0][entity], second->Columns[1][entity], second->Columns[2][entity]);
+		Quaternion q0(first->Columns[3][entity], first->Columns[4][entity], first->Columns[5][entity], first->Columns[6][entity]);
+		Quaternion q1(second->Columns[3][entity], second->Columns[4][entity], second->Columns[5][entity], second->Columns[6][entity]);
+
+		position = Vector3::Lerp(p0, p1, amount);
+		rotation = Quaternion::Normalize(Quaternion::SLerp(q0, q1, amount));
+	}
+}
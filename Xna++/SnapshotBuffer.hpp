@@ -0,0 +1,82 @@
+#ifndef _SNAPSHOTBUFFER_H_
+#define _SNAPSHOTBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	/*
+	 Jitter buffer for the transforms of remote entities, sampled at a render time (usually the newest server
+	 time minus an interpolation delay that covers the network jitter).
+
+	 The buffer is a ring of the last Capacity() snapshots, kept sorted by time so that late packets are
+	 inserted in place. Each snapshot stores the transforms of all entities as structure of arrays, with a
+	 flag per entity telling whether the snapshot had it. Sample finds the two snapshots around the render
+	 time once, then interpolates every entity present in both in one pass over their arrays, two entities
+	 per SSE2 instruction, with Eberly's series for slerp (no trigonometry, within 1e-7 of Quaternion::SLerp
+	 for unit quaternions). Entities missing from one of the two snapshots fall back to their own nearest
+	 snapshots, one at a time.
+
+	 Between two snapshots the position is lerped and the rotation slerped; past the newest snapshot both
+	 are extrapolated from the last two, for at most MaxExtrapolation seconds, and then held; before the
+	 oldest (or with a single snapshot) the entity holds its snapshot. Entities without any snapshot sample
+	 as the origin with the identity rotation.
+	*/
+	class SnapshotBuffer {
+	public:
+		double MaxExtrapolation{ 0.25 };
+
+		//capacity snapshots, at least 2.
+		SnapshotBuffer(size_t entityCount, size_t capacity);
+
+		size_t Count() const;
+		size_t Capacity() const;
+		//Number of snapshots stored.
+		size_t SnapshotCount() const;
+		//Number of stored snapshots that have the entity.
+		size_t SnapshotCount(size_t entity) const;
+		//Time of the newest snapshot, or 0 if there is none.
+		double NewestTime() const;
+
+		void Resize(size_t entityCount);
+		//Forgets every snapshot.
+		void Clear();
+		//Forgets the snapshots of one entity.
+		void Clear(size_t entity);
+
+		/*
+		 Stores a snapshot of every entity. A snapshot with the time of a stored one replaces it; when the
+		 ring is full the oldest snapshot is dropped, and a snapshot older than all of them is rejected.
+		 Returns false if rejected or if the arrays do not have Count() items.
+		*/
+		bool Push(double time, std::vector<Vector3> const& positions, std::vector<Quaternion> const& rotations);
+		//Stores the transform of one entity in the snapshot at 'time', adding the snapshot if needed.
+		bool Push(size_t entity, double time, Vector3 const& position, Quaternion const& rotation);
+
+		//Transforms of every entity at 'time', resizing the arrays to Count().
+		void Sample(double time, std::vector<Vector3>& positions, std::vector<Quaternion>& rotations) const;
+
+	private:
+		struct Snapshot {
+			double Time{ 0 };
+			//Position X, Y, Z and rotation X, Y, Z, W of every entity.
+			std::vector<double> Columns[7];
+			std::vector<uint8_t> Present;
+		};
+
+		size_t entityCount{ 0 };
+		std::vector<Snapshot> snapshots;
+		//Indices of the stored snapshots, oldest first.
+		std::vector<size_t> order;
+
+		//Index of the snapshot at 'time', added (and made empty) if needed, or snapshots.size() if rejected.
+		size_t Insert(double time);
+		void SampleEntity(size_t entity, double time, Vector3& position, Quaternion& rotation) const;
+	};
+}
+
+#endif
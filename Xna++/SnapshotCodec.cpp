@@ -0,0 +1,298 @@
+#include <cmath>
+#include "SnapshotCodec.hpp"
+
+namespace Xna {
+
+	//Bound of the three smallest components of a unit quaternion.
+	static constexpr double SmallestThreeBound = 0.70710678118654752440;
+	static constexpr int32_t MaxRotationBits = 10;
+
+	static uint32_t ZigZag(int64_t value) {
+		return static_cast<uint32_t>((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+	}
+
+	static int64_t UnZigZag(uint32_t value) {
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	size_t QuantizedSnapshot::Count() const {
+		return Rotation.size();
+	}
+
+	void QuantizedSnapshot::Resize(size_t count) {
+		PositionX.resize(count);
+		PositionY.resize(count);
+		PositionZ.resize(count);
+		Rotation.resize(count);
+	}
+
+	SnapshotCodec::SnapshotCodec(Vector3 const& min, Vector3 const& max, double precision, int32_t rotationBits) :
+		rotationBits(rotationBits < 1 ? 1 : (rotationBits > MaxRotationBits ? MaxRotationBits : rotationBits)) {
+
+		double mins[3] = { min.X, min.Y, min.Z };
+		double maxs[3] = { max.X, max.Y, max.Z };
+
+		for (size_t axis = 0; axis < 3; axis++) {
+			this->min[axis] = mins[axis];
+			this->max[axis] = maxs[axis] > mins[axis] ? maxs[axis] : mins[axis];
+
+			double range = this->max[axis] - this->min[axis];
+			double steps = precision > 0 ? std::ceil(range / precision) : 0;
+
+			if (steps > 4294967295.0) {
+				steps = 4294967295.0;
+			}
+
+			int32_t bits = 0;
+			while (bits < 32 && static_cast<double>(uint64_t(1) << bits) <= steps) {
+				bits++;
+			}
+
+			maxValue[axis] = static_cast<uint32_t>(steps);
+			positionBits[axis] = bits;
+			step[axis] = steps > 0 ? range / steps : 0;
+			inverseStep[axis] = steps > 0 ? steps / range : 0;
+		}
+	}
+
+	Vector3 SnapshotCodec::Min() const {
+		return Vector3(min[0], min[1], min[2]);
+	}
+
+	Vector3 SnapshotCodec::Max() const {
+		return Vector3(max[0], max[1], max[2]);
+	}
+
+	int32_t SnapshotCodec::PositionBits(size_t axis) const {
+		return positionBits[axis];
+	}
+
+	int32_t SnapshotCodec::RotationBits() const {
+		return rotationBits;
+	}
+
+	uint32_t SnapshotCodec::QuantizePosition(double value, size_t axis) const {
+		double scaled = std::floor((value - min[axis]) * inverseStep[axis] + 0.5);
+
+		if (!(scaled > 0)) {
+			return 0;
+		}
+
+		return scaled >= maxValue[axis] ? maxValue[axis] : static_cast<uint32_t>(scaled);
+	}
+
+	double SnapshotCodec::DequantizePosition(uint32_t value, size_t axis) const {
+		return min[axis] + value * step[axis];
+	}
+
+	uint32_t SnapshotCodec::QuantizeRotation(Quaternion const& rotation) const {
+		double components[4] = { rotation.X, rotation.Y, rotation.Z, rotation.W };
+		uint32_t largest = 0;
+
+		for (uint32_t i = 1; i < 4; i++) {
+			if (std::fabs(components[i]) > std::fabs(components[largest])) {
+				largest = i;
+			}
+		}
+
+		double sign = components[largest] < 0 ? -1.0 : 1.0;
+		double maximum = static_cast<double>((1u << rotationBits) - 1);
+		double scale = maximum / (2.0 * SmallestThreeBound);
+		uint32_t packed = largest;
+
+		for (uint32_t i = 0; i < 4; i++) {
+			if (i == largest) {
+				continue;
+			}
+
+			double scaled = std::floor((components[i] * sign + SmallestThreeBound) * scale + 0.5);
+			scaled = scaled < 0 ? 0 : (scaled > maximum ? maximum : scaled);
+			packed = (packed << rotationBits) | static_cast<uint32_t>(scaled);
+		}
+
+		return packed;
+	}
+
+	Quaternion SnapshotCodec::DequantizeRotation(uint32_t value) const {
+		uint32_t mask = (1u << rotationBits) - 1;
+		double scale = (2.0 * SmallestThreeBound) / static_cast<double>(mask);
+		uint32_t largest = (value >> (3 * rotationBits)) & 3;
+		double components[4];
+		double sum = 0;
+
+		for (int32_t i = 3, shift = 0; i >= 0; i--) {
+			if (static_cast<uint32_t>(i) == largest) {
+				continue;
+			}
+
+			components[i] = ((value >> shift) & mask) * scale - SmallestThreeBound;
+			sum += components[i] * components[i];
+			shift += rotationBits;
+		}
+
+		components[largest] = sum < 1.0 ? std::sqrt(1.0 - sum) : 0.0;
+
+		return Quaternion(components[0], components[1], components[2], components[3]);
+	}
+
+	bool SnapshotCodec::Quantize(std::vector<Vector3> const& positions, std::vector<Quaternion> const& rotations, QuantizedSnapshot& result) const {
+		if (positions.size() != rotations.size()) {
+			return false;
+		}
+
+		size_t count = positions.size();
+		result.Resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			result.PositionX[i] = QuantizePosition(positions[i].X, 0);
+			result.PositionY[i] = QuantizePosition(positions[i].Y, 1);
+			result.PositionZ[i] = QuantizePosition(positions[i].Z, 2);
+			result.Rotation[i] = QuantizeRotation(rotations[i]);
+		}
+
+		return true;
+	}
+
+	void SnapshotCodec::Dequantize(QuantizedSnapshot const& snapshot, std::vector<Vector3>& positions, std::vector<Quaternion>& rotations) const {
+		size_t count = snapshot.Count();
+		positions.resize(count);
+		rotations.resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			positions[i] = Vector3(
+				DequantizePosition(snapshot.PositionX[i], 0),
+				DequantizePosition(snapshot.PositionY[i], 1),
+				DequantizePosition(snapshot.PositionZ[i], 2));
+			rotations[i] = DequantizeRotation(snapshot.Rotation[i]);
+		}
+	}
+
+	/*
+	 Count on 32 bits, then per entity the rotation and the three axes. Against a baseline, the rotation
+	 is a changed bit followed by the full value, and each axis a changed bit followed by a bit choosing
+	 between a zigzag delta of DeltaBits bits and the full value.
+	*/
+	void SnapshotCodec::Encode(QuantizedSnapshot const& snapshot, QuantizedSnapshot const* baseline, BitWriter& writer) const {
+		size_t count = snapshot.Count();
+		size_t based = baseline == nullptr ? 0 : (baseline->Count() < count ? baseline->Count() : count);
+		int32_t rotationSize = 2 + 3 * rotationBits;
+
+		writer.Write(static_cast<uint32_t>(count), 32);
+
+		for (size_t i = 0; i < based; i++) {
+			if (snapshot.Rotation[i] == baseline->Rotation[i]) {
+				writer.WriteBool(false);
+			}
+			else {
+				writer.WriteBool(true);
+				writer.Write(snapshot.Rotation[i], rotationSize);
+			}
+
+			EncodeAxis(snapshot.PositionX[i], baseline->PositionX[i], 0, writer);
+			EncodeAxis(snapshot.PositionY[i], baseline->PositionY[i], 1, writer);
+			EncodeAxis(snapshot.PositionZ[i], baseline->PositionZ[i], 2, writer);
+		}
+
+		for (size_t i = based; i < count; i++) {
+			writer.Write(snapshot.Rotation[i], rotationSize);
+			writer.Write(snapshot.PositionX[i], positionBits[0]);
+			writer.Write(snapshot.PositionY[i], positionBits[1]);
+			writer.Write(snapshot.PositionZ[i], positionBits[2]);
+		}
+	}
+
+	bool SnapshotCodec::Decode(BitReader& reader, QuantizedSnapshot const* baseline, QuantizedSnapshot& result) const {
+		uint32_t count;
+
+		//Every entity takes at least one bit, which bounds the count of a corrupt packet.
+		if (!reader.Read(32, count) || count > reader.BitsLeft()) {
+			return false;
+		}
+
+		size_t based = baseline == nullptr ? 0 : (baseline->Count() < count ? baseline->Count() : count);
+		int32_t rotationSize = 2 + 3 * rotationBits;
+		result.Resize(count);
+
+		for (size_t i = 0; i < based; i++) {
+			bool changed;
+
+			if (!reader.ReadBool(changed)) {
+				return false;
+			}
+
+			if (!changed) {
+				result.Rotation[i] = baseline->Rotation[i];
+			}
+			else if (!reader.Read(rotationSize, result.Rotation[i])) {
+				return false;
+			}
+
+			if (!DecodeAxis(reader, baseline->PositionX[i], 0, result.PositionX[i])
+				|| !DecodeAxis(reader, baseline->PositionY[i], 1, result.PositionY[i])
+				|| !DecodeAxis(reader, baseline->PositionZ[i], 2, result.PositionZ[i])) {
+				return false;
+			}
+		}
+
+		for (size_t i = based; i < count; i++) {
+			if (!reader.Read(rotationSize, result.Rotation[i])
+				|| !reader.Read(positionBits[0], result.PositionX[i])
+				|| !reader.Read(positionBits[1], result.PositionY[i])
+				|| !reader.Read(positionBits[2], result.PositionZ[i])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void SnapshotCodec::EncodeAxis(uint32_t value, uint32_t base, size_t axis, BitWriter& writer) const {
+		if (value == base) {
+			writer.WriteBool(false);
+			return;
+		}
+
+		uint32_t delta = ZigZag(static_cast<int64_t>(value) - static_cast<int64_t>(base));
+		writer.WriteBool(true);
+
+		if (delta < (1u << DeltaBits) && DeltaBits < positionBits[axis]) {
+			writer.WriteBool(true);
+			writer.Write(delta, DeltaBits);
+		}
+		else {
+			writer.WriteBool(false);
+			writer.Write(value, positionBits[axis]);
+		}
+	}
+
+	bool SnapshotCodec::DecodeAxis(BitReader& reader, uint32_t base, size_t axis, uint32_t& value) const {
+		bool changed;
+		bool small;
+
+		if (!reader.ReadBool(changed)) {
+			return false;
+		}
+
+		if (!changed) {
+			value = base;
+			return true;
+		}
+
+		if (!reader.ReadBool(small)) {
+			return false;
+		}
+
+		if (!small) {
+			return reader.Read(positionBits[axis], value);
+		}
+
+		uint32_t delta;
+
+		if (!reader.Read(DeltaBits, delta)) {
+			return false;
+		}
+
+		value = static_cast<uint32_t>(static_cast<int64_t>(base) + UnZigZag(delta));
+		return true;
+	}
+}
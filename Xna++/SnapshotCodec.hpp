@@ -0,0 +1,77 @@
+#ifndef _SNAPSHOTCODEC_H_
+#define _SNAPSHOTCODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BitStream.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	//Quantized positions and rotations of the entities of a snapshot, as structure of arrays.
+	struct QuantizedSnapshot {
+		std::vector<uint32_t> PositionX;
+		std::vector<uint32_t> PositionY;
+		std::vector<uint32_t> PositionZ;
+		//Smallest three: index of the largest component in the top 2 bits, then the three others.
+		std::vector<uint32_t> Rotation;
+
+		size_t Count() const;
+		void Resize(size_t count);
+	};
+
+	/*
+	 Entity state codec for replication.
+	 Positions are stored as fixed point over the box [Min, Max], in steps of Precision (coarser if a
+	 range would need more than 32 bits), clamped to the box. Rotations use the smallest three encoding:
+	 the index of the largest component (whose sign is made positive, q and -q being the same rotation)
+	 and the three others, which lie in [-1/sqrt(2), 1/sqrt(2)], on RotationBits bits each (at most 10).
+
+	 Encode writes a snapshot in full, or against a baseline both ends already have (the last snapshot
+	 the receiver acknowledged): each entity then costs a bit per unchanged rotation and position axis,
+	 and a changed axis is sent as a small zigzag delta when it fits in DeltaBits bits. Entities past the
+	 end of the baseline are sent in full. The baseline must be the same quantized snapshot on both ends.
+	*/
+	class SnapshotCodec {
+	public:
+		static constexpr int32_t DeltaBits = 7;
+
+		SnapshotCodec(Vector3 const& min, Vector3 const& max, double precision, int32_t rotationBits);
+
+		Vector3 Min() const;
+		Vector3 Max() const;
+		//Bits per axis of a full position, and per component of a rotation.
+		int32_t PositionBits(size_t axis) const;
+		int32_t RotationBits() const;
+
+		uint32_t QuantizePosition(double value, size_t axis) const;
+		double DequantizePosition(uint32_t value, size_t axis) const;
+		uint32_t QuantizeRotation(Quaternion const& rotation) const;
+		Quaternion DequantizeRotation(uint32_t value) const;
+
+		//Returns false if the arrays have different sizes.
+		bool Quantize(std::vector<Vector3> const& positions, std::vector<Quaternion> const& rotations, QuantizedSnapshot& result) const;
+		void Dequantize(QuantizedSnapshot const& snapshot, std::vector<Vector3>& positions, std::vector<Quaternion>& rotations) const;
+
+		//baseline may be null, for a full snapshot.
+		void Encode(QuantizedSnapshot const& snapshot, QuantizedSnapshot const* baseline, BitWriter& writer) const;
+		//Returns false if the data is truncated.
+		bool Decode(BitReader& reader, QuantizedSnapshot const* baseline, QuantizedSnapshot& result) const;
+
+	private:
+		double min[3];
+		double max[3];
+		double step[3];
+		double inverseStep[3];
+		uint32_t maxValue[3];
+		int32_t positionBits[3];
+		int32_t rotationBits;
+
+		void EncodeAxis(uint32_t value, uint32_t base, size_t axis, BitWriter& writer) const;
+		bool DecodeAxis(BitReader& reader, uint32_t base, size_t axis, uint32_t& value) const;
+	};
+}
+
+#endif
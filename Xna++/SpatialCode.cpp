@@ -0,0 +1,589 @@
+#include <algorithm>
+#include <cstring>
+#include "SpatialCode.hpp"
+#include "Parallel.hpp"
+#include "PodTypes.hpp"
+#include "Simd.hpp"
+
+//pdep and pext are 64 bit only. MSVC has no flag for BMI2 alone; every AVX2 processor has it.
+#if (defined(_M_X64) || defined(__x86_64__)) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#include <immintrin.h>
+#define XNA_BMI2
+#endif
+
+namespace Xna {
+
+	//Bit 0 of every axis, then bit 1, and so on.
+	static constexpr uint64_t Mask2 = 0x5555555555555555;
+	static constexpr uint64_t Mask3 = 0x1249249249249249;
+	static constexpr double MaxCode2 = 4294967295.0;
+	static constexpr double MaxCode3 = 2097151.0;
+
+	//Codes handed to each thread at least.
+	static constexpr size_t CodeGrain = 16384;
+	static constexpr size_t SortGrain = 65536;
+	static constexpr size_t RadixBits = 8;
+	static constexpr size_t RadixBuckets = size_t(1) << RadixBits;
+
+	//Spreads the bits of v so that each is followed by one (Spread2) or two (Spread3) zero bits.
+	static uint64_t Spread2(uint32_t v) {
+#ifdef XNA_BMI2
+		return _pdep_u64(v, Mask2);
+#else
+		uint64_t x = v;
+		x = (x | (x << 16)) & 0x0000ffff0000ffff;
+		x = (x | (x << 8)) & 0x00ff00ff00ff00ff;
+		x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0f;
+		x = (x | (x << 2)) & 0x3333333333333333;
+		x = (x | (x << 1)) & Mask2;
+		return x;
+#endif
+	}
+
+	static uint64_t Spread3(uint32_t v) {
+#ifdef XNA_BMI2
+		return _pdep_u64(v, Mask3);
+#else
+		uint64_t x = v & 0x1fffff;
+		x = (x | (x << 32)) & 0x001f00000000ffff;
+		x = (x | (x << 16)) & 0x001f0000ff0000ff;
+		x = (x | (x << 8)) & 0x100f00f00f00f00f;
+		x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+		x = (x | (x << 2)) & Mask3;
+		return x;
+#endif
+	}
+
+	//Inverse of Spread2 and Spread3, ignoring the other bits.
+	static uint32_t Compact2(uint64_t code) {
+#ifdef XNA_BMI2
+		return static_cast<uint32_t>(_pext_u64(code, Mask2));
+#else
+		uint64_t x = code & Mask2;
+		x = (x | (x >> 1)) & 0x3333333333333333;
+		x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0f;
+		x = (x | (x >> 4)) & 0x00ff00ff00ff00ff;
+		x = (x | (x >> 8)) & 0x0000ffff0000ffff;
+		x = (x | (x >> 16)) & 0x00000000ffffffff;
+		return static_cast<uint32_t>(x);
+#endif
+	}
+
+	static uint32_t Compact3(uint64_t code) {
+#ifdef XNA_BMI2
+		return static_cast<uint32_t>(_pext_u64(code, Mask3));
+#else
+		uint64_t x = code & Mask3;
+		x = (x | (x >> 2)) & 0x10c30c30c30c30c3;
+		x = (x | (x >> 4)) & 0x100f00f00f00f00f;
+		x = (x | (x >> 8)) & 0x001f0000ff0000ff;
+		x = (x | (x >> 16)) & 0x001f00000000ffff;
+		x = (x | (x >> 32)) & 0x00000000001fffff;
+		return static_cast<uint32_t>(x);
+#endif
+	}
+
+	//One uint32 lane (Single) or, with SSE2, four (Quad), for the Hilbert transform of one or four cells at a time.
+	struct Single {
+		uint32_t Value;
+
+		static Single Set(uint32_t v) { return { v }; }
+		friend Single operator& (Single a, Single b) { return { a.Value & b.Value }; }
+		friend Single operator| (Single a, Single b) { return { a.Value | b.Value }; }
+		friend Single operator^ (Single a, Single b) { return { a.Value ^ b.Value }; }
+		//All bits set where a has the bit of 'bit' set.
+		static Single IsSet(Single a, Single bit) { return { 0u - ((a.Value & bit.Value) != 0 ? 1u : 0u) }; }
+		//v where mask is clear.
+		static Single AndNot(Single mask, Single v) { return { v.Value & ~mask.Value }; }
+	};
+
+#ifdef XNA_SIMD_SSE2
+	struct Quad {
+		__m128i Value;
+
+		static Quad Set(uint32_t v) { return { _mm_set1_epi32(static_cast<int32_t>(v)) }; }
+		static Quad Load(uint32_t const* p) { return { _mm_loadu_si128(reinterpret_cast<__m128i const*>(p)) }; }
+		void Store(uint32_t* p) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), Value); }
+		friend Quad operator& (Quad a, Quad b) { return { _mm_and_si128(a.Value, b.Value) }; }
+		friend Quad operator| (Quad a, Quad b) { return { _mm_or_si128(a.Value, b.Value) }; }
+		friend Quad operator^ (Quad a, Quad b) { return { _mm_xor_si128(a.Value, b.Value) }; }
+		static Quad IsSet(Quad a, Quad bit) { return { _mm_cmpeq_epi32(_mm_and_si128(a.Value, bit.Value), bit.Value) }; }
+		static Quad AndNot(Quad mask, Quad v) { return { _mm_andnot_si128(mask.Value, v.Value) }; }
+	};
+#endif
+
+	/*
+	 Skilling's transform ("Programming the Hilbert curve", 2004) between the coordinates of a cell and the
+	 transposed Hilbert index: bit b of axes[0], axes[1]... are, in that order, the next N bits of the index
+	 from the top. Written without branches on the coordinates, which are as good as random.
+	*/
+	template <size_t N, typename T>
+	static void AxesToTranspose(T* axes, int32_t bits) {
+		uint32_t top = uint32_t(1) << (bits - 1);
+
+		for (uint32_t q = top; q > 1; q >>= 1) {
+			T p = T::Set(q - 1);
+			T bit = T::Set(q);
+
+			for (size_t i = 0; i < N; i++) {
+				//Inverts the low bits of axes[0] if bit q of axes[i] is set, exchanges them otherwise.
+				T set = T::IsSet(axes[i], bit);
+				T t = T::AndNot(set, (axes[0] ^ axes[i]) & p);
+				axes[0] = axes[0] ^ ((p & set) | t);
+				axes[i] = axes[i] ^ t;
+			}
+		}
+
+		for (size_t i = 1; i < N; i++) {
+			axes[i] = axes[i] ^ axes[i - 1];
+		}
+
+		T t = T::Set(0);
+
+		for (uint32_t q = top; q > 1; q >>= 1) {
+			t = t ^ (T::Set(q - 1) & T::IsSet(axes[N - 1], T::Set(q)));
+		}
+
+		for (size_t i = 0; i < N; i++) {
+			axes[i] = axes[i] ^ t;
+		}
+	}
+
+	template <size_t N>
+	static void TransposeToAxes(uint32_t* axes, int32_t bits) {
+		uint32_t t = axes[N - 1] >> 1;
+
+		for (size_t i = N - 1; i > 0; i--) {
+			axes[i] ^= axes[i - 1];
+		}
+
+		axes[0] ^= t;
+
+		for (uint64_t q = 2; q != (uint64_t(1) << bits); q <<= 1) {
+			Single p = Single::Set(static_cast<uint32_t>(q - 1));
+			Single bit = Single::Set(static_cast<uint32_t>(q));
+
+			for (size_t i = N; i-- > 0;) {
+				Single set = Single::IsSet(Single{ axes[i] }, bit);
+				Single u = Single::AndNot(set, Single{ axes[0] ^ axes[i] } & p);
+				axes[0] ^= ((p & set) | u).Value;
+				axes[i] ^= u.Value;
+			}
+		}
+	}
+
+	//Code of a transposed Hilbert index: the first axis holds the top bit of each group, the last axis of a Morton code.
+	template <size_t N>
+	static uint64_t TransposeToCode(uint32_t const* axes);
+
+	template <>
+	uint64_t TransposeToCode<2>(uint32_t const* axes) {
+		return SpatialCode::Morton(axes[1], axes[0]);
+	}
+
+	template <>
+	uint64_t TransposeToCode<3>(uint32_t const* axes) {
+		return SpatialCode::Morton(axes[2], axes[1], axes[0]);
+	}
+
+	template <size_t N>
+	static uint64_t HilbertCode(uint32_t const* axes, int32_t bits) {
+		Single lanes[N];
+		uint32_t transposed[N];
+
+		for (size_t k = 0; k < N; k++) {
+			lanes[k] = Single::Set(axes[k]);
+		}
+
+		AxesToTranspose<N>(lanes, bits);
+
+		for (size_t k = 0; k < N; k++) {
+			transposed[k] = lanes[k].Value;
+		}
+
+		return TransposeToCode<N>(transposed);
+	}
+
+	/*
+	 Sets codes[i] to the Hilbert code of the cell that cell(i, axes) writes, for every item, split over
+	 threads. The transform runs on four cells at a time with SSE2: its steps depend on each other, so a
+	 single cell leaves most of the processor idle.
+	*/
+	template <size_t N, typename Cell>
+	static void EncodeHilbert(size_t count, int32_t bits, std::vector<uint64_t>& codes, Cell const& cell) {
+		codes.resize(count);
+		uint64_t* destination = codes.data();
+
+		Parallel::For(0, count, CodeGrain, [&](size_t first, size_t last) {
+			uint32_t axes[N];
+			size_t i = first;
+
+#ifdef XNA_SIMD_SSE2
+			for (; i + 4 <= last; i += 4) {
+				uint32_t lanes[N][4];
+				Quad quads[N];
+
+				for (size_t l = 0; l < 4; l++) {
+					cell(i + l, axes);
+
+					for (size_t k = 0; k < N; k++) {
+						lanes[k][l] = axes[k];
+					}
+				}
+
+				for (size_t k = 0; k < N; k++) {
+					quads[k] = Quad::Load(lanes[k]);
+				}
+
+				AxesToTranspose<N>(quads, bits);
+
+				for (size_t k = 0; k < N; k++) {
+					quads[k].Store(lanes[k]);
+				}
+
+				for (size_t l = 0; l < 4; l++) {
+					for (size_t k = 0; k < N; k++) {
+						axes[k] = lanes[k][l];
+					}
+
+					destination[i + l] = TransposeToCode<N>(axes);
+				}
+			}
+#endif
+			for (; i < last; i++) {
+				cell(i, axes);
+				destination[i] = HilbertCode<N>(axes, bits);
+			}
+		});
+	}
+
+	//Keeps the signed order: INT32_MIN maps to 0.
+	static uint32_t Unsigned(int32_t v) {
+		return static_cast<uint32_t>(v) ^ 0x80000000u;
+	}
+
+	//Quantizes from min with scale steps per unit, clamped to [0, maxCode].
+	static uint32_t Quantize(double value, double min, double scale, double maxCode) {
+		double scaled = (value - min) * scale;
+
+		if (!(scaled > 0)) {
+			return 0;
+		}
+
+		return scaled < maxCode ? static_cast<uint32_t>(scaled) : static_cast<uint32_t>(maxCode);
+	}
+
+	static double Scale(double min, double max, double maxCode) {
+		return max > min ? maxCode / (max - min) : 0.0;
+	}
+
+	//Sets codes[i] to encode(i) for every item, split over threads.
+	template <typename Encode>
+	static void EncodeAll(size_t count, std::vector<uint64_t>& codes, Encode const& encode) {
+		codes.resize(count);
+		uint64_t* destination = codes.data();
+
+		Parallel::For(0, count, CodeGrain, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) {
+				destination[i] = encode(i);
+			}
+		});
+	}
+
+	uint64_t SpatialCode::Morton(uint32_t x, uint32_t y) {
+		return Spread2(x) | (Spread2(y) << 1);
+	}
+
+	uint64_t SpatialCode::Morton(uint32_t x, uint32_t y, uint32_t z) {
+		return Spread3(x & 0x1fffff) | (Spread3(y & 0x1fffff) << 1) | (Spread3(z & 0x1fffff) << 2);
+	}
+
+	void SpatialCode::DecodeMorton(uint64_t code, uint32_t& x, uint32_t& y) {
+		x = Compact2(code);
+		y = Compact2(code >> 1);
+	}
+
+	void SpatialCode::DecodeMorton(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) {
+		x = Compact3(code);
+		y = Compact3(code >> 1);
+		z = Compact3(code >> 2);
+	}
+
+	uint64_t SpatialCode::Hilbert(uint32_t x, uint32_t y) {
+		uint32_t axes[2] = { x, y };
+		return HilbertCode<2>(axes, Bits2);
+	}
+
+	uint64_t SpatialCode::Hilbert(uint32_t x, uint32_t y, uint32_t z) {
+		uint32_t axes[3] = { x & 0x1fffff, y & 0x1fffff, z & 0x1fffff };
+		return HilbertCode<3>(axes, Bits3);
+	}
+
+	void SpatialCode::DecodeHilbert(uint64_t code, uint32_t& x, uint32_t& y) {
+		uint32_t axes[2];
+		DecodeMorton(code, axes[1], axes[0]);
+		TransposeToAxes<2>(axes, Bits2);
+		x = axes[0];
+		y = axes[1];
+	}
+
+	void SpatialCode::DecodeHilbert(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) {
+		uint32_t axes[3];
+		DecodeMorton(code, axes[2], axes[1], axes[0]);
+		TransposeToAxes<3>(axes, Bits3);
+		x = axes[0];
+		y = axes[1];
+		z = axes[2];
+	}
+
+	void SpatialCode::Morton(std::vector<Point> const& points, std::vector<uint64_t>& codes) {
+		Point const* p = points.data();
+
+		EncodeAll(points.size(), codes, [p](size_t i) {
+			return Morton(Unsigned(p[i].X), Unsigned(p[i].Y));
+		});
+	}
+
+	void SpatialCode::Morton(std::vector<Vector2> const& positions, Vector2 const& min, Vector2 const& max, std::vector<uint64_t>& codes) {
+		Vector2 const* p = positions.data();
+		double minX = min.X;
+		double minY = min.Y;
+		double scaleX = Scale(min.X, max.X, MaxCode2);
+		double scaleY = Scale(min.Y, max.Y, MaxCode2);
+
+		EncodeAll(positions.size(), codes, [=](size_t i) {
+			return Morton(Quantize(p[i].X, minX, scaleX, MaxCode2), Quantize(p[i].Y, minY, scaleY, MaxCode2));
+		});
+	}
+
+	void SpatialCode::Morton(std::vector<Vector3> const& positions, Vector3 const& min, Vector3 const& max, std::vector<uint64_t>& codes) {
+		Vector3 const* p = positions.data();
+		double minX = min.X;
+		double minY = min.Y;
+		double minZ = min.Z;
+		double scaleX = Scale(min.X, max.X, MaxCode3);
+		double scaleY = Scale(min.Y, max.Y, MaxCode3);
+		double scaleZ = Scale(min.Z, max.Z, MaxCode3);
+
+		EncodeAll(positions.size(), codes, [=](size_t i) {
+			return Morton(Quantize(p[i].X, minX, scaleX, MaxCode3), Quantize(p[i].Y, minY, scaleY, MaxCode3),
+				Quantize(p[i].Z, minZ, scaleZ, MaxCode3));
+		});
+	}
+
+	void SpatialCode::Hilbert(std::vector<Point> const& points, std::vector<uint64_t>& codes) {
+		Point const* p = points.data();
+
+		EncodeHilbert<2>(points.size(), Bits2, codes, [p](size_t i, uint32_t* axes) {
+			axes[0] = Unsigned(p[i].X);
+			axes[1] = Unsigned(p[i].Y);
+		});
+	}
+
+	void SpatialCode::Hilbert(std::vector<Vector2> const& positions, Vector2 const& min, Vector2 const& max, std::vector<uint64_t>& codes) {
+		Vector2 const* p = positions.data();
+		double minX = min.X;
+		double minY = min.Y;
+		double scaleX = Scale(min.X, max.X, MaxCode2);
+		double scaleY = Scale(min.Y, max.Y, MaxCode2);
+
+		EncodeHilbert<2>(positions.size(), Bits2, codes, [=](size_t i, uint32_t* axes) {
+			axes[0] = Quantize(p[i].X, minX, scaleX, MaxCode2);
+			axes[1] = Quantize(p[i].Y, minY, scaleY, MaxCode2);
+		});
+	}
+
+	void SpatialCode::Hilbert(std::vector<Vector3> const& positions, Vector3 const& min, Vector3 const& max, std::vector<uint64_t>& codes) {
+		Vector3 const* p = positions.data();
+		double minX = min.X;
+		double minY = min.Y;
+		double minZ = min.Z;
+		double scaleX = Scale(min.X, max.X, MaxCode3);
+		double scaleY = Scale(min.Y, max.Y, MaxCode3);
+		double scaleZ = Scale(min.Z, max.Z, MaxCode3);
+
+		EncodeHilbert<3>(positions.size(), Bits3, codes, [=](size_t i, uint32_t* axes) {
+			axes[0] = Quantize(p[i].X, minX, scaleX, MaxCode3);
+			axes[1] = Quantize(p[i].Y, minY, scaleY, MaxCode3);
+			axes[2] = Quantize(p[i].Z, minZ, scaleZ, MaxCode3);
+		});
+	}
+
+	/*
+	 Least significant digit first sort of count codes, with their order, from source into destination, over
+	 the digits that have varying bits. The digits of all passes are counted in one read; passes where every
+	 code has the same digit are skipped. Meant for ranges that fit in the cache.
+	*/
+	static void SortRange(uint64_t* sourceCodes, uint32_t* sourceOrder, uint64_t* destinationCodes, uint32_t* destinationOrder,
+		size_t count, uint64_t varying) {
+
+		static constexpr size_t Digits = 64 / RadixBits;
+		uint32_t counts[Digits][RadixBuckets] = {};
+		size_t shifts[Digits];
+		size_t passes = 0;
+
+		for (size_t i = 0; i < count; i++) {
+			uint64_t code = sourceCodes[i];
+
+			for (size_t d = 0; d < Digits; d++) {
+				counts[d][(code >> (d * RadixBits)) & (RadixBuckets - 1)]++;
+			}
+		}
+
+		for (size_t d = 0; d < Digits; d++) {
+			size_t shift = d * RadixBits;
+
+			if (((varying >> shift) & (RadixBuckets - 1)) != 0 && counts[d][(sourceCodes[0] >> shift) & (RadixBuckets - 1)] != count) {
+				shifts[passes++] = shift;
+			}
+		}
+
+		//An even number of passes starts from a copy, so that the last one writes to destination.
+		if (passes % 2 == 0) {
+			std::memcpy(destinationCodes, sourceCodes, count * sizeof(uint64_t));
+			std::memcpy(destinationOrder, sourceOrder, count * sizeof(uint32_t));
+			std::swap(sourceCodes, destinationCodes);
+			std::swap(sourceOrder, destinationOrder);
+		}
+
+		for (size_t p = 0; p < passes; p++) {
+			size_t shift = shifts[p];
+			uint32_t* next = counts[shift / RadixBits];
+			uint32_t total = 0;
+
+			for (size_t d = 0; d < RadixBuckets; d++) {
+				uint32_t c = next[d];
+				next[d] = total;
+				total += c;
+			}
+
+			for (size_t i = 0; i < count; i++) {
+				uint32_t to = next[(sourceCodes[i] >> shift) & (RadixBuckets - 1)]++;
+				destinationCodes[to] = sourceCodes[i];
+				destinationOrder[to] = sourceOrder[i];
+			}
+
+			std::swap(sourceCodes, destinationCodes);
+			std::swap(sourceOrder, destinationOrder);
+		}
+	}
+
+	/*
+	 One most significant digit pass, on the highest digit with varying bits, splits the codes into buckets
+	 that then sort on their own with SortRange, in the cache and on separate threads. The first pass cuts the
+	 codes into one block per thread, counts the digits of every block, turns the counts into the first
+	 destination of each block and digit (all blocks for digit 0, then for digit 1...), which keeps the sort
+	 stable, and scatters the blocks in parallel.
+	*/
+	bool SpatialCode::Sort(std::vector<uint64_t>& codes, std::vector<uint32_t>& order) {
+		size_t count = codes.size();
+
+		if (static_cast<uint64_t>(count) > uint64_t(1) << 32) {
+			return false;
+		}
+
+		order.resize(count);
+
+		size_t blocks = std::min(Parallel::ThreadCount(), std::max<size_t>(1, count / SortGrain));
+		size_t blockSize = (count + blocks - 1) / blocks;
+		std::vector<uint64_t> ors(blocks, 0);
+		std::vector<uint64_t> ands(blocks, ~uint64_t(0));
+		uint64_t* sourceCodes = codes.data();
+		uint32_t* sourceOrder = order.data();
+
+		Parallel::For(0, blocks, 1, [&](size_t first, size_t last) {
+			for (size_t b = first; b < last; b++) {
+				size_t end = std::min(count, (b + 1) * blockSize);
+
+				for (size_t i = b * blockSize; i < end; i++) {
+					sourceOrder[i] = static_cast<uint32_t>(i);
+					ors[b] |= sourceCodes[i];
+					ands[b] &= sourceCodes[i];
+				}
+			}
+		});
+
+		//Bits that differ between some codes; digits without any are already sorted.
+		uint64_t varying = 0;
+		uint64_t shared = ~uint64_t(0);
+
+		for (size_t b = 0; b < blocks; b++) {
+			varying |= ors[b];
+			shared &= ands[b];
+		}
+
+		varying &= ~shared;
+
+		if (varying == 0) {
+			return true;
+		}
+
+		size_t shift = 64 - RadixBits;
+
+		while (((varying >> shift) & (RadixBuckets - 1)) == 0) {
+			shift -= RadixBits;
+		}
+
+		UninitializedVector<uint64_t> codeScratch(count);
+		UninitializedVector<uint32_t> orderScratch(count);
+		std::vector<size_t> offsets(blocks * RadixBuckets);
+		std::vector<size_t> buckets(RadixBuckets + 1);
+		uint64_t* scratchCodes = codeScratch.data();
+		uint32_t* scratchOrder = orderScratch.data();
+
+		Parallel::For(0, blocks, 1, [&](size_t first, size_t last) {
+			for (size_t b = first; b < last; b++) {
+				size_t* counts = offsets.data() + b * RadixBuckets;
+				size_t end = std::min(count, (b + 1) * blockSize);
+
+				for (size_t i = b * blockSize; i < end; i++) {
+					counts[(sourceCodes[i] >> shift) & (RadixBuckets - 1)]++;
+				}
+			}
+		});
+
+		size_t total = 0;
+
+		for (size_t d = 0; d < RadixBuckets; d++) {
+			buckets[d] = total;
+
+			for (size_t b = 0; b < blocks; b++) {
+				size_t c = offsets[b * RadixBuckets + d];
+				offsets[b * RadixBuckets + d] = total;
+				total += c;
+			}
+		}
+
+		buckets[RadixBuckets] = total;
+
+		Parallel::For(0, blocks, 1, [&](size_t first, size_t last) {
+			for (size_t b = first; b < last; b++) {
+				size_t* next = offsets.data() + b * RadixBuckets;
+				size_t end = std::min(count, (b + 1) * blockSize);
+
+				for (size_t i = b * blockSize; i < end; i++) {
+					size_t to = next[(sourceCodes[i] >> shift) & (RadixBuckets - 1)]++;
+					scratchCodes[to] = sourceCodes[i];
+					scratchOrder[to] = sourceOrder[i];
+				}
+			}
+		});
+
+		//The top digit is sorted; the buckets sort back into codes and order.
+		uint64_t lower = shift > 0 ? varying & ((uint64_t(1) << shift) - 1) : 0;
+		size_t bucketGrain = std::max<size_t>(1, RadixBuckets * SortGrain / std::max(count, SortGrain));
+
+		Parallel::For(0, RadixBuckets, bucketGrain, [&](size_t first, size_t last) {
+			for (size_t d = first; d < last; d++) {
+				size_t begin = buckets[d];
+				size_t size = buckets[d + 1] - begin;
+
+				if (size > 0) {
+					SortRange(scratchCodes + begin, scratchOrder + begin, sourceCodes + begin, sourceOrder + begin, size, lower);
+				}
+			}
+		});
+
+		return true;
+	}
+}
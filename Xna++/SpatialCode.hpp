@@ -0,0 +1,73 @@
+#ifndef _SPATIALCODE_H_
+#define _SPATIALCODE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Point.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	/*
+	 Space filling curve codes, to lay out and visit spatial data so that items close in space are close
+	 in memory. Morton (Z-order) codes interleave the bits of the coordinates; Hilbert codes follow a
+	 curve without the long jumps of the Z, so consecutive codes are always neighbouring cells, at the
+	 cost of a few more operations per code.
+
+	 2D codes take 32 bits per axis and 3D codes 21, both in a uint64. The interleaving uses the BMI2
+	 pdep and pext instructions when the compiler targets them (-mbmi2, or /arch:AVX2 with MSVC) and
+	 shifts with magic masks otherwise. Hilbert codes go through Skilling's transpose, then the same
+	 interleaving; the batch methods run the transform on four cells at a time with SSE2.
+
+	 The batch methods split their work over Parallel::For. Point coordinates are offset so that their
+	 signed order is kept; Vector2 and Vector3 coordinates are quantized over the box [min, max], and
+	 clamped to it. Sort orders items by code with a parallel radix sort, so that arrays can be gathered
+	 in curve order.
+	*/
+	class SpatialCode {
+	public:
+		static constexpr int32_t Bits2 = 32;
+		static constexpr int32_t Bits3 = 21;
+
+		static uint64_t Morton(uint32_t x, uint32_t y);
+		//Only the low Bits3 bits of each coordinate are used.
+		static uint64_t Morton(uint32_t x, uint32_t y, uint32_t z);
+		static void DecodeMorton(uint64_t code, uint32_t& x, uint32_t& y);
+		static void DecodeMorton(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z);
+
+		static uint64_t Hilbert(uint32_t x, uint32_t y);
+		//Only the low Bits3 bits of each coordinate are used.
+		static uint64_t Hilbert(uint32_t x, uint32_t y, uint32_t z);
+		static void DecodeHilbert(uint64_t code, uint32_t& x, uint32_t& y);
+		static void DecodeHilbert(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z);
+
+		//codes is resized to the number of items.
+		static void Morton(std::vector<Point> const& points, std::vector<uint64_t>& codes);
+		static void Morton(std::vector<Vector2> const& positions, Vector2 const& min, Vector2 const& max, std::vector<uint64_t>& codes);
+		static void Morton(std::vector<Vector3> const& positions, Vector3 const& min, Vector3 const& max, std::vector<uint64_t>& codes);
+		static void Hilbert(std::vector<Point> const& points, std::vector<uint64_t>& codes);
+		static void Hilbert(std::vector<Vector2> const& positions, Vector2 const& min, Vector2 const& max, std::vector<uint64_t>& codes);
+		static void Hilbert(std::vector<Vector3> const& positions, Vector3 const& min, Vector3 const& max, std::vector<uint64_t>& codes);
+
+		/*
+		 Sorts the codes in place, stable, and sets order[i] to the index the i-th sorted code had.
+		 Bytes that every code shares are skipped, so codes over a few bits sort in a pass or two.
+		 Returns false if there are more than 2^32 codes.
+		*/
+		static bool Sort(std::vector<uint64_t>& codes, std::vector<uint32_t>& order);
+
+		//result[i] = items[order[i]], to lay items out in the order given by Sort.
+		template <typename T>
+		static void Gather(std::vector<T> const& items, std::vector<uint32_t> const& order, std::vector<T>& result) {
+			result.resize(order.size());
+
+			for (size_t i = 0; i < order.size(); i++) {
+				result[i] = items[order[i]];
+			}
+		}
+	};
+}
+
+#endif
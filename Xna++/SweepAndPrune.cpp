@@ -0,0 +1,417 @@
+#include <algorithm>
+#include "SweepAndPrune.hpp"
+#include "Parallel.hpp"
+
+namespace Xna {
+
+	//Endpoints below which the axes are sorted on the calling thread.
+	static constexpr size_t ParallelEndpoints = 8192;
+
+	static uint64_t PairKey(uint32_t a, uint32_t b) {
+		return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+	}
+
+	//Endpoint order: by value, and a min before a max of the same value so that touching boxes overlap.
+	static bool Before(double value1, uint32_t id1, double value2, uint32_t id2) {
+		return value1 < value2 || (value1 == value2 && (id1 & 1) < (id2 & 1));
+	}
+
+	/*
+	 Boxes open at the current endpoint of the sweep along X, with their Y and Z bounds side by side so that
+	 testing a box against all of them reads contiguous arrays. Open boxes always overlap the new one on X.
+	*/
+	struct OpenBoxes {
+		std::vector<uint32_t> Proxies;
+		std::vector<double> Bounds[4];
+		std::vector<uint32_t> Slots;
+
+		void Add(uint32_t proxy, double minY, double maxY, double minZ, double maxZ) {
+			Slots[proxy] = static_cast<uint32_t>(Proxies.size());
+			Proxies.push_back(proxy);
+			Bounds[0].push_back(minY);
+			Bounds[1].push_back(maxY);
+			Bounds[2].push_back(minZ);
+			Bounds[3].push_back(maxZ);
+		}
+
+		void Remove(uint32_t proxy) {
+			size_t slot = Slots[proxy];
+			Slots[Proxies.back()] = static_cast<uint32_t>(slot);
+			Proxies[slot] = Proxies.back();
+			Proxies.pop_back();
+
+			for (size_t b = 0; b < 4; b++) {
+				Bounds[b][slot] = Bounds[b].back();
+				Bounds[b].pop_back();
+			}
+		}
+	};
+
+	SweepAndPrune::SweepAndPrune() {
+	}
+
+	size_t SweepAndPrune::Count() const {
+		return count;
+	}
+
+	uint32_t SweepAndPrune::Add(Vector3 const& min, Vector3 const& max) {
+		uint32_t proxy;
+
+		if (!freeProxies.empty()) {
+			proxy = freeProxies.back();
+			freeProxies.pop_back();
+		}
+		else {
+			proxy = static_cast<uint32_t>(states.size());
+			states.push_back(ProxyState::Free);
+			pairCounts.push_back(0);
+			boxes.push_back(Box());
+		}
+
+		states[proxy] = ProxyState::New;
+		newProxies.push_back(proxy);
+		count++;
+		SetBounds(proxy, min, max);
+
+		return proxy;
+	}
+
+	bool SweepAndPrune::Remove(uint32_t proxy) {
+		if (proxy >= states.size() || (states[proxy] != ProxyState::New && states[proxy] != ProxyState::Live)) {
+			return false;
+		}
+
+		states[proxy] = ProxyState::Dead;
+		deadProxies.push_back(proxy);
+		count--;
+
+		return true;
+	}
+
+	bool SweepAndPrune::SetBounds(uint32_t proxy, Vector3 const& min, Vector3 const& max) {
+		if (proxy >= states.size() || (states[proxy] != ProxyState::New && states[proxy] != ProxyState::Live)) {
+			return false;
+		}
+
+		Box& box = boxes[proxy];
+		box.Min[0] = min.X;
+		box.Min[1] = min.Y;
+		box.Min[2] = min.Z;
+		box.Max[0] = max.X;
+		box.Max[1] = max.Y;
+		box.Max[2] = max.Z;
+
+		return true;
+	}
+
+	bool SweepAndPrune::GetBounds(uint32_t proxy, Vector3& min, Vector3& max) const {
+		if (proxy >= states.size() || (states[proxy] != ProxyState::New && states[proxy] != ProxyState::Live)) {
+			return false;
+		}
+
+		Box const& box = boxes[proxy];
+		min = Vector3(box.Min[0], box.Min[1], box.Min[2]);
+		max = Vector3(box.Max[0], box.Max[1], box.Max[2]);
+
+		return true;
+	}
+
+	void SweepAndPrune::Update() {
+		addedPairs.clear();
+		removedPairs.clear();
+
+		if (!deadProxies.empty()) {
+			ProxyState const* state = states.data();
+
+			for (size_t k = 0; k < 3; k++) {
+				Axis& axis = axes[k];
+				size_t kept = 0;
+
+				for (size_t i = 0; i < axis.Ids.size(); i++) {
+					if (state[axis.Ids[i] >> 1] != ProxyState::Dead) {
+						axis.Values[kept] = axis.Values[i];
+						axis.Ids[kept] = axis.Ids[i];
+						kept++;
+					}
+				}
+
+				axis.Values.resize(kept);
+				axis.Ids.resize(kept);
+			}
+
+			//RemovePair moves the last pair into the removed one's place, so the index only moves past kept pairs.
+			for (size_t i = 0; i < pairs.size();) {
+				if (state[pairs[i].First] == ProxyState::Dead || state[pairs[i].Second] == ProxyState::Dead) {
+					RemovePair(PairKey(pairs[i].First, pairs[i].Second));
+				}
+				else {
+					i++;
+				}
+			}
+
+			for (uint32_t proxy : deadProxies) {
+				states[proxy] = ProxyState::Free;
+				freeProxies.push_back(proxy);
+			}
+
+			deadProxies.clear();
+		}
+
+		//A grain of 3 keeps the three axes on one range, and so on the calling thread.
+		size_t grain = axes[0].Ids.size() < ParallelEndpoints ? 3 : 1;
+
+		Parallel::For(0, 3, grain, [this](size_t first, size_t last) {
+			for (size_t k = first; k < last; k++) {
+				SortAxis(k);
+			}
+		});
+
+		for (size_t k = 0; k < 3; k++) {
+			for (uint64_t key : axes[k].Ends) {
+				RemovePair(key);
+			}
+		}
+
+		for (size_t k = 0; k < 3; k++) {
+			for (uint64_t key : axes[k].Starts) {
+				AddPair(key);
+			}
+		}
+
+		InsertNew();
+	}
+
+	std::vector<OverlapPair> const& SweepAndPrune::Pairs() const {
+		return pairs;
+	}
+
+	std::vector<OverlapPair> const& SweepAndPrune::Added() const {
+		return addedPairs;
+	}
+
+	std::vector<OverlapPair> const& SweepAndPrune::Removed() const {
+		return removedPairs;
+	}
+
+	bool SweepAndPrune::Overlaps(Box const& first, Box const& second) {
+		return first.Min[0] <= second.Max[0] && second.Min[0] <= first.Max[0]
+			&& first.Min[1] <= second.Max[1] && second.Min[1] <= first.Max[1]
+			&& first.Min[2] <= second.Max[2] && second.Min[2] <= first.Max[2];
+	}
+
+	/*
+	 Refreshes the endpoint values of an axis from the boxes and restores their order. A min moving down past
+	 the max of another box starts their overlap on this axis, and starts the pair if the boxes now overlap
+	 on all three; a max moving down past a min ends it, which is only worth looking up when both proxies
+	 have pairs. Every pair of endpoints that changed order is swapped exactly once, so the events match the
+	 final boxes whatever the other axes report. Writes only to its axis, and the boxes and pair counts it
+	 reads do not change while sorting, so the axes can sort at the same time.
+	*/
+	void SweepAndPrune::SortAxis(size_t k) {
+		Axis& axis = axes[k];
+		size_t n = axis.Ids.size();
+		double* values = axis.Values.data();
+		uint32_t* ids = axis.Ids.data();
+		Box const* box = boxes.data();
+
+		axis.Starts.clear();
+		axis.Ends.clear();
+
+		for (size_t i = 0; i < n; i++) {
+			Box const& b = box[ids[i] >> 1];
+			values[i] = (ids[i] & 1) != 0 ? b.Max[k] : b.Min[k];
+		}
+
+		axis.Crossed.resize(n);
+		uint32_t* crossed = axis.Crossed.data();
+
+		for (size_t i = 1; i < n; i++) {
+			double value = values[i];
+			uint32_t id = ids[i];
+			uint32_t proxy = id >> 1;
+			size_t j = i;
+			size_t count = 0;
+
+			//Endpoints of the other kind are kept without a branch: which kind comes next is a coin toss.
+			while (j > 0 && Before(value, id, values[j - 1], ids[j - 1])) {
+				uint32_t other = ids[j - 1];
+				crossed[count] = other >> 1;
+				count += (id ^ other) & 1;
+				values[j] = values[j - 1];
+				ids[j] = other;
+				j--;
+			}
+
+			values[j] = value;
+			ids[j] = id;
+
+			if (count == 0) {
+				continue;
+			}
+
+			if ((id & 1) == 0) {
+				Box const moved = box[proxy];
+
+				for (size_t c = 0; c < count; c++) {
+					if (crossed[c] != proxy && Overlaps(moved, box[crossed[c]])) {
+						axis.Starts.push_back(PairKey(proxy, crossed[c]));
+					}
+				}
+			}
+			else if (pairCounts[proxy] != 0) {
+				for (size_t c = 0; c < count; c++) {
+					if (crossed[c] != proxy && pairCounts[crossed[c]] != 0) {
+						axis.Ends.push_back(PairKey(proxy, crossed[c]));
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	 Sorts the endpoints of the new proxies and merges them into every axis, then sweeps X with the list of
+	 boxes open at each endpoint: a new box is tested against every open box, an old one only against the
+	 open new boxes, so that each pair with a new proxy is tested once.
+	*/
+	void SweepAndPrune::InsertNew() {
+		std::vector<uint32_t> fresh;
+		std::vector<uint8_t> isNew(states.size(), 0);
+
+		for (uint32_t proxy : newProxies) {
+			if (states[proxy] == ProxyState::New) {
+				states[proxy] = ProxyState::Live;
+				fresh.push_back(proxy);
+				isNew[proxy] = 1;
+			}
+		}
+
+		newProxies.clear();
+
+		if (fresh.empty()) {
+			return;
+		}
+
+		size_t grain = axes[0].Ids.size() + 2 * fresh.size() < ParallelEndpoints ? 3 : 1;
+
+		Parallel::For(0, 3, grain, [&](size_t first, size_t last) {
+			for (size_t k = first; k < last; k++) {
+				Axis& axis = axes[k];
+				std::vector<std::pair<double, uint32_t>> endpoints;
+				endpoints.reserve(2 * fresh.size());
+
+				for (uint32_t proxy : fresh) {
+					endpoints.emplace_back(boxes[proxy].Min[k], proxy * 2);
+					endpoints.emplace_back(boxes[proxy].Max[k], proxy * 2 + 1);
+				}
+
+				std::sort(endpoints.begin(), endpoints.end(), [](std::pair<double, uint32_t> const& a, std::pair<double, uint32_t> const& b) {
+					return Before(a.first, a.second, b.first, b.second);
+				});
+
+				size_t old = axis.Ids.size();
+				std::vector<double> values(old + endpoints.size());
+				std::vector<uint32_t> merged(old + endpoints.size());
+				size_t i = 0;
+				size_t j = 0;
+
+				for (size_t m = 0; m < merged.size(); m++) {
+					if (j == endpoints.size() || (i < old && !Before(endpoints[j].first, endpoints[j].second, axis.Values[i], axis.Ids[i]))) {
+						values[m] = axis.Values[i];
+						merged[m] = axis.Ids[i++];
+					}
+					else {
+						values[m] = endpoints[j].first;
+						merged[m] = endpoints[j++].second;
+					}
+				}
+
+				axis.Values.swap(values);
+				axis.Ids.swap(merged);
+			}
+		});
+
+		OpenBoxes open;
+		OpenBoxes openNew;
+		std::vector<uint32_t> overlapping;
+
+		open.Slots.resize(states.size());
+		openNew.Slots.resize(states.size());
+
+		for (uint32_t id : axes[0].Ids) {
+			uint32_t proxy = id >> 1;
+
+			if ((id & 1) != 0) {
+				open.Remove(proxy);
+
+				if (isNew[proxy]) {
+					openNew.Remove(proxy);
+				}
+
+				continue;
+			}
+
+			OpenBoxes const& candidates = isNew[proxy] ? open : openNew;
+			double const* bounds[4] = { candidates.Bounds[0].data(), candidates.Bounds[1].data(), candidates.Bounds[2].data(), candidates.Bounds[3].data() };
+			uint32_t const* proxies = candidates.Proxies.data();
+			size_t size = candidates.Proxies.size();
+			double y0 = boxes[proxy].Min[1];
+			double y1 = boxes[proxy].Max[1];
+			double z0 = boxes[proxy].Min[2];
+			double z1 = boxes[proxy].Max[2];
+			size_t found = 0;
+
+			overlapping.resize(size);
+
+			//Without a branch per open box: most of them do not overlap, but not predictably.
+			for (size_t i = 0; i < size; i++) {
+				overlapping[found] = proxies[i];
+				found += (bounds[0][i] <= y1) & (y0 <= bounds[1][i]) & (bounds[2][i] <= z1) & (z0 <= bounds[3][i]);
+			}
+
+			for (size_t i = 0; i < found; i++) {
+				AddPair(PairKey(proxy, overlapping[i]));
+			}
+
+			open.Add(proxy, y0, y1, z0, z1);
+
+			if (isNew[proxy]) {
+				openNew.Add(proxy, y0, y1, z0, z1);
+			}
+		}
+	}
+
+	void SweepAndPrune::AddPair(uint64_t key) {
+		if (pairIndices.Insert(key, static_cast<uint32_t>(pairs.size()))) {
+			OverlapPair pair;
+			pair.First = static_cast<uint32_t>(key >> 32);
+			pair.Second = static_cast<uint32_t>(key);
+			pairs.push_back(pair);
+			addedPairs.push_back(pair);
+			pairCounts[pair.First]++;
+			pairCounts[pair.Second]++;
+		}
+	}
+
+	void SweepAndPrune::RemovePair(uint64_t key) {
+		uint32_t index;
+
+		if (!pairIndices.TryGetValue(key, index)) {
+			return;
+		}
+
+		OverlapPair pair = pairs[index];
+		OverlapPair last = pairs.back();
+
+		pairIndices.Remove(key);
+		pairs.pop_back();
+
+		if (index < pairs.size()) {
+			pairs[index] = last;
+			pairIndices[PairKey(last.First, last.Second)] = index;
+		}
+
+		removedPairs.push_back(pair);
+		pairCounts[pair.First]--;
+		pairCounts[pair.Second]--;
+	}
+}
@@ -0,0 +1,105 @@
+#ifndef _SWEEPANDPRUNE_H_
+#define _SWEEPANDPRUNE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FlatHashMap.hpp"
+#include "Vector3.hpp"
+
+namespace Xna {
+
+	//Two proxies whose boxes overlap, First < Second.
+	struct OverlapPair {
+		uint32_t First{ 0 };
+		uint32_t Second{ 0 };
+	};
+
+	/*
+	 Sort and sweep broad phase over axis aligned boxes given by their min and max corners, for scenes where
+	 most boxes move a little every frame. Instead of rebuilding a tree, every axis keeps the endpoints of
+	 the boxes sorted, and Update restores the order with an insertion sort: with coherent motion each
+	 endpoint only moves past a few others. An overlap can only start or end where a min passes a max, so
+	 those swaps are the only place where pairs are tested, and the overlapping pairs are kept from frame
+	 to frame. The three axes are sorted on separate threads (Parallel::For).
+
+	 Boxes added since the last Update are merged into the sorted axes in one go, and their pairs found with
+	 a sweep along X, so building a scene by adding every box and updating once costs a full sort and sweep,
+	 not insertion sorts. Boxes touching on a face overlap.
+
+	 Proxies are indices, reused after the Update that follows their removal. Changes to the boxes take
+	 effect at the next Update, which reports the pairs that started and stopped overlapping since the
+	 previous one.
+	*/
+	class SweepAndPrune {
+	public:
+		SweepAndPrune();
+
+		//Number of live proxies, counting the ones added since the last Update.
+		size_t Count() const;
+
+		uint32_t Add(Vector3 const& min, Vector3 const& max);
+		//Returns false if the proxy is not live.
+		bool Remove(uint32_t proxy);
+		bool SetBounds(uint32_t proxy, Vector3 const& min, Vector3 const& max);
+		bool GetBounds(uint32_t proxy, Vector3& min, Vector3& max) const;
+
+		//Brings the pairs up to date with the boxes, filling Added and Removed.
+		void Update();
+
+		//Overlapping pairs as of the last Update, in no particular order.
+		std::vector<OverlapPair> const& Pairs() const;
+		//Pairs that started and stopped overlapping in the last Update; a removed proxy stops all its pairs.
+		std::vector<OverlapPair> const& Added() const;
+		std::vector<OverlapPair> const& Removed() const;
+
+	private:
+		enum class ProxyState : uint8_t {
+			Free,
+			New,
+			Live,
+			Dead
+		};
+
+		//Endpoints of an axis in order: values and ids (proxy * 2, plus 1 for a max).
+		struct Axis {
+			std::vector<double> Values;
+			std::vector<uint32_t> Ids;
+			//Pair keys whose overlap started and ended on this axis during the last insertion sort.
+			std::vector<uint64_t> Starts;
+			std::vector<uint64_t> Ends;
+			//Proxies of the other kind of endpoint passed by the one being inserted.
+			std::vector<uint32_t> Crossed;
+		};
+
+		//Corners of a box, together so that testing a pair reads one cache line per box.
+		struct Box {
+			double Min[3];
+			double Max[3];
+		};
+
+		std::vector<Box> boxes;
+		std::vector<ProxyState> states;
+		//Overlapping pairs of each proxy, to skip looking up pairs that cannot exist.
+		std::vector<uint32_t> pairCounts;
+		std::vector<uint32_t> freeProxies;
+		//Proxies added and removed since the last Update.
+		std::vector<uint32_t> newProxies;
+		std::vector<uint32_t> deadProxies;
+		Axis axes[3];
+		//Pair key (First << 32 | Second) to index in pairs.
+		FlatHashMap<uint64_t, uint32_t> pairIndices;
+		std::vector<OverlapPair> pairs;
+		std::vector<OverlapPair> addedPairs;
+		std::vector<OverlapPair> removedPairs;
+		size_t count{ 0 };
+
+		static bool Overlaps(Box const& first, Box const& second);
+		void SortAxis(size_t axis);
+		void InsertNew();
+		void AddPair(uint64_t key);
+		void RemovePair(uint64_t key);
+	};
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include "ThreadPool.hpp"
+#include "Parallel.hpp"
+
+namespace Xna {
+
+	//The pool and deque of the current thread; deque 0 belongs to the caller of Wait.
+	static thread_local ThreadPool* currentPool = nullptr;
+	static thread_local size_t currentIndex = 0;
+
+	ThreadPool::ThreadPool(size_t threadCount) {
+		if (threadCount == 0) {
+			threadCount = Parallel::ThreadCount();
+		}
+
+		for (size_t i = 0; i < threadCount; i++) {
+			queues.emplace_back(new Queue());
+		}
+
+		workers.reserve(threadCount - 1);
+
+		for (size_t i = 1; i < threadCount; i++) {
+			workers.emplace_back(&ThreadPool::Work, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+
+		wake.notify_all();
+
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	size_t ThreadPool::ThreadCount() const {
+		return queues.size();
+	}
+
+	void ThreadPool::Submit(std::function<void()> task) {
+		size_t index = currentPool == this ? currentIndex : 0;
+		pending.fetch_add(1, std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> lock(queues[index]->Mutex);
+			queues[index]->Tasks.push_back(std::move(task));
+		}
+
+		//Counted under the mutex, so that a thread about to sleep sees it.
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			queued.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		wake.notify_one();
+	}
+
+	void ThreadPool::Wait() {
+		ThreadPool* previousPool = currentPool;
+		size_t previousIndex = currentIndex;
+		currentPool = this;
+		currentIndex = 0;
+
+		std::function<void()> task;
+
+		while (pending.load(std::memory_order_acquire) != 0) {
+			if (TryTake(0, task)) {
+				Run(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] {
+				return queued.load(std::memory_order_relaxed) != 0 || pending.load(std::memory_order_acquire) == 0;
+			});
+		}
+
+		currentPool = previousPool;
+		currentIndex = previousIndex;
+	}
+
+	bool ThreadPool::RunPending() {
+		size_t index = currentPool == this ? currentIndex : 0;
+		std::function<void()> task;
+
+		if (!TryTake(index, task)) {
+			return false;
+		}
+
+		Run(task);
+		return true;
+	}
+
+	void ThreadPool::Work(size_t index) {
+		currentPool = this;
+		currentIndex = index;
+
+		std::function<void()> task;
+
+		while (true) {
+			if (TryTake(index, task)) {
+				Run(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_relaxed) != 0; });
+
+			if (stopping) {
+				return;
+			}
+		}
+	}
+
+	//The newest task of the own deque, else the oldest of the next non empty one.
+	bool ThreadPool::TryTake(size_t index, std::function<void()>& task) {
+		size_t count = queues.size();
+
+		for (size_t i = 0; i < count; i++) {
+			Queue& queue = *queues[(index + i) % count];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+
+			if (queue.Tasks.empty()) {
+				continue;
+			}
+
+			if (i == 0) {
+				task = std::move(queue.Tasks.back());
+				queue.Tasks.pop_back();
+			}
+			else {
+				task = std::move(queue.Tasks.front());
+				queue.Tasks.pop_front();
+			}
+
+			queued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		return false;
+	}
+
+	void ThreadPool::Run(std::function<void()>& task) {
+		task();
+		task = nullptr;
+
+		if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			//Wakes the caller of Wait.
+			std::lock_guard<std::mutex> lock(mutex);
+			wake.notify_all();
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Xna {
+
+	/*
+	 Persistent worker threads with one task deque each. A worker runs its own tasks newest first (so a task
+	 submitted by a running task stays on the same core) and, when it runs dry, steals the oldest task of
+	 another deque. Workers sleep while no task is queued.
+	 Wait makes the calling thread run tasks too, so a pool of ThreadCount() threads starts
+	 ThreadCount() - 1 workers. Tasks may Submit more tasks but must not call Wait.
+	*/
+	class ThreadPool {
+	public:
+		//0 uses Parallel::ThreadCount().
+		ThreadPool(size_t threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator= (ThreadPool const&) = delete;
+
+		//Workers plus the thread calling Wait.
+		size_t ThreadCount() const;
+
+		//From a task, queues on the deque of the current thread; otherwise on the deque of the caller of Wait.
+		void Submit(std::function<void()> task);
+		//Runs tasks until every submitted task, and the tasks they submitted, have finished.
+		void Wait();
+		/*
+		 Runs one queued task on the calling thread, taken as Wait would, and returns false if none is
+		 queued. Lets a thread waiting on some of the tasks help, where Wait would wait for all of them.
+		*/
+		bool RunPending();
+
+	private:
+		struct Queue {
+			std::mutex Mutex;
+			std::deque<std::function<void()>> Tasks;
+		};
+
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake;
+		//Tasks in the queues, and tasks submitted but not finished.
+		std::atomic<size_t> queued{ 0 };
+		std::atomic<size_t> pending{ 0 };
+		bool stopping{ false };
+
+		void Work(size_t index);
+		bool TryTake(size_t index, std::function<void()>& task);
+		void Run(std::function<void()>& task);
+	};
+}
+
+#endif
@@ -316,8 +316,42 @@ namespace Xna {
 		return X == other.X && Y == other.Y;
 	}
 
-	Vector2 Vector2::operator- (Vector2 v) {
-		return Vector2::Negate(v);
+	Vector2 Vector2::operator- () const {
+		return Vector2::Negate(*this);
+	}
+
+	Vector2& Vector2::operator+= (Vector2 const& v) {
+		X += v.X;
+		Y += v.Y;
+		return *this;
+	}
+
+	Vector2& Vector2::operator-= (Vector2 const& v) {
+		X -= v.X;
+		Y -= v.Y;
+		return *this;
+	}
+
+	Vector2& Vector2::operator*= (Vector2 const& v) {
+		X *= v.X;
+		Y *= v.Y;
+		return *this;
+	}
+
+	Vector2& Vector2::operator*= (double d) {
+		X *= d;
+		Y *= d;
+		return *this;
+	}
+
+	Vector2& Vector2::operator/= (Vector2 const& v) {
+		*this = Vector2::Divide(*this, v);
+		return *this;
+	}
+
+	Vector2& Vector2::operator/= (double d) {
+		*this = Vector2::Divide(*this, d);
+		return *this;
 	}
 
 	Vector2 operator+ (Vector2 v1, Vector2 v2) {
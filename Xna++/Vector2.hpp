@@ -2,7 +2,9 @@
 #define _VECTOR2_H_
 
 #include <cstdint>
+#include <functional>
 #include <vector>
+#include "Hash.hpp"
 
 namespace Xna {
 
@@ -26,7 +28,13 @@ namespace Xna {
 		static const Vector2 UnitX;
 		static const Vector2 UnitY;
 
-		Vector2 operator- (Vector2);
+		Vector2 operator- () const;
+		Vector2& operator+= (Vector2 const&);
+		Vector2& operator-= (Vector2 const&);
+		Vector2& operator*= (Vector2 const&);
+		Vector2& operator*= (double);
+		Vector2& operator/= (Vector2 const&);
+		Vector2& operator/= (double);
 		friend Vector2 operator+ (Vector2, Vector2);
 		friend Vector2 operator- (Vector2, Vector2);
 		friend Vector2 operator* (Vector2, Vector2);
@@ -98,4 +106,15 @@ namespace Xna {
 	};
 }
 
+namespace std {
+	template <>
+	struct hash<Xna::Vector2> {
+		size_t operator()(Xna::Vector2 const& v) const noexcept {
+			return static_cast<size_t>(Xna::Hash::Combine(
+				Xna::Hash::Mix(Xna::Hash::OfDouble(v.X)),
+				Xna::Hash::OfDouble(v.Y)));
+		}
+	};
+}
+
 #endif
@@ -348,8 +348,46 @@ namespace Xna {
 			&& Z == other.Z;
 	}
 
-	Vector3 Vector3::operator- (Vector3 v) {
-		return Vector3::Negate(v);
+	Vector3 Vector3::operator- () const {
+		return Vector3::Negate(*this);
+	}
+
+	Vector3& Vector3::operator+= (Vector3 const& v) {
+		X += v.X;
+		Y += v.Y;
+		Z += v.Z;
+		return *this;
+	}
+
+	Vector3& Vector3::operator-= (Vector3 const& v) {
+		X -= v.X;
+		Y -= v.Y;
+		Z -= v.Z;
+		return *this;
+	}
+
+	Vector3& Vector3::operator*= (Vector3 const& v) {
+		X *= v.X;
+		Y *= v.Y;
+		Z *= v.Z;
+		return *this;
+	}
+
+	Vector3& Vector3::operator*= (double d) {
+		X *= d;
+		Y *= d;
+		Z *= d;
+		return *this;
+	}
+
+	Vector3& Vector3::operator/= (Vector3 const& v) {
+		*this = Vector3::Divide(*this, v);
+		return *this;
+	}
+
+	Vector3& Vector3::operator/= (double d) {
+		*this = Vector3::Divide(*this, d);
+		return *this;
 	}
 
 	Vector3 operator+ (Vector3 v1, Vector3 v2) {
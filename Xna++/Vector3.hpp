@@ -1,7 +1,9 @@
 #ifndef _VECTOR3_H_
 #define _VECTOR3_H_
 
+#include <functional>
 #include <vector>
+#include "Hash.hpp"
 
 namespace Xna {
 
@@ -32,7 +34,13 @@ namespace Xna {
 		static const Vector3 Forward;
 		static const Vector3 Backward;
 
-		Vector3 operator- (Vector3);
+		Vector3 operator- () const;
+		Vector3& operator+= (Vector3 const&);
+		Vector3& operator-= (Vector3 const&);
+		Vector3& operator*= (Vector3 const&);
+		Vector3& operator*= (double);
+		Vector3& operator/= (Vector3 const&);
+		Vector3& operator/= (double);
 		friend Vector3 operator+ (Vector3, Vector3);
 		friend Vector3 operator- (Vector3, Vector3);
 		friend Vector3 operator* (Vector3, Vector3);
@@ -100,5 +108,16 @@ namespace Xna {
 
 }
 
+namespace std {
+	template <>
+	struct hash<Xna::Vector3> {
+		size_t operator()(Xna::Vector3 const& v) const noexcept {
+			return static_cast<size_t>(Xna::Hash::Combine(
+				Xna::Hash::Combine(Xna::Hash::Mix(Xna::Hash::OfDouble(v.X)), Xna::Hash::OfDouble(v.Y)),
+				Xna::Hash::OfDouble(v.Z)));
+		}
+	};
+}
+
 #endif
 
@@ -296,8 +296,50 @@ namespace Xna {
 			&& W == other.W;
 	}
 
-	Vector4 Vector4::operator- (Vector4 v) {
-		return Vector4::Negate(v);
+	Vector4 Vector4::operator- () const {
+		return Vector4::Negate(*this);
+	}
+
+	Vector4& Vector4::operator+= (Vector4 const& v) {
+		X += v.X;
+		Y += v.Y;
+		Z += v.Z;
+		W += v.W;
+		return *this;
+	}
+
+	Vector4& Vector4::operator-= (Vector4 const& v) {
+		X -= v.X;
+		Y -= v.Y;
+		Z -= v.Z;
+		W -= v.W;
+		return *this;
+	}
+
+	Vector4& Vector4::operator*= (Vector4 const& v) {
+		X *= v.X;
+		Y *= v.Y;
+		Z *= v.Z;
+		W *= v.W;
+		return *this;
+	}
+
+	Vector4& Vector4::operator*= (double d) {
+		X *= d;
+		Y *= d;
+		Z *= d;
+		W *= d;
+		return *this;
+	}
+
+	Vector4& Vector4::operator/= (Vector4 const& v) {
+		*this = Vector4::Divide(*this, v);
+		return *this;
+	}
+
+	Vector4& Vector4::operator/= (double d) {
+		*this = Vector4::Divide(*this, d);
+		return *this;
 	}
 
 	Vector4 operator+ (Vector4 v1, Vector4 v2) {
@@ -29,7 +29,13 @@ namespace Xna {
 		static const Vector4 UnitZ;
 		static const Vector4 UnitW;
 
-		Vector4 operator- (Vector4);
+		Vector4 operator- () const;
+		Vector4& operator+= (Vector4 const&);
+		Vector4& operator-= (Vector4 const&);
+		Vector4& operator*= (Vector4 const&);
+		Vector4& operator*= (double);
+		Vector4& operator/= (Vector4 const&);
+		Vector4& operator/= (double);
 		friend Vector4 operator+ (Vector4, Vector4);
 		friend Vector4 operator- (Vector4, Vector4);
 		friend Vector4 operator* (Vector4, Vector4);
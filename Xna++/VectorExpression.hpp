@@ -0,0 +1,335 @@
+#ifndef _VECTOREXPRESSION_H_
+#define _VECTOREXPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "Parallel.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+
+namespace Xna {
+
+	/*
+	 Expression templates for Vector2, Vector3 and Vector4.
+	 Operators on VectorExpression::Of(...) build a tree instead of a value, and Evaluate runs the whole
+	 tree once per element, component by component, so no intermediate vector is ever created:
+
+		VectorExpression::Evaluate(VectorExpression::Of(positions) + VectorExpression::Of(velocities) * dt, positions);
+
+	 Operands can be arrays (std::vector) or single values, which are repeated for every element.
+	 Division by zero gives 0, as in Vector3::Divide; division by a scalar multiplies by its reciprocal.
+	*/
+	template <typename TVector> struct VectorTraits;
+
+	template <> struct VectorTraits<Vector2> {
+		static constexpr size_t Dimension = 2;
+
+		template <size_t C> static double Get(Vector2 const& v) { return C == 0 ? v.X : v.Y; }
+		template <size_t C> static void Set(Vector2& v, double value) { (C == 0 ? v.X : v.Y) = value; }
+	};
+
+	template <> struct VectorTraits<Vector3> {
+		static constexpr size_t Dimension = 3;
+
+		template <size_t C> static double Get(Vector3 const& v) { return C == 0 ? v.X : C == 1 ? v.Y : v.Z; }
+		template <size_t C> static void Set(Vector3& v, double value) { (C == 0 ? v.X : C == 1 ? v.Y : v.Z) = value; }
+	};
+
+	template <> struct VectorTraits<Vector4> {
+		static constexpr size_t Dimension = 4;
+
+		template <size_t C> static double Get(Vector4 const& v) { return C == 0 ? v.X : C == 1 ? v.Y : C == 2 ? v.Z : v.W; }
+		template <size_t C> static void Set(Vector4& v, double value) { (C == 0 ? v.X : C == 1 ? v.Y : C == 2 ? v.Z : v.W) = value; }
+	};
+
+	namespace Expressions {
+
+		//Size of an expression made only of single values.
+		static constexpr size_t Broadcast = SIZE_MAX;
+
+		struct AddOperation {
+			static double Apply(double a, double b) { return a + b; }
+		};
+
+		struct SubtractOperation {
+			static double Apply(double a, double b) { return a - b; }
+		};
+
+		struct MultiplyOperation {
+			static double Apply(double a, double b) { return a * b; }
+		};
+
+		struct DivideOperation {
+			static double Apply(double a, double b) { return b != 0 ? a / b : 0; }
+		};
+
+		//Every node has: VectorType, template At<C>(i) and MergeSize(size), which fails on mismatched arrays.
+		template <typename TVector>
+		class ArrayNode {
+		public:
+			using VectorType = TVector;
+
+			ArrayNode(TVector const* data, size_t count) : data(data), count(count) {}
+
+			template <size_t C> double At(size_t i) const { return VectorTraits<TVector>::template Get<C>(data[i]); }
+
+			bool MergeSize(size_t& size) const {
+				if (size == Broadcast) {
+					size = count;
+				}
+
+				return size == count;
+			}
+
+		private:
+			TVector const* data;
+			size_t count;
+		};
+
+		template <typename TVector>
+		class ValueNode {
+		public:
+			using VectorType = TVector;
+
+			ValueNode(TVector const& value) : value(value) {}
+
+			template <size_t C> double At(size_t) const { return VectorTraits<TVector>::template Get<C>(value); }
+
+			bool MergeSize(size_t&) const { return true; }
+
+		private:
+			TVector value;
+		};
+
+		template <typename TOperation, typename TLeft, typename TRight>
+		class BinaryNode {
+		public:
+			static_assert(std::is_same<typename TLeft::VectorType, typename TRight::VectorType>::value,
+				"Both operands must be of the same vector type.");
+
+			using VectorType = typename TLeft::VectorType;
+
+			BinaryNode(TLeft const& left, TRight const& right) : left(left), right(right) {}
+
+			template <size_t C> double At(size_t i) const {
+				return TOperation::Apply(left.template At<C>(i), right.template At<C>(i));
+			}
+
+			bool MergeSize(size_t& size) const { return left.MergeSize(size) && right.MergeSize(size); }
+
+		private:
+			TLeft left;
+			TRight right;
+		};
+
+		template <typename TNode>
+		class ScaleNode {
+		public:
+			using VectorType = typename TNode::VectorType;
+
+			ScaleNode(TNode const& node, double scale) : node(node), scale(scale) {}
+
+			template <size_t C> double At(size_t i) const { return node.template At<C>(i) * scale; }
+
+			bool MergeSize(size_t& size) const { return node.MergeSize(size); }
+
+		private:
+			TNode node;
+			double scale;
+		};
+
+		template <typename TNode>
+		class NegateNode {
+		public:
+			using VectorType = typename TNode::VectorType;
+
+			NegateNode(TNode const& node) : node(node) {}
+
+			template <size_t C> double At(size_t i) const { return -node.template At<C>(i); }
+
+			bool MergeSize(size_t& size) const { return node.MergeSize(size); }
+
+		private:
+			TNode node;
+		};
+
+		template <typename T> struct IsNode : std::false_type {};
+		template <typename V> struct IsNode<ArrayNode<V>> : std::true_type {};
+		template <typename V> struct IsNode<ValueNode<V>> : std::true_type {};
+		template <typename O, typename L, typename R> struct IsNode<BinaryNode<O, L, R>> : std::true_type {};
+		template <typename N> struct IsNode<ScaleNode<N>> : std::true_type {};
+		template <typename N> struct IsNode<NegateNode<N>> : std::true_type {};
+
+		template <typename T> struct IsVector : std::false_type {};
+		template <> struct IsVector<Vector2> : std::true_type {};
+		template <> struct IsVector<Vector3> : std::true_type {};
+		template <> struct IsVector<Vector4> : std::true_type {};
+
+		//Wraps plain vectors as ValueNode so they can be mixed with expressions.
+		template <typename T, bool = IsVector<T>::value> struct Operand {
+			using Type = T;
+			static T const& Wrap(T const& node) { return node; }
+		};
+
+		template <typename T> struct Operand<T, true> {
+			using Type = ValueNode<T>;
+			static ValueNode<T> Wrap(T const& value) { return ValueNode<T>(value); }
+		};
+
+		//Enabled when at least one side is an expression and the other an expression or a vector.
+		template <typename TLeft, typename TRight>
+		using EnableBinary = typename std::enable_if<
+			(IsNode<TLeft>::value && (IsNode<TRight>::value || IsVector<TRight>::value))
+			|| (IsVector<TLeft>::value && IsNode<TRight>::value)>::type;
+
+		template <typename TOperation, typename TLeft, typename TRight>
+		using BinaryResult = BinaryNode<TOperation, typename Operand<TLeft>::Type, typename Operand<TRight>::Type>;
+
+		template <typename TOperation, typename TLeft, typename TRight>
+		BinaryResult<TOperation, TLeft, TRight> MakeBinary(TLeft const& left, TRight const& right) {
+			return BinaryResult<TOperation, TLeft, TRight>(Operand<TLeft>::Wrap(left), Operand<TRight>::Wrap(right));
+		}
+
+		template <typename TLeft, typename TRight, typename = EnableBinary<TLeft, TRight>>
+		BinaryResult<AddOperation, TLeft, TRight> operator+ (TLeft const& left, TRight const& right) {
+			return MakeBinary<AddOperation>(left, right);
+		}
+
+		template <typename TLeft, typename TRight, typename = EnableBinary<TLeft, TRight>>
+		BinaryResult<SubtractOperation, TLeft, TRight> operator- (TLeft const& left, TRight const& right) {
+			return MakeBinary<SubtractOperation>(left, right);
+		}
+
+		template <typename TLeft, typename TRight, typename = EnableBinary<TLeft, TRight>>
+		BinaryResult<MultiplyOperation, TLeft, TRight> operator* (TLeft const& left, TRight const& right) {
+			return MakeBinary<MultiplyOperation>(left, right);
+		}
+
+		template <typename TLeft, typename TRight, typename = EnableBinary<TLeft, TRight>>
+		BinaryResult<DivideOperation, TLeft, TRight> operator/ (TLeft const& left, TRight const& right) {
+			return MakeBinary<DivideOperation>(left, right);
+		}
+
+		template <typename TNode, typename = typename std::enable_if<IsNode<TNode>::value>::type>
+		ScaleNode<TNode> operator* (TNode const& node, double scale) {
+			return ScaleNode<TNode>(node, scale);
+		}
+
+		template <typename TNode, typename = typename std::enable_if<IsNode<TNode>::value>::type>
+		ScaleNode<TNode> operator* (double scale, TNode const& node) {
+			return ScaleNode<TNode>(node, scale);
+		}
+
+		template <typename TNode, typename = typename std::enable_if<IsNode<TNode>::value>::type>
+		ScaleNode<TNode> operator/ (TNode const& node, double divider) {
+			return ScaleNode<TNode>(node, divider != 0 ? 1.0 / divider : 0.0);
+		}
+
+		template <typename TNode, typename = typename std::enable_if<IsNode<TNode>::value>::type>
+		NegateNode<TNode> operator- (TNode const& node) {
+			return NegateNode<TNode>(node);
+		}
+
+		template <size_t C, size_t N>
+		struct Components {
+			template <typename TNode, typename TVector>
+			static void Assign(TNode const& node, size_t i, TVector& destination) {
+				VectorTraits<TVector>::template Set<C>(destination, node.template At<C>(i));
+				Components<C + 1, N>::Assign(node, i, destination);
+			}
+		};
+
+		template <size_t N>
+		struct Components<N, N> {
+			template <typename TNode, typename TVector>
+			static void Assign(TNode const&, size_t, TVector&) {}
+		};
+	}
+
+	class VectorExpression {
+	public:
+		//Arrays of at least this many elements are evaluated on several threads.
+		static constexpr size_t ParallelGrain = 16384;
+
+		template <typename TVector>
+		static Expressions::ArrayNode<TVector> Of(std::vector<TVector> const& source) {
+			return Expressions::ArrayNode<TVector>(source.data(), source.size());
+		}
+
+		//The range must lie within 'source'.
+		template <typename TVector>
+		static Expressions::ArrayNode<TVector> Of(std::vector<TVector> const& source, size_t sourceIndex, size_t length) {
+			return Expressions::ArrayNode<TVector>(source.data() + sourceIndex, length);
+		}
+
+		template <typename TVector, typename = typename std::enable_if<Expressions::IsVector<TVector>::value>::type>
+		static Expressions::ValueNode<TVector> Of(TVector const& value) {
+			return Expressions::ValueNode<TVector>(value);
+		}
+
+		/*
+		 Writes every element of 'expression' to 'destination', which is resized to the size of the arrays.
+		 An expression made only of single values fills the current elements of 'destination'.
+		 The destination may be one of the operands. Returns false if the arrays have different sizes.
+		*/
+		template <typename TNode>
+		static bool Evaluate(TNode const& expression, std::vector<typename TNode::VectorType>& destination) {
+			size_t size = Expressions::Broadcast;
+
+			if (!expression.MergeSize(size)) {
+				return false;
+			}
+
+			if (size != Expressions::Broadcast) {
+				destination.resize(size);
+			}
+
+			EvaluateRange(expression, destination.data(), 0, destination.size());
+			return true;
+		}
+
+		//Same as Evaluate, into destination[destIndex, destIndex + size).
+		template <typename TNode>
+		static bool Evaluate(TNode const& expression, std::vector<typename TNode::VectorType>& destination, size_t destIndex) {
+			size_t size = Expressions::Broadcast;
+
+			if (!expression.MergeSize(size) || size == Expressions::Broadcast
+				|| destIndex > destination.size() || destination.size() - destIndex < size) {
+				return false;
+			}
+
+			EvaluateRange(expression, destination.data() + destIndex, 0, size);
+			return true;
+		}
+
+		//Value of an expression made only of single values.
+		template <typename TNode>
+		static typename TNode::VectorType Value(TNode const& expression) {
+			typename TNode::VectorType result;
+			EvaluateAt(expression, 0, result);
+			return result;
+		}
+
+		//Writes element 'index' of 'expression' to 'destination'.
+		template <typename TNode>
+		static void EvaluateAt(TNode const& expression, size_t index, typename TNode::VectorType& destination) {
+			using TVector = typename TNode::VectorType;
+			Expressions::Components<0, VectorTraits<TVector>::Dimension>::Assign(expression, index, destination);
+		}
+
+	private:
+		template <typename TNode>
+		static void EvaluateRange(TNode const& expression, typename TNode::VectorType* destination, size_t begin, size_t end) {
+			Parallel::For(begin, end, ParallelGrain, [&](size_t first, size_t last) {
+				for (size_t i = first; i < last; i++) {
+					EvaluateAt(expression, i, destination[i]);
+				}
+			});
+		}
+	};
+}
+
+#endif